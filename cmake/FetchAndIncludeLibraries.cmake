@@ -2,6 +2,7 @@ find_package(Vulkan REQUIRED)
 if(Vulkan_FOUND)
     MESSAGE("Vulkan Found!")
 endif()
+find_package(Threads REQUIRED)
 
 include(FetchContent)
 
@@ -46,6 +47,7 @@ FetchContent_MakeAvailable(vma GLM stb assimp)
 # Link libraries to the project
 target_link_libraries(${PROJECT_NAME} PUBLIC
     Vulkan::Vulkan
+    Threads::Threads
     glm::glm
     assimp
 )
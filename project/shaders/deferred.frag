@@ -1,15 +1,9 @@
 #version 450
 #extension GL_EXT_nonuniform_qualifier : require
 
-// -- Texture Array Index --
+// -- Texture Array Size --
 layout(push_constant) uniform constants
 {
-	layout(offset = 64) 
-	uint diffuseIdx;
-	uint opacityIdx;
-	uint normalIdx;
-	uint roughnessIdx;
-	uint metallicIdx;
 	uint textureCount;
 } pushConstants;
 
@@ -23,6 +17,11 @@ layout(location = 2) in vec3 fragTangent;
 layout(location = 3) in vec3 fragBitangent;
 layout(location = 4) in vec2 fragTexCoord;
 layout(location = 5) in vec3 fragWorldPos;
+layout(location = 6) flat in uint fragAlbedoIdx;
+layout(location = 7) flat in uint fragOpacityIdx;
+layout(location = 8) flat in uint fragNormalIdx;
+layout(location = 9) flat in uint fragRoughnessIdx;
+layout(location = 10) flat in uint fragMetallicIdx;
 layout(early_fragment_tests) in;
 
 // -- Output --
@@ -38,13 +37,13 @@ void main()
 	outAlbedo_Opacity = vec4(1.0, 0.0, 1.0, 1.0);
 	
 	// -- Diffuse --
-	if(pushConstants.diffuseIdx < pushConstants.textureCount)
-		outAlbedo_Opacity = vec4(fragColor, 1.0) * texture(textures[nonuniformEXT(pushConstants.diffuseIdx)], fragTexCoord);
+	if(fragAlbedoIdx < pushConstants.textureCount)
+		outAlbedo_Opacity = vec4(fragColor, 1.0) * texture(textures[nonuniformEXT(fragAlbedoIdx)], fragTexCoord);
 	else
 		outAlbedo_Opacity = vec4(fragColor, 1.0);
 	// -- Opacity --
-	if(pushConstants.opacityIdx < pushConstants.textureCount)
-		outAlbedo_Opacity.a = texture(textures[nonuniformEXT(pushConstants.opacityIdx)], fragTexCoord).r;
+	if(fragOpacityIdx < pushConstants.textureCount)
+		outAlbedo_Opacity.a = texture(textures[nonuniformEXT(fragOpacityIdx)], fragTexCoord).r;
 	// -- Alpha Cutout --
 	if(outAlbedo_Opacity.a < 0.95)
 		discard;
@@ -53,10 +52,12 @@ void main()
 	vec3 normal = normalize(fragNormal);
 	vec3 tangent = normalize(fragTangent);
 	vec3 bitangent = normalize(fragBitangent);
-	if(pushConstants.normalIdx < pushConstants.textureCount)
+	if(fragNormalIdx < pushConstants.textureCount)
 	{
 		mat3x3 tbn = mat3x3(tangent, bitangent, normal);
-		vec3 sampledNormal = texture(textures[nonuniformEXT(pushConstants.normalIdx)], fragTexCoord).rgb * 2.0 - 1.0;
+		// Rebuild z from xy, BC5 normal maps only store two channels
+		vec2 sampledXY = texture(textures[nonuniformEXT(fragNormalIdx)], fragTexCoord).rg * 2.0 - 1.0;
+		vec3 sampledNormal = vec3(sampledXY, sqrt(max(0.0, 1.0 - dot(sampledXY, sampledXY))));
 		normal = normalize(tbn * sampledNormal);
 	}
 	outNormal = vec4(normal * 0.5 + 0.5, 1.0);
@@ -64,10 +65,10 @@ void main()
 	// -- Specular --
 	outRoughness_Metallic.r = 0.0;
 	outRoughness_Metallic.g = 0.0;
-	if(pushConstants.roughnessIdx < pushConstants.textureCount)
-		outRoughness_Metallic.r = texture(textures[nonuniformEXT(pushConstants.roughnessIdx)], fragTexCoord).g;
-	if(pushConstants.metallicIdx < pushConstants.textureCount)
-		outRoughness_Metallic.g = texture(textures[nonuniformEXT(pushConstants.metallicIdx)], fragTexCoord).b;
+	if(fragRoughnessIdx < pushConstants.textureCount)
+		outRoughness_Metallic.r = texture(textures[nonuniformEXT(fragRoughnessIdx)], fragTexCoord).g;
+	if(fragMetallicIdx < pushConstants.textureCount)
+		outRoughness_Metallic.g = texture(textures[nonuniformEXT(fragMetallicIdx)], fragTexCoord).b;
 	
 	// -- World Pos --
 	outWorldPos = vec4(fragWorldPos, 1.0);
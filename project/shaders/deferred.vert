@@ -1,4 +1,9 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "helpers_general.glsl"
+#include "helpers_instance.glsl"
+#include "helpers_vertex.glsl"
 
 // -- Matrices --
 layout(set = 0, binding = 0) uniform MatrixUBO
@@ -8,18 +13,14 @@ layout(set = 0, binding = 0) uniform MatrixUBO
 } ubo;
 
 // -- Model Data --
-layout(push_constant) uniform constants
-{
-	mat4 model;
-} modelData;
+// gl_InstanceIndex walks the run of visible instances the cull pass wrote for each instanced draw
+layout(set = 2, binding = 0, std430) readonly buffer Instances { InstanceData instances[]; };
+layout(set = 2, binding = 2, std430) readonly buffer SubMeshes { SubMeshData subMeshes[]; };
+layout(set = 2, binding = 3, std430) readonly buffer VisibleInstances { uint visibleInstances[]; };
 
 // -- Input --
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
-layout(location = 3) in vec3 inBitangent;
-layout(location = 4) in vec3 inColor;
-layout(location = 5) in vec2 inTexCoord;
+// Pulled from the Geometry Arena, gl_VertexIndex already includes the Sub Mesh base vertex
+layout(set = 2, binding = 1, std430) readonly buffer Vertices { PackedVertex vertices[]; };
 
 // -- Output --
 layout(location = 0) out vec3 fragColor;
@@ -28,15 +29,37 @@ layout(location = 2) out vec3 fragTangent;
 layout(location = 3) out vec3 fragBitangent;
 layout(location = 4) out vec2 fragTexCoord;
 layout(location = 5) out vec3 fragWorldPos;
+layout(location = 6) flat out uint fragAlbedoIdx;
+layout(location = 7) flat out uint fragOpacityIdx;
+layout(location = 8) flat out uint fragNormalIdx;
+layout(location = 9) flat out uint fragRoughnessIdx;
+layout(location = 10) flat out uint fragMetallicIdx;
 
 // -- Shader --
 void main()
 {
-    gl_Position			= ubo.proj * ubo.view * modelData.model * vec4(inPosition, 1.0);
-	fragColor			= inColor;
-	fragNormal			= normalize(mat3(modelData.model) * inNormal);
-	fragTangent			= normalize(mat3(modelData.model) * inTangent);
-	fragBitangent		= normalize(mat3(modelData.model) * inBitangent);
-	fragTexCoord		= inTexCoord;
-	fragWorldPos		= (modelData.model * vec4(inPosition, 1.0)).rgb;
+	// -- Decode --
+	InstanceData instance = instances[visibleInstances[gl_InstanceIndex]];
+	SubMeshData subMesh	= subMeshes[instance.subMeshIdx];
+	Vertex vertex		= UnpackVertex(vertices[gl_VertexIndex]);
+	mat4 model			= instance.model;
+	vec3 position		= DequantizePosition(subMesh, vertex.position.xyz);
+	vec3 normal			= OctahedralDecode(vertex.normal);
+	vec3 tangent		= OctahedralDecode(vertex.tangent);
+	vec3 bitangent		= cross(normal, tangent) * (vertex.position.w < 0.0 ? -1.0 : 1.0);
+
+    gl_Position			= ubo.proj * ubo.view * model * vec4(position, 1.0);
+	fragColor			= vertex.color.rgb;
+	fragNormal			= normalize(mat3(model) * normal);
+	fragTangent			= normalize(mat3(model) * tangent);
+	fragBitangent		= normalize(mat3(model) * bitangent);
+	fragTexCoord		= vertex.texCoord;
+	fragWorldPos		= (model * vec4(position, 1.0)).rgb;
+
+	// -- Material --
+	fragAlbedoIdx		= subMesh.albedoIdx;
+	fragOpacityIdx		= subMesh.opacityIdx;
+	fragNormalIdx		= subMesh.normalIdx;
+	fragRoughnessIdx	= subMesh.roughnessIdx;
+	fragMetallicIdx		= subMesh.metallicIdx;
 }
\ No newline at end of file
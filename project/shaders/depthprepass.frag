@@ -1,12 +1,9 @@
 #version 450
 #extension GL_EXT_nonuniform_qualifier : require
 
-// -- Texture Array Index --
+// -- Texture Array Size --
 layout(push_constant) uniform constants
 {
-	layout(offset = 64) 
-	uint diffuseIdx;
-	uint opacityIdx;
 	uint textureCount;
 } pushConstants;
 
@@ -15,6 +12,8 @@ layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 // -- Input --
 layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragAlbedoIdx;
+layout(location = 2) flat in uint fragOpacityIdx;
 
 // -- Shader --
 void main()
@@ -22,11 +21,11 @@ void main()
 	float alpha = 1.0;
 
 	// -- Diffuse --
-	if(pushConstants.diffuseIdx < pushConstants.textureCount)
-		alpha = texture(textures[nonuniformEXT(pushConstants.diffuseIdx)], fragTexCoord).a;
+	if(fragAlbedoIdx < pushConstants.textureCount)
+		alpha = texture(textures[nonuniformEXT(fragAlbedoIdx)], fragTexCoord).a;
 	// -- Opacity --
-	if(pushConstants.opacityIdx < pushConstants.textureCount)
-		alpha = texture(textures[nonuniformEXT(pushConstants.opacityIdx)], fragTexCoord).r;
+	if(fragOpacityIdx < pushConstants.textureCount)
+		alpha = texture(textures[nonuniformEXT(fragOpacityIdx)], fragTexCoord).r;
 	// -- Alpha Cutout --
 	if(alpha < 0.95)
 		discard;
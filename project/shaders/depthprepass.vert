@@ -1,4 +1,8 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "helpers_instance.glsl"
+#include "helpers_vertex.glsl"
 
 // -- Matrices --
 layout(set = 0, binding = 0) uniform MatrixUBO
@@ -8,26 +12,30 @@ layout(set = 0, binding = 0) uniform MatrixUBO
 } ubo;
 
 // -- Model Data --
-layout(push_constant) uniform constants
-{
-	mat4 model;
-} modelData;
-
+// gl_InstanceIndex walks the run of visible instances the cull pass wrote for each instanced draw
+layout(set = 2, binding = 0, std430) readonly buffer Instances { InstanceData instances[]; };
+layout(set = 2, binding = 2, std430) readonly buffer SubMeshes { SubMeshData subMeshes[]; };
+layout(set = 2, binding = 3, std430) readonly buffer VisibleInstances { uint visibleInstances[]; };
 
 // -- Input --
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
-layout(location = 3) in vec3 inBitangent;
-layout(location = 4) in vec3 inColor;
-layout(location = 5) in vec2 inTexCoord;
+// Pulled from the Geometry Arena, gl_VertexIndex already includes the Sub Mesh base vertex
+layout(set = 2, binding = 1, std430) readonly buffer Vertices { PackedVertex vertices[]; };
 
 // -- Output --
 layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragAlbedoIdx;
+layout(location = 2) flat out uint fragOpacityIdx;
 
 // -- Shader --
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * modelData.model * vec4(inPosition, 1.0);
-	fragTexCoord = inTexCoord;
+	// Must match deferred.vert exactly so the geometry pass depth test stays invariant
+	InstanceData instance = instances[visibleInstances[gl_InstanceIndex]];
+	SubMeshData subMesh = subMeshes[instance.subMeshIdx];
+	Vertex vertex = UnpackVertex(vertices[gl_VertexIndex]);
+	vec3 position = DequantizePosition(subMesh, vertex.position.xyz);
+    gl_Position = ubo.proj * ubo.view * instance.model * vec4(position, 1.0);
+	fragTexCoord = vertex.texCoord;
+	fragAlbedoIdx = subMesh.albedoIdx;
+	fragOpacityIdx = subMesh.opacityIdx;
 }
\ No newline at end of file
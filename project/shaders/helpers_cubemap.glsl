@@ -0,0 +1,43 @@
+#ifndef HELPER_CUBEMAP
+#define HELPER_CUBEMAP
+
+// -- Cube Map Compute Output --
+// One invocation per texel, z is the face, faces follow the sampler's layer order
+struct CubePushConstants
+{
+	uint mip;
+	uint faceSize;
+	float roughness;
+};
+
+// Direction through texel id of a face in the sampler's own convention, unnormalized
+vec3 GetCubeDirection(in uvec3 id, in uint faceSize)
+{
+	vec2 uv = (vec2(id.xy) + 0.5) / float(faceSize) * 2.0 - 1.0;
+	switch(id.z)
+	{
+	case 0:  return vec3( 1.0, -uv.y, -uv.x); // +X
+	case 1:  return vec3(-1.0, -uv.y,  uv.x); // -X
+	case 2:  return vec3( uv.x,  1.0,  uv.y); // +Y
+	case 3:  return vec3( uv.x, -1.0, -uv.y); // -Y
+	case 4:  return vec3( uv.x, -uv.y,  1.0); // +Z
+	default: return vec3(-uv.x, -uv.y, -1.0); // -Z
+	}
+}
+
+// Position on the unit cube that texel id of a face covers, y is mirrored to match the maps the raster path used to make
+vec3 GetCubeLocalPos(in uvec3 id, in uint faceSize)
+{
+	vec3 dir = GetCubeDirection(id, faceSize);
+	return vec3(dir.x, -dir.y, dir.z);
+}
+
+// Solid angle covered by texel id of a face
+float GetCubeTexelSolidAngle(in uvec3 id, in uint faceSize)
+{
+	vec2 uv = (vec2(id.xy) + 0.5) / float(faceSize) * 2.0 - 1.0;
+	float texelArea = 4.0 / float(faceSize * faceSize);
+	return texelArea / pow(1.0 + dot(uv, uv), 1.5);
+}
+
+#endif // HELPER_CUBEMAP
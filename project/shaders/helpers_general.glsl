@@ -28,4 +28,14 @@ void CalculateTangents(in vec3 N, out vec3 T, out vec3 B)
 	B = normalize(cross(T, normal));
 }
 
+// -- Octahedral Normals --
+vec3 OctahedralDecode(in vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
 #endif //HELPER_GENERAL
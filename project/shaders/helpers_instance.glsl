@@ -0,0 +1,78 @@
+#ifndef HELPER_INSTANCE
+#define HELPER_INSTANCE
+
+// -- Instance --
+// Mirrors GPUCuller::InstanceData, one per Sub Mesh of a Render Item
+struct InstanceData
+{
+	mat4 model;						// render item transform times the sub mesh matrix
+	uint subMeshIdx;
+	uint _pad0;
+	uint _pad1;
+	uint _pad2;
+};
+
+// -- Sub Mesh --
+// Mirrors GPUCuller::SubMeshData, shared by every instance of the same Sub Mesh
+#define MAX_INSTANCE_LODS 4
+struct SubMeshData
+{
+	vec4 aabbMin;					// w is the local radius of the AABB
+	vec4 aabbMax;
+	vec4 positionOffset;			// dequantization of the packed positions
+	vec4 positionScale;
+	vec4 lodError;
+
+	int vertexOffset;
+	uint lodCount;
+	uint meshletCount;				// 0 draws the full detail as a single slot without cluster culling
+	uint firstDrawSlot;				// full detail first, one slot per meshlet, then one per LOD
+
+	// -- Instances are sorted by Sub Mesh, these are a contiguous run --
+	uint firstInstance;
+	uint instanceCount;
+	uint batchIdx;
+	uint batchFirstDraw;
+
+	// -- Texture registry slots --
+	uint albedoIdx;
+	uint opacityIdx;
+	uint normalIdx;
+	uint roughnessIdx;
+	uint metallicIdx;
+	uint _pad0;
+	uint _pad1;
+	uint _pad2;
+};
+
+// -- Draw Slot --
+// Mirrors GPUCuller::DrawSlotData, a meshlet of a Sub Mesh's full detail or one of its LODs
+struct DrawSlotData
+{
+	vec4 sphere;					// center and radius in Sub Mesh space
+	vec4 cone;						// axis, w is the sine of the cone angle and 1 when it can't be back face culled
+	uint subMeshIdx;
+	uint firstIndex;
+	uint indexCount;
+	uint firstVisible;				// start of the slot's run inside every view's visible instances
+};
+
+// -- View --
+// Mirrors GPUCuller::CullView, one per camera or light face the instances are culled against
+struct CullView
+{
+	vec4 planes[6];					// inward facing, xyz is the normal and w the distance
+	vec4 viewPosition;				// w is the pixel scale of the LOD selector
+	float pixelError;
+	uint orthographic;
+	uint coneCulling;				// off for passes that don't cull back faces
+	uint _pad0;
+};
+
+// Unpacks a position stored inside the sub mesh AABB
+vec3 DequantizePosition(SubMeshData subMesh, vec3 position)
+{
+	return subMesh.positionOffset.xyz + subMesh.positionScale.xyz * position;
+}
+
+#endif // HELPER_INSTANCE
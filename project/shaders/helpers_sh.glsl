@@ -0,0 +1,34 @@
+#ifndef HELPER_SH
+#define HELPER_SH
+
+// -- L2 Spherical Harmonics --
+// 9 coefficients, band 0 first, then band 1 (y, z, x), then band 2
+#define SH_COEFFICIENT_COUNT 9
+
+// Real SH basis evaluated for a normalized direction
+void EvaluateSHBasis(in vec3 dir, out float basis[SH_COEFFICIENT_COUNT])
+{
+	basis[0] = 0.282095;
+	basis[1] = 0.488603 * dir.y;
+	basis[2] = 0.488603 * dir.z;
+	basis[3] = 0.488603 * dir.x;
+	basis[4] = 1.092548 * dir.x * dir.y;
+	basis[5] = 1.092548 * dir.y * dir.z;
+	basis[6] = 0.315392 * (3.0 * dir.z * dir.z - 1.0);
+	basis[7] = 1.092548 * dir.x * dir.z;
+	basis[8] = 0.546274 * (dir.x * dir.x - dir.y * dir.y);
+}
+
+// Irradiance divided by PI around n, the coefficients are expected to already be convolved with the cosine lobe
+vec3 EvaluateIrradianceSH(in vec4 coefficients[SH_COEFFICIENT_COUNT], in vec3 n)
+{
+	float basis[SH_COEFFICIENT_COUNT];
+	EvaluateSHBasis(n, basis);
+
+	vec3 irradiance = vec3(0.0);
+	for(int idx = 0; idx < SH_COEFFICIENT_COUNT; ++idx)
+		irradiance += coefficients[idx].rgb * basis[idx];
+	return max(irradiance, vec3(0.0));
+}
+
+#endif // HELPER_SH
@@ -0,0 +1,37 @@
+#ifndef HELPER_VERTEX
+#define HELPER_VERTEX
+
+// -- Packed Vertex --
+// Mirrors pompeii::PackedVertex, pulled from the Geometry Arena with gl_VertexIndex
+struct PackedVertex
+{
+	uvec2 position;					// snorm16 xyz inside the sub mesh AABB, w holds the bitangent sign
+	uint normal;					// snorm16 octahedral
+	uint tangent;					// snorm16 octahedral
+	uint texCoord;					// half float
+	uint color;						// unorm8
+};
+
+// -- Vertex --
+struct Vertex
+{
+	vec4 position;					// xyz inside the sub mesh AABB, w is the bitangent sign
+	vec2 normal;					// octahedral
+	vec2 tangent;					// octahedral
+	vec2 texCoord;
+	vec4 color;
+};
+
+// Same results as the fixed function fetch of the old vertex attribute formats
+Vertex UnpackVertex(PackedVertex packed)
+{
+	Vertex vertex;
+	vertex.position = vec4(unpackSnorm2x16(packed.position.x), unpackSnorm2x16(packed.position.y));
+	vertex.normal	= unpackSnorm2x16(packed.normal);
+	vertex.tangent	= unpackSnorm2x16(packed.tangent);
+	vertex.texCoord = unpackHalf2x16(packed.texCoord);
+	vertex.color	= unpackUnorm4x8(packed.color);
+	return vertex;
+}
+
+#endif // HELPER_VERTEX
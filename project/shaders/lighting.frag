@@ -5,6 +5,11 @@
 // -- Includes --
 #include "helpers_lighting.glsl"
 #include "helpers_general.glsl"
+#include "helpers_sh.glsl"
+
+// -- Specialization --
+// Diffuse ambient from the spherical harmonics, or from the convolved cube map when false
+layout(constant_id = 0) const bool USE_SH_IRRADIANCE = true;
 
 // -- Camera --
 layout(set = 0, binding = 0) uniform CameraUbo
@@ -42,6 +47,7 @@ layout(set = 4, binding = 5) uniform samplerCube EnvironmentMap;
 layout(set = 4, binding = 6) uniform samplerCube DiffuseIrradiance;
 layout(set = 4, binding = 7) uniform samplerCube SpecularIrradiance;
 layout(set = 4, binding = 8) uniform sampler2D BrdfLut;
+layout(set = 4, binding = 9) uniform DiffuseSH { vec4 coefficients[SH_COEFFICIENT_COUNT]; } diffuseSH;
 
 // -- Input --
 layout(location = 0) in vec2 fragTexCoord;
@@ -139,7 +145,11 @@ void main()
 
 	vec3 F = FresnelSchlickRoughness(n, v, F0, roughness);
 	vec3 kd = (1.0 - F) * (1.0 - metalFactor);
-	vec3 diffuseIrradiance = texture(DiffuseIrradiance, vec3(n.x, -n.y, n.z)).rgb;
+	vec3 diffuseIrradiance;
+	if(USE_SH_IRRADIANCE)
+		diffuseIrradiance = EvaluateIrradianceSH(diffuseSH.coefficients, n);
+	else
+		diffuseIrradiance = texture(DiffuseIrradiance, vec3(n.x, -n.y, n.z)).rgb;
 	vec3 diffuse = kd * diffuseIrradiance * albedo;
 
 	const float maxLod = 4.0;
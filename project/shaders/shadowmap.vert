@@ -1,23 +1,32 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-// -- Model Data --
+#include "helpers_instance.glsl"
+#include "helpers_vertex.glsl"
+
+// -- Light Face --
 layout(push_constant) uniform PushConstants
 {
 	mat4 projView;
-	mat4 model;
 } pc;
 
+// -- Model Data --
+// gl_InstanceIndex walks the run of visible instances the cull pass wrote for each instanced draw
+layout(set = 0, binding = 0, std430) readonly buffer Instances { InstanceData instances[]; };
+layout(set = 0, binding = 2, std430) readonly buffer SubMeshes { SubMeshData subMeshes[]; };
+layout(set = 0, binding = 3, std430) readonly buffer VisibleInstances { uint visibleInstances[]; };
+
 
 // -- Input --
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
-layout(location = 3) in vec3 inBitangent;
-layout(location = 4) in vec3 inColor;
-layout(location = 5) in vec2 inTexCoord;
+// Pulled from the Geometry Arena, gl_VertexIndex already includes the Sub Mesh base vertex
+layout(set = 0, binding = 1, std430) readonly buffer Vertices { PackedVertex vertices[]; };
 
 // -- Shader --
 void main()
 {
-    gl_Position = pc.projView * pc.model * vec4(inPosition, 1.0);
+	InstanceData instance = instances[visibleInstances[gl_InstanceIndex]];
+	// Only the position is fetched, the other attributes are never read
+	uvec2 packedPosition = vertices[gl_VertexIndex].position;
+	vec3 position = vec3(unpackSnorm2x16(packedPosition.x), unpackSnorm2x16(packedPosition.y).x);
+    gl_Position = pc.projView * instance.model * vec4(DequantizePosition(subMeshes[instance.subMeshIdx], position), 1.0);
 }
\ No newline at end of file
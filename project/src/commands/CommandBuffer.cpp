@@ -45,11 +45,12 @@ const VkCommandBuffer& pompeii::CommandBuffer::GetHandle() const { return m_CmdB
 //--------------------------------------------------
 //    Commands
 //--------------------------------------------------
-void pompeii::CommandBuffer::Begin(VkCommandBufferUsageFlags usage) const
+void pompeii::CommandBuffer::Begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo* pInheritance) const
 {
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	beginInfo.flags = usage;
+	beginInfo.pInheritanceInfo = pInheritance;
 
 	if (vkBeginCommandBuffer(m_CmdBuffer, &beginInfo) != VK_SUCCESS)
 		throw std::runtime_error("Failed to begin recording Command Buffer!");
@@ -78,7 +79,7 @@ void pompeii::CommandBuffer::Submit(VkQueue queue, bool waitIdle, const Semaphor
 
 	// -- Wait Semaphores --
 	std::vector<VkSemaphoreSubmitInfo> vWaitSemaphoreSubmitInfos;
-	vWaitSemaphoreSubmitInfos.reserve(semaphoreInfo.vSignalSemaphores.size());
+	vWaitSemaphoreSubmitInfos.reserve(semaphoreInfo.vWaitSemaphores.size());
 	if (!semaphoreInfo.vWaitSemaphores.empty())
 	{
 		uint32_t index = 0;
@@ -87,7 +88,7 @@ void pompeii::CommandBuffer::Submit(VkQueue queue, bool waitIdle, const Semaphor
 			VkSemaphoreSubmitInfo semaphoreSubmitInfo{};
 			semaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
 			semaphoreSubmitInfo.pNext = nullptr;
-			semaphoreSubmitInfo.value = 0;
+			semaphoreSubmitInfo.value = index < semaphoreInfo.vWaitValues.size() ? semaphoreInfo.vWaitValues[index] : 0;
 			semaphoreSubmitInfo.semaphore = semaphore;
 			semaphoreSubmitInfo.stageMask = semaphoreInfo.vWaitStages[index];
 
@@ -103,15 +104,17 @@ void pompeii::CommandBuffer::Submit(VkQueue queue, bool waitIdle, const Semaphor
 	vSignalSemaphoreSubmitInfos.reserve(semaphoreInfo.vSignalSemaphores.size());
 	if (!semaphoreInfo.vSignalSemaphores.empty())
 	{
+		uint32_t index = 0;
 		for (const VkSemaphore& semaphore : semaphoreInfo.vSignalSemaphores)
 		{
 			VkSemaphoreSubmitInfo semaphoreSubmitInfo{};
 			semaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
 			semaphoreSubmitInfo.pNext = nullptr;
-			semaphoreSubmitInfo.value = 0;
+			semaphoreSubmitInfo.value = index < semaphoreInfo.vSignalValues.size() ? semaphoreInfo.vSignalValues[index] : 0;
 			semaphoreSubmitInfo.semaphore = semaphore;
 
 			vSignalSemaphoreSubmitInfos.emplace_back(semaphoreSubmitInfo);
+			++index;
 		}
 		submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(vSignalSemaphoreSubmitInfos.size());
 		submitInfo.pSignalSemaphoreInfos = vSignalSemaphoreSubmitInfos.data();
@@ -41,7 +41,8 @@ namespace pompeii
 		//--------------------------------------------------
 		//    Commands
 		//--------------------------------------------------
-		void Begin(VkCommandBufferUsageFlags usage = 0) const;
+		// Secondary buffers hand what they inherit from the primary through pInheritance
+		void Begin(VkCommandBufferUsageFlags usage = 0, const VkCommandBufferInheritanceInfo* pInheritance = nullptr) const;
 		void End() const;
 		void Submit(VkQueue queue, bool waitIdle, const SemaphoreInfo& semaphoreInfo = {}, VkFence fence = VK_NULL_HANDLE) const;
 		void Reset() const;
@@ -13,14 +13,14 @@
 //--------------------------------------------------
 //    Constructor & Destructor
 //--------------------------------------------------
-pompeii::CommandPool& pompeii::CommandPool::Create(Context& context)
+pompeii::CommandPool& pompeii::CommandPool::Create(Context& context, std::optional<uint32_t> queueFamily)
 {
 	const QueueFamilyIndices queueFamilyIndices = context.physicalDevice.GetQueueFamilies();
 
 	VkCommandPoolCreateInfo poolInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+	poolInfo.queueFamilyIndex = queueFamily.value_or(queueFamilyIndices.graphicsFamily.value());
 
 	if (vkCreateCommandPool(context.device.GetHandle(), &poolInfo, nullptr, &m_CommandPool) != VK_SUCCESS)
 		throw std::runtime_error("Failed to create Command Pool!");
@@ -32,6 +32,10 @@ void pompeii::CommandPool::Destroy() const
 {
 	vkDestroyCommandPool(m_Context->device.GetHandle(), m_CommandPool, nullptr);
 }
+void pompeii::CommandPool::Reset() const
+{
+	vkResetCommandPool(m_Context->device.GetHandle(), m_CommandPool, 0);
+}
 
 
 //--------------------------------------------------
@@ -44,6 +48,7 @@ pompeii::CommandBuffer& pompeii::CommandPool::GetBuffer(uint32_t bufferIdx)
 		throw std::out_of_range("Buffer index out of range!");
 	return m_vCommandBuffers[bufferIdx];
 }
+uint32_t pompeii::CommandPool::GetBufferCount() const { return static_cast<uint32_t>(m_vCommandBuffers.size()); }
 pompeii::CommandBuffer& pompeii::CommandPool::AllocateCmdBuffers(uint32_t count, VkCommandBufferLevel level)
 {
 	std::erase_if(m_vCommandBuffers, [](const CommandBuffer& b)
@@ -5,6 +5,7 @@
 #include "vulkan/vulkan.h"
 
 // -- Standard Library --
+#include <optional>
 #include <vector>
 
 // -- Pompeii Includes --
@@ -37,14 +38,18 @@ namespace pompeii
 		CommandPool& operator=(const CommandPool& other) = delete;
 		CommandPool& operator=(CommandPool&& other) noexcept = delete;
 
-		CommandPool& Create(Context& context);
+		// -- Pools record for the graphics family unless another one is given --
+		CommandPool& Create(Context& context, std::optional<uint32_t> queueFamily = {});
 		void Destroy() const;
+		// Resets every buffer of the pool at once, none may still be pending on the GPU
+		void Reset() const;
 
 		//--------------------------------------------------
 		//    Accessors & Mutators
 		//--------------------------------------------------
 		VkCommandPool& GetHandle();
 		CommandBuffer& GetBuffer(uint32_t bufferIdx);
+		uint32_t GetBufferCount() const;
 		CommandBuffer& AllocateCmdBuffers(uint32_t count, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
 	private:
@@ -0,0 +1,208 @@
+// -- Standard Library --
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "SecondaryRecorder.h"
+#include "Context.h"
+#include "ThreadPool.h"
+#include "Instrumentation.h"
+#include "CPUProfiler.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  SecondaryRecorder
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::SecondaryRecorder::Initialize(Context& context, ThreadPool& threadPool)
+{
+	m_pThreadPool = &threadPool;
+	m_PoolsPerFrame = threadPool.GetThreadCount() + 1;
+	m_vCaches.resize(context.maxFramesInFlight);
+
+	for (std::vector<std::unique_ptr<WorkerPool>>* pPools : { &m_vPools, &m_vCachePools })
+	{
+		pPools->reserve(static_cast<size_t>(m_PoolsPerFrame) * context.maxFramesInFlight);
+		for (uint32_t poolIdx{}; poolIdx < m_PoolsPerFrame * context.maxFramesInFlight; ++poolIdx)
+		{
+			std::unique_ptr<WorkerPool>& workerPool = pPools->emplace_back(std::make_unique<WorkerPool>());
+			workerPool->pool.Create(context);
+		}
+	}
+}
+void pompeii::SecondaryRecorder::Destroy()
+{
+	for (std::vector<std::unique_ptr<WorkerPool>>* pPools : { &m_vPools, &m_vCachePools })
+	{
+		for (const std::unique_ptr<WorkerPool>& workerPool : *pPools)
+			workerPool->pool.Destroy();
+		pPools->clear();
+	}
+	m_vCaches.clear();
+	m_vJobs.clear();
+}
+
+
+//--------------------------------------------------
+//    Recording
+//--------------------------------------------------
+void pompeii::SecondaryRecorder::BeginFrame(uint32_t frameIndex)
+{
+	m_FrameIndex = frameIndex;
+	m_vJobs.clear();
+
+	// -- Buffers stay allocated, a reset pool hands them out again --
+	for (uint32_t workerIdx{}; workerIdx < m_PoolsPerFrame; ++workerIdx)
+	{
+		WorkerPool& workerPool = *m_vPools[m_FrameIndex * m_PoolsPerFrame + workerIdx];
+		if (workerPool.usedCount == 0)
+			continue;
+		workerPool.pool.Reset();
+		workerPool.usedCount = 0;
+	}
+
+	// -- Secondaries nobody asked for last time this frame came around are dropped, their buffers kept for new ones --
+	std::erase_if(m_vCaches[m_FrameIndex], [this](auto& keyEntry)
+		{
+			CacheEntry& entry = keyEntry.second;
+			if (entry.used)
+			{
+				entry.used = false;
+				return false;
+			}
+			if (entry.buffer != VK_NULL_HANDLE)
+				m_vCachePools[entry.poolIdx]->vSpareBuffers.push_back(entry.buffer);
+			return true;
+		});
+}
+uint32_t pompeii::SecondaryRecorder::Add(const RenderingFormats& formats, RecordFunc record)
+{
+	m_vJobs.push_back({ &formats, std::move(record), VK_NULL_HANDLE, nullptr });
+	return static_cast<uint32_t>(m_vJobs.size() - 1);
+}
+uint32_t pompeii::SecondaryRecorder::AddCached(const RenderingFormats& formats, const void* pOwner, uint32_t slot, uint64_t stateHash, RecordFunc record)
+{
+	if (!m_CachingEnabled)
+		return Add(formats, std::move(record));
+
+	// -- Map nodes never move, the job can point at its entry while workers record --
+	CacheEntry& entry = m_vCaches[m_FrameIndex][CacheKey{ pOwner, slot }];
+	entry.used = true;
+	if (entry.buffer != VK_NULL_HANDLE && entry.stateHash == stateHash)
+	{
+		m_vJobs.push_back({ &formats, {}, entry.buffer, &entry });
+		return static_cast<uint32_t>(m_vJobs.size() - 1);
+	}
+
+	entry.stateHash = stateHash;
+	m_vJobs.push_back({ &formats, std::move(record), VK_NULL_HANDLE, &entry });
+	return static_cast<uint32_t>(m_vJobs.size() - 1);
+}
+void pompeii::SecondaryRecorder::RecordAll()
+{
+	POMPEII_CPU_SCOPE("Record Secondaries");
+
+	// -- Cached secondaries that are still valid already have their buffer --
+	m_vPendingJobs.clear();
+	for (uint32_t jobIdx{}; jobIdx < m_vJobs.size(); ++jobIdx)
+	{
+		if (m_vJobs[jobIdx].buffer == VK_NULL_HANDLE)
+			m_vPendingJobs.push_back(jobIdx);
+	}
+	POMPEII_COUNT(Counter::SecondariesRecorded, m_vPendingJobs.size());
+	POMPEII_COUNT(Counter::SecondariesReused, m_vJobs.size() - m_vPendingJobs.size());
+
+	// -- A single job is not worth waking a worker for --
+	if (m_vPendingJobs.size() == 1)
+		RecordJob(m_vJobs[m_vPendingJobs.front()]);
+	else if (!m_vPendingJobs.empty())
+		m_pThreadPool->ParallelFor(static_cast<uint32_t>(m_vPendingJobs.size()), [this](uint32_t pendingIdx) { RecordJob(m_vJobs[m_vPendingJobs[pendingIdx]]); });
+}
+void pompeii::SecondaryRecorder::Execute(const CommandBuffer& primary, uint32_t jobIdx) const
+{
+	const Job& job = m_vJobs.at(jobIdx);
+	if (job.buffer == VK_NULL_HANDLE)
+		throw std::runtime_error("Secondary Command Buffer executed before it was recorded!");
+	vkCmdExecuteCommands(primary.GetHandle(), 1, &job.buffer);
+}
+
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+void pompeii::SecondaryRecorder::SetCachingEnabled(bool enabled)	{ m_CachingEnabled = enabled; }
+bool pompeii::SecondaryRecorder::IsCachingEnabled() const			{ return m_CachingEnabled; }
+uint32_t pompeii::SecondaryRecorder::GetRecordedCount() const		{ return static_cast<uint32_t>(m_vPendingJobs.size()); }
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::SecondaryRecorder::RecordJob(Job& job)
+{
+	POMPEII_CPU_SCOPE("Record Secondary");
+	if (job.pCache)
+	{
+		RecordCachedJob(job);
+		return;
+	}
+
+	// -- Only this thread touches its own pool --
+	WorkerPool& workerPool = *m_vPools[m_FrameIndex * m_PoolsPerFrame + m_pThreadPool->GetWorkerIndex()];
+	CommandBuffer& commandBuffer = workerPool.usedCount < workerPool.pool.GetBufferCount()
+		? workerPool.pool.GetBuffer(workerPool.usedCount)
+		: workerPool.pool.AllocateCmdBuffers(1, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+	++workerPool.usedCount;
+
+	BeginSecondary(commandBuffer, *job.pFormats, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	job.record(commandBuffer);
+	commandBuffer.End();
+	job.buffer = commandBuffer.GetHandle();
+}
+void pompeii::SecondaryRecorder::RecordCachedJob(Job& job)
+{
+	// -- A new secondary comes from this worker's pool, an invalidated one goes back to the pool it came from --
+	CacheEntry& entry = *job.pCache;
+	if (entry.buffer == VK_NULL_HANDLE)
+		entry.poolIdx = m_FrameIndex * m_PoolsPerFrame + m_pThreadPool->GetWorkerIndex();
+
+	// Another worker may be recording a secondary of the same pool, the pool has to be locked for as long as one records
+	WorkerPool& workerPool = *m_vCachePools[entry.poolIdx];
+	std::scoped_lock lock{ workerPool.mutex };
+	if (entry.buffer == VK_NULL_HANDLE)
+	{
+		if (workerPool.vSpareBuffers.empty())
+			entry.buffer = workerPool.pool.AllocateCmdBuffers(1, VK_COMMAND_BUFFER_LEVEL_SECONDARY).GetHandle();
+		else
+		{
+			entry.buffer = workerPool.vSpareBuffers.back();
+			workerPool.vSpareBuffers.pop_back();
+		}
+	}
+
+	// -- Beginning a recorded buffer resets it, its pool allows that per buffer --
+	CommandBuffer commandBuffer{ workerPool.pool.GetHandle(), entry.buffer };
+	BeginSecondary(commandBuffer, *job.pFormats, 0);
+	job.record(commandBuffer);
+	commandBuffer.End();
+	job.buffer = entry.buffer;
+}
+void pompeii::SecondaryRecorder::BeginSecondary(const CommandBuffer& commandBuffer, const RenderingFormats& formats, VkCommandBufferUsageFlags usage) const
+{
+	// -- Inherit the attachments of the rendering scope it runs in --
+	VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+	renderingInfo.colorAttachmentCount = static_cast<uint32_t>(formats.vColorFormats.size());
+	renderingInfo.pColorAttachmentFormats = formats.vColorFormats.data();
+	renderingInfo.depthAttachmentFormat = formats.depthFormat;
+	renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+	renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkCommandBufferInheritanceInfo inheritanceInfo{};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.pNext = &renderingInfo;
+
+	commandBuffer.Begin(usage | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &inheritanceInfo);
+}
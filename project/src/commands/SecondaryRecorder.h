@@ -0,0 +1,153 @@
+#ifndef SECONDARY_RECORDER_H
+#define SECONDARY_RECORDER_H
+
+// -- Vulkan Includes --
+#include <vulkan/vulkan.h>
+
+// -- Standard Library --
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "CommandPool.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Context;
+	class ThreadPool;
+}
+
+
+namespace pompeii
+{
+	// -- Attachments a secondary renders to, has to match the vkCmdBeginRendering that executes it --
+	struct RenderingFormats
+	{
+		std::vector<VkFormat>	vColorFormats	{ };
+		VkFormat				depthFormat		{ VK_FORMAT_UNDEFINED };
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  State Hash
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// FNV-1a over the values a cached secondary's commands were recorded from
+	class StateHash final
+	{
+	public:
+		template<typename T>
+			requires std::is_trivially_copyable_v<T>
+		StateHash& Add(const T& value)
+		{
+			unsigned char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			for (const unsigned char byte : bytes)
+				m_Hash = (m_Hash ^ byte) * 1099511628211ull;
+			return *this;
+		}
+		uint64_t Get() const { return m_Hash; }
+
+	private:
+		uint64_t m_Hash{ 14695981039346656037ull };
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  SecondaryRecorder
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Records the contents of rendering scopes into secondary command buffers across a thread pool.
+	// Every worker owns a command pool per frame in flight, so recording never shares a pool between threads.
+	// Cached secondaries live on across frames and are only recorded again once the state they were recorded from changes
+	class SecondaryRecorder final
+	{
+	public:
+		using RecordFunc = std::function<void(CommandBuffer&)>;
+
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit SecondaryRecorder() = default;
+		~SecondaryRecorder() = default;
+		SecondaryRecorder(const SecondaryRecorder& other) = delete;
+		SecondaryRecorder(SecondaryRecorder&& other) noexcept = delete;
+		SecondaryRecorder& operator=(const SecondaryRecorder& other) = delete;
+		SecondaryRecorder& operator=(SecondaryRecorder&& other) noexcept = delete;
+
+		void Initialize(Context& context, ThreadPool& threadPool);
+		void Destroy();
+
+		//--------------------------------------------------
+		//    Recording
+		//--------------------------------------------------
+		// Resets the pools of this frame and drops last frame's jobs, its fence has to be signaled
+		void BeginFrame(uint32_t frameIndex);
+		// Queues a secondary rendering to formats, which has to outlive RecordAll. Returns the job Execute takes
+		uint32_t Add(const RenderingFormats& formats, RecordFunc record);
+		// Same as Add, but keeps the secondary of (pOwner, slot) for this frame in flight and only records it again when stateHash changes.
+		// stateHash has to cover everything record puts into the buffer, the contents of buffers and images it binds are free to change
+		uint32_t AddCached(const RenderingFormats& formats, const void* pOwner, uint32_t slot, uint64_t stateHash, RecordFunc record);
+		// Records every queued job that has no valid secondary yet on the thread pool, returns once all of them are done
+		void RecordAll();
+		// Has to be called inside a vkCmdBeginRendering with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT
+		void Execute(const CommandBuffer& primary, uint32_t jobIdx) const;
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		// Disabled, AddCached records every frame like Add does
+		void SetCachingEnabled(bool enabled);
+		bool IsCachingEnabled() const;
+		// Jobs RecordAll actually recorded last frame, cached secondaries that were reused are not counted
+		uint32_t GetRecordedCount() const;
+
+	private:
+		struct WorkerPool
+		{
+			CommandPool pool{};
+			uint32_t usedCount{};
+
+			// -- Cached pools only, their buffers are recorded by whichever worker picks up an invalidated job --
+			std::mutex mutex{};
+			std::vector<VkCommandBuffer> vSpareBuffers{};
+		};
+		struct CacheEntry
+		{
+			uint64_t stateHash{};
+			VkCommandBuffer buffer{ VK_NULL_HANDLE };
+			uint32_t poolIdx{};
+			bool used{};
+		};
+		using CacheKey = std::pair<const void*, uint32_t>;
+		struct Job
+		{
+			const RenderingFormats* pFormats;
+			RecordFunc record;
+			VkCommandBuffer buffer;
+			CacheEntry* pCache;
+		};
+		void RecordJob(Job& job);
+		void RecordCachedJob(Job& job);
+		void BeginSecondary(const CommandBuffer& commandBuffer, const RenderingFormats& formats, VkCommandBufferUsageFlags usage) const;
+
+		// -- Pools, maxFramesInFlight rows of one pool per worker plus one for the calling thread --
+		std::vector<std::unique_ptr<WorkerPool>>	m_vPools			{ };
+		std::vector<std::unique_ptr<WorkerPool>>	m_vCachePools		{ };
+		uint32_t									m_PoolsPerFrame		{ };
+		uint32_t									m_FrameIndex		{ };
+
+		// -- Cache, one map per frame in flight --
+		std::vector<std::map<CacheKey, CacheEntry>>	m_vCaches			{ };
+		bool										m_CachingEnabled	{ true };
+
+		// -- Jobs --
+		std::vector<Job>							m_vJobs				{ };
+		std::vector<uint32_t>						m_vPendingJobs		{ };
+		ThreadPool*									m_pThreadPool		{ };
+	};
+}
+
+#endif // SECONDARY_RECORDER_H
@@ -11,6 +11,9 @@
 #include "DeletionQueue.h"
 #include "CommandPool.h"
 #include "DescriptorPool.h"
+#include "AsyncUploader.h"
+#include "GeometryArena.h"
+#include "UploadBatch.h"
 
 namespace pompeii
 {
@@ -23,6 +26,9 @@ namespace pompeii
 
 		CommandPool*	commandPool		{};
 		DescriptorPool*	descriptorPool	{};
+		AsyncUploader*	uploader		{};
+		StagingRing*	stagingRing		{};
+		GeometryArena*	geometryArena	{};
 
 		DeletionQueue	deletionQueue	{};
 
@@ -25,6 +25,7 @@ const VkDevice& pompeii::Device::GetHandle()		const { return m_Device; }
 const VkQueue& pompeii::Device::GetGraphicQueue()	const { return m_GraphicsQueue; }
 const VkQueue& pompeii::Device::GetPresentQueue()	const { return m_PresentQueue; }
 const VkQueue& pompeii::Device::GetComputeQueue()	const { return m_ComputeQueue; }
+const VkQueue& pompeii::Device::GetTransferQueue()	const { return m_TransferQueue; }
 
 
 //--------------------------------------------------
@@ -53,8 +54,8 @@ void pompeii::DeviceBuilder::Build(Context& context) const
 	pompeii::QueueFamilyIndices indices = context.physicalDevice.GetQueueFamilies();
 
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value(), indices.computeFamily.value() };
-	// The above line is done because Graphics, Present, or Compute queue can be the same, doing this only passes the index once
+	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value(), indices.computeFamily.value(), indices.transferFamily.value() };
+	// The above line is done because Graphics, Present, Compute or Transfer queue can be the same, doing this only passes the index once
 
 	float queuePriority = 1.0f;
 	for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -92,4 +93,5 @@ void pompeii::DeviceBuilder::Build(Context& context) const
 	vkGetDeviceQueue(context.device.GetHandle(), indices.graphicsFamily.value(), 0, &context.device.m_GraphicsQueue);
 	vkGetDeviceQueue(context.device.GetHandle(), indices.presentFamily.value(), 0, &context.device.m_PresentQueue);
 	vkGetDeviceQueue(context.device.GetHandle(), indices.computeFamily.value(), 0, &context.device.m_ComputeQueue);
+	vkGetDeviceQueue(context.device.GetHandle(), indices.transferFamily.value(), 0, &context.device.m_TransferQueue);
 }
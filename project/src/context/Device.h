@@ -37,6 +37,7 @@ namespace pompeii
 		const VkQueue&  GetGraphicQueue() const;
 		const VkQueue&  GetPresentQueue() const;
 		const VkQueue&  GetComputeQueue() const;
+		const VkQueue&  GetTransferQueue() const;
 
 
 		//--------------------------------------------------
@@ -49,6 +50,7 @@ namespace pompeii
 		VkQueue		m_GraphicsQueue	{ VK_NULL_HANDLE };
 		VkQueue		m_PresentQueue	{ VK_NULL_HANDLE };
 		VkQueue		m_ComputeQueue	{ VK_NULL_HANDLE };
+		VkQueue		m_TransferQueue	{ VK_NULL_HANDLE };
 
 		friend class DeviceBuilder;
 	};
@@ -329,6 +329,18 @@ pompeii::QueueFamilyIndices pompeii::PhysicalDevice::FindQueueFamilies(const VkS
 		++index;
 	}
 
+	// -- Look for a Transfer only Queue, those map to the copy engines and run next to graphics work --
+	m_QueueFamilyIndices.transferFamily = m_QueueFamilyIndices.graphicsFamily;
+	for (uint32_t familyIdx{}; familyIdx < queueFamilyCount; ++familyIdx)
+	{
+		const VkQueueFlags flags = queueFamilies[familyIdx].queueFlags;
+		if (flags & VK_QUEUE_TRANSFER_BIT && !(flags & VK_QUEUE_GRAPHICS_BIT) && !(flags & VK_QUEUE_COMPUTE_BIT))
+		{
+			m_QueueFamilyIndices.transferFamily = familyIdx;
+			break;
+		}
+	}
+
 	return m_QueueFamilyIndices;
 }
 
@@ -29,6 +29,8 @@ namespace pompeii
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
 		std::optional<uint32_t> computeFamily;
+		// -- Dedicated copy family when there is one, graphics otherwise. Not part of IsComplete --
+		std::optional<uint32_t> transferFamily;
 
 		bool IsComplete() const
 		{
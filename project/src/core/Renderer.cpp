@@ -11,8 +11,11 @@
 #include "IWindow.h"
 #include "Renderer.h"
 #include "RenderDebugger.h"
+#include "Instrumentation.h"
+#include "CPUProfiler.h"
 #include "CommandBuffer.h"
 #include "RenderingItems.h"
+#include "TextureRegistry.h"
 
 //--------------------------------------------------
 //    Constructor & Destructor
@@ -23,6 +26,7 @@ pompeii::Renderer::~Renderer()	{ }
 void pompeii::Renderer::Initialize(IWindow* pWindow)
 {
 	m_pWindow = pWindow;
+	POMPEII_CPU_THREAD("Render Thread");
 	InitializeVulkan();
 }
 void pompeii::Renderer::Deinitialize()
@@ -37,12 +41,21 @@ void pompeii::Renderer::Deinitialize()
 //--------------------------------------------------
 bool pompeii::Renderer::StartFrame()
 {
+	POMPEII_CPU_SCOPE("Start Frame");
+
 	// -- Wait for the current frame to be done --
 	const auto& frameSync = m_SyncManager.GetFrameSync(m_Context.currentFrame);
-	vkWaitForFences(m_Context.device.GetHandle(), 1, &frameSync.inFlight, VK_TRUE, UINT64_MAX);
+	{
+		POMPEII_CPU_SCOPE("Wait For Fence");
+		vkWaitForFences(m_Context.device.GetHandle(), 1, &frameSync.inFlight, VK_TRUE, UINT64_MAX);
+	}
 
 	// -- Acquire new Image from SwapChain --
-	VkResult result = m_SwapChain.AcquireNextImage(m_Context, frameSync.imageAvailable);
+	VkResult result{};
+	{
+		POMPEII_CPU_SCOPE("Acquire Image");
+		result = m_SwapChain.AcquireNextImage(m_Context, frameSync.imageAvailable);
+	}
 
 	// -- If SwapChain Image not good, recreate Swap Chain --
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
@@ -56,31 +69,106 @@ bool pompeii::Renderer::StartFrame()
 	// -- Reset Fence to be un-signaled (not done) --
 	vkResetFences(m_Context.device.GetHandle(), 1, &frameSync.inFlight);
 
-	for (const auto& earlyFrameExecution : m_BeforeCommandBufferExecutions)
-		earlyFrameExecution();
-	m_BeforeCommandBufferExecutions.clear();
+	{
+		POMPEII_CPU_SCOPE("Before Command Buffer");
+		for (const auto& earlyFrameExecution : m_BeforeCommandBufferExecutions)
+			earlyFrameExecution();
+		m_BeforeCommandBufferExecutions.clear();
+	}
 
 	CommandBuffer& cmdBuffer = m_Context.commandPool->GetBuffer(m_Context.currentFrame);
 	cmdBuffer.Reset();
 	cmdBuffer.Begin();
 
+	// -- Read back the GPU timings this frame slot measured last time it came around --
+	m_GPUProfiler.BeginFrame(m_Context, cmdBuffer);
+
+	// -- Take over finished Uploads from the Transfer Queue --
+	m_Context.uploader->Acquire(m_Context, cmdBuffer);
+	// Arena ranges Meshes freed are reused once no frame in flight draws them anymore
+	m_Context.geometryArena->CollectFreed(m_Context);
+
+	// -- Pick up Textures that Meshes acquired or released since last frame --
+	const uint64_t registryVersion = TextureRegistry::GetVersion();
+	if (registryVersion != m_TextureRegistryVersion)
+	{
+		m_TextureStreamer.SetTextures(TextureRegistry::GetTextures());
+		m_TextureRegistryVersion = registryVersion;
+	}
+
+	// -- Stream Textures, this frame's fence is signaled so its descriptors are free to change --
+	m_TextureStreamer.Update(m_Context, cmdBuffer);
+	// Released textures left the streamer in that Update, nothing points at them anymore
+	TextureRegistry::CollectReleased(m_TextureRegistryVersion);
+
 	return true;
 }
 void pompeii::Renderer::RecordFrame()
 {
+	POMPEII_CPU_SCOPE("Record Frame");
+
 	auto imageIndex = m_Context.currentFrame;
 	CommandBuffer& commandBuffer = m_Context.commandPool->GetBuffer(imageIndex);
 	Image& outputImage = m_vOutputImages[imageIndex];
 	Image& renderImage = m_vRenderTargets[imageIndex];
 	Image& depthImage = m_vDepthImages[imageIndex];
 
+	// -- Meshes still uploading are skipped until the uploader hands them over --
+	std::erase_if(m_vRenderItems, [&](const RenderItem& item)
+		{
+			return !m_Context.uploader->IsComplete(item.mesh->GetUploadTicket());
+		});
+
+	// -- Textures --
+	{
+		m_GeometryPass.UpdateTextureDescriptors(m_Context, imageIndex);
+	}
+
+	// -- Culling --
+	uint32_t depthPrePassView{};
+	uint32_t geometryView{};
+	uint32_t firstShadowView{};
+	{
+		// The streamer needs to know on the CPU which Sub Meshes the camera sees
+		const float viewportHeight = static_cast<float>(depthImage.GetExtent2D().height);
+		m_FrustumCuller.Cull(m_vRenderItems, m_Camera);
+		m_GeometryPass.RequestTextures(m_FrustumCuller.GetCameraList(), m_Camera, viewportHeight);
+
+		// Every pass below draws only the Sub Meshes the GPU found inside its own frustum
+		m_GPUCuller.SetInstances(m_vRenderItems);
+		// The camera is a view per pass, each pass sorts its draws its own way
+		const glm::mat4 cameraViewProj = m_Camera.proj * m_Camera.view;
+		const LodSelector cameraLodSelector = LodSelector::FromCamera(m_Camera.view, m_Camera.proj, viewportHeight);
+		depthPrePassView = m_GPUCuller.AddView(cameraViewProj, cameraLodSelector, DrawPass::DepthPrePass);
+		geometryView = m_GPUCuller.AddView(cameraViewProj, cameraLodSelector, DrawPass::Geometry);
+		firstShadowView = m_ShadowPass.AddCullViews(m_Context, m_vLightItems, m_GPUCuller);
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::Culling);
+		m_GPUCuller.Record(m_Context, commandBuffer);
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::Culling);
+	}
+
+	// -- Draw Recording --
+	{
+		// Every pass view records its draws into its own secondary on the thread pool, the passes below only execute them.
+		// Secondaries whose state did not change since this frame slot last came around are reused as they are
+		m_SecondaryRecorder.BeginFrame(m_Context.currentFrame);
+		m_ShadowPass.AddDraws(m_Context, m_SecondaryRecorder, m_vLightItems, m_GPUCuller, firstShadowView);
+		m_DepthPrePass.AddDraws(m_SecondaryRecorder, m_GeometryPass, m_GPUCuller, imageIndex, depthImage.GetExtent2D(), depthPrePassView);
+		m_GeometryPass.AddDraws(m_SecondaryRecorder, m_GPUCuller, imageIndex, geometryView);
+		m_SecondaryRecorder.RecordAll();
+	}
+
 	// -- Shadow Pass --
 	{
-		m_ShadowPass.Record(m_Context, commandBuffer, m_vRenderItems, m_vLightItems);
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::Shadow);
+		m_ShadowPass.Record(m_Context, commandBuffer, m_SecondaryRecorder, m_vLightItems);
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::Shadow);
 	}
 
 	// -- Depth Pre-Pass --
 	{
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::DepthPrePass);
+
 		// Transition the current Depth Image to be written to
 		depthImage.TransitionLayout(commandBuffer,
 			VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
@@ -90,7 +178,7 @@ void pompeii::Renderer::RecordFrame()
 
 		// The Depth Pre-Pass renders the entire scene to the provided depth buffer.
 		m_DepthPrePass.UpdateCamera(m_Context, imageIndex, m_Camera);
-		m_DepthPrePass.Record(commandBuffer, m_GeometryPass, imageIndex, depthImage, m_vRenderItems);
+		m_DepthPrePass.Record(commandBuffer, m_SecondaryRecorder, depthImage);
 
 		// Transition the current Depth Image to be read from
 		depthImage.TransitionLayout(commandBuffer,
@@ -98,18 +186,24 @@ void pompeii::Renderer::RecordFrame()
 			VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
 			VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT,
 			0, depthImage.GetMipLevels(), 0, depthImage.GetLayerCount());
+
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::DepthPrePass);
 	}
 
 	// -- Geometry Pass --
 	{
 		// The Geometry Pass renders the entire scene to a GBuffer.
 		m_GeometryPass.UpdateCamera(m_Context, imageIndex, m_Camera);
-		m_GeometryPass.Record(commandBuffer, imageIndex, depthImage, m_vRenderItems);
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::Geometry);
+		m_GeometryPass.Record(commandBuffer, m_SecondaryRecorder, imageIndex, depthImage);
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::Geometry);
 		// After it is done, the GBuffers are transitioned to a layout ready for being sampled from.
 	}
 
 	// -- Lighting Pass --
 	{
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::Lighting);
+
 		// Transition the current Depth Image to be sampled from
 		depthImage.TransitionLayout(commandBuffer,
 			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -134,13 +228,18 @@ void pompeii::Renderer::RecordFrame()
 			VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
 			VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
 			0, renderImage.GetMipLevels(), 0, renderImage.GetLayerCount());
+
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::Lighting);
 	}
 
 	// -- Blit Pass --
 	{
 		// The blit pass will blit the rendered image to the swapchain and potentially do post-processing.
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::BlitCompute);
 		m_BlitPass.RecordCompute(commandBuffer, imageIndex, renderImage, m_Camera);
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::BlitCompute);
 
+		m_GPUProfiler.BeginZone(commandBuffer, GPUZone::BlitGraphics);
 		// Insert a barrier for the Render Image to be used in fragment
 		renderImage.TransitionLayout(commandBuffer,
 			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -156,10 +255,13 @@ void pompeii::Renderer::RecordFrame()
 			0, outputImage.GetMipLevels(), 0, outputImage.GetLayerCount());
 
 		m_BlitPass.RecordGraphic(m_Context, commandBuffer, imageIndex, outputImage, m_Camera);
+		m_GPUProfiler.EndZone(commandBuffer, GPUZone::BlitGraphics);
 	}
 }
 void pompeii::Renderer::SubmitFrame()
 {
+	POMPEII_CPU_SCOPE("Submit Frame");
+
 	CommandBuffer& commandBuffer = m_Context.commandPool->GetBuffer(m_Context.currentFrame);
 	Image& presentImage = m_SwapChain.GetCurrentImage();
 
@@ -178,14 +280,18 @@ void pompeii::Renderer::SubmitFrame()
 	// -- Get Current Info --
 	const auto& frameSync = m_SyncManager.GetFrameSync(m_Context.currentFrame);
 
-	// -- Submit Commands with Semaphores --
+	// -- Submit Commands with Semaphores, the upload timeline covers everything acquired this frame --
 	const SemaphoreInfo semaphoreInfo
 	{
-		.vWaitSemaphores = { frameSync.imageAvailable },
-		.vWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT },
+		.vWaitSemaphores = { frameSync.imageAvailable, m_Context.uploader->GetSemaphore() },
+		.vWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT },
+		.vWaitValues = { 0, m_Context.uploader->GetAcquiredValue() },
 		.vSignalSemaphores = { frameSync.renderFinished }
 	};
-	cmdBuffer.Submit(m_Context.device.GetGraphicQueue(), false, semaphoreInfo, frameSync.inFlight);
+	{
+		POMPEII_CPU_SCOPE("Submit");
+		cmdBuffer.Submit(m_Context.device.GetGraphicQueue(), false, semaphoreInfo, frameSync.inFlight);
+	}
 
 	// -- Create Present Info --
 	VkPresentInfoKHR presentInfo{};
@@ -201,7 +307,11 @@ void pompeii::Renderer::SubmitFrame()
 	presentInfo.pResults = nullptr;
 
 	// -- Present --
-	auto result = vkQueuePresentKHR(m_Context.device.GetPresentQueue(), &presentInfo);
+	VkResult result{};
+	{
+		POMPEII_CPU_SCOPE("Present");
+		result = vkQueuePresentKHR(m_Context.device.GetPresentQueue(), &presentInfo);
+	}
 
 	// -- If Present failed or out of date, recreate SwapChain --
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_pWindow->IsOutdated())
@@ -212,13 +322,17 @@ void pompeii::Renderer::SubmitFrame()
 	else if (result != VK_SUCCESS)
 		throw std::runtime_error("Failed to present Swap Chain Image!");
 
-	for (const auto& lateFrameExecution : m_AfterCommandBufferExecutions)
-		lateFrameExecution();
-	m_AfterCommandBufferExecutions.clear();
+	{
+		POMPEII_CPU_SCOPE("After Command Buffer");
+		for (const auto& lateFrameExecution : m_AfterCommandBufferExecutions)
+			lateFrameExecution();
+		m_AfterCommandBufferExecutions.clear();
+	}
 }
 void pompeii::Renderer::EndFrame()
 {
 	ClearQueue();
+	POMPEII_COUNTERS_END_FRAME();
 	m_Context.currentFrame = (m_Context.currentFrame + 1) % m_Context.maxFramesInFlight;
 }
 
@@ -290,10 +404,21 @@ void pompeii::Renderer::UpdateLights(const std::vector<Light*>& lights)
 	m_Context.device.WaitIdle();
 	m_LightingPass.UpdateLightData(m_Context, lights);
 }
-void pompeii::Renderer::UpdateTextures(const std::vector<Image*>& textures)
+void pompeii::Renderer::SetTextureBudget(VkDeviceSize budget)
 {
-	m_Context.device.WaitIdle();
-	m_GeometryPass.UpdateTextureDescriptor(m_Context, textures);
+	m_TextureStreamer.SetBudget(budget);
+}
+void pompeii::Renderer::SetDrawCaching(bool enabled)
+{
+	m_SecondaryRecorder.SetCachingEnabled(enabled);
+}
+pompeii::PassCullStats pompeii::Renderer::GetCullStats() const
+{
+	return m_GPUCuller.GetPassStats();
+}
+const pompeii::GPUProfiler& pompeii::Renderer::GetGPUProfiler() const
+{
+	return m_GPUProfiler;
 }
 void pompeii::Renderer::UpdateEnvironmentMap() const
 {
@@ -342,6 +467,8 @@ void pompeii::Renderer::InitializeVulkan()
 	vulkanCoreFeatures.samplerAnisotropy = VK_TRUE;
 	vulkanCoreFeatures.fillModeNonSolid = VK_TRUE;
 	vulkanCoreFeatures.sampleRateShading = VK_TRUE;
+	vulkanCoreFeatures.multiDrawIndirect = VK_TRUE;
+	vulkanCoreFeatures.drawIndirectFirstInstance = VK_TRUE;
 
 	// -- Vulkan API 1.1 Features --
 	VkPhysicalDeviceVulkan11Features vulkan11Features{};
@@ -357,6 +484,8 @@ void pompeii::Renderer::InitializeVulkan()
 	vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
 	vulkan12Features.descriptorIndexing = VK_TRUE;
 	vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+	vulkan12Features.drawIndirectCount = VK_TRUE;
 	vulkan12Features.pNext = &vulkan11Features;  // Chain Vulkan API 1.1 Features
 
 	// -- Vulkan API 1.3 Features --
@@ -381,6 +510,13 @@ void pompeii::Renderer::InitializeVulkan()
 			.PickPhysicalDevice(m_Context, m_pWindow->GetVulkanSurface());
 	}
 
+	// -- Optional Features - Requirements - [Physical Device]
+	{
+		// Block compressed textures are used when available, otherwise textures fall back to R8G8B8A8
+		features2.features.textureCompressionBC = m_Context.physicalDevice.GetFeatures().textureCompressionBC;
+		Texture::SetBlockCompressionSupported(features2.features.textureCompressionBC == VK_TRUE);
+	}
+
 	// -- Create Device - Requirements - [Physical Device - Instance]
 	{
 		DeviceBuilder deviceBuilder{};
@@ -424,6 +560,30 @@ void pompeii::Renderer::InitializeVulkan()
 		m_Context.deletionQueue.Push([&] { m_Context.commandPool->Destroy(); delete m_Context.commandPool; m_Context.commandPool = nullptr; });
 	}
 
+	// -- Create Staging Ring - Requirements - [Device - Allocator]
+	{
+		m_Context.stagingRing = new StagingRing();
+		m_Context.stagingRing->Initialize(m_Context);
+
+		m_Context.deletionQueue.Push([&] { m_Context.stagingRing->Destroy(m_Context); delete m_Context.stagingRing; m_Context.stagingRing = nullptr; });
+	}
+
+	// -- Create Uploader - Requirements - [Device - Physical Device - Allocator]
+	{
+		m_Context.uploader = new AsyncUploader();
+		m_Context.uploader->Initialize(m_Context);
+
+		m_Context.deletionQueue.Push([&] { m_Context.uploader->Destroy(m_Context); delete m_Context.uploader; m_Context.uploader = nullptr; });
+	}
+
+	// -- Create Geometry Arena - Requirements - [Allocator - Uploader]
+	{
+		m_Context.geometryArena = new GeometryArena();
+		m_Context.geometryArena->Initialize(m_Context);
+
+		m_Context.deletionQueue.Push([&] { m_Context.geometryArena->Destroy(m_Context); delete m_Context.geometryArena; m_Context.geometryArena = nullptr; });
+	}
+
 	// -- Create SwapChain - Requirements - [Device - Allocator - Physical Device, Window, Command Pool]
 	{
 		VkExtent2D windowExtent = { m_pWindow->GetFramebufferSize().x, m_pWindow->GetFramebufferSize().y };
@@ -445,6 +605,7 @@ void pompeii::Renderer::InitializeVulkan()
 			.AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100)
 			.AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 100)
 			.AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100)
+			.AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100)
 			.AddFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
 			.AddFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
 			.Create(m_Context);
@@ -469,11 +630,38 @@ void pompeii::Renderer::InitializeVulkan()
 		m_Context.deletionQueue.Push([&] { for (Image& image : m_vOutputImages) image.Destroy(m_Context); });
 	}
 
+	// -- Texture Streamer --
+	{
+		TextureStreamerCreateInfo createInfo{};
+		m_TextureStreamer.Initialize(m_Context, createInfo);
+		m_Context.deletionQueue.Push([&] { m_TextureStreamer.Destroy(m_Context); });
+	}
+
+	// -- GPU Culler --
+	{
+		m_GPUCuller.Initialize(m_Context, m_ThreadPool);
+		m_Context.deletionQueue.Push([&] { m_GPUCuller.Destroy(); });
+	}
+
+	// -- Secondary Recorder --
+	{
+		m_SecondaryRecorder.Initialize(m_Context, m_ThreadPool);
+		m_Context.deletionQueue.Push([&] { m_SecondaryRecorder.Destroy(); });
+	}
+
+	// -- GPU Profiler --
+	{
+		m_GPUProfiler.Initialize(m_Context);
+		m_Context.deletionQueue.Push([&] { m_GPUProfiler.Destroy(m_Context); });
+	}
+
 	// -- Geometry Pass --
 	{
 		GeometryPassCreateInfo createInfo{};
 		createInfo.extent = m_SwapChain.GetExtent();
 		createInfo.depthFormat = m_vDepthImages[0].GetFormat();
+		createInfo.pTextureStreamer = &m_TextureStreamer;
+		createInfo.pGPUCuller = &m_GPUCuller;
 
 		m_GeometryPass.Initialize(m_Context, createInfo);
 		m_Context.deletionQueue.Push([&] {m_GeometryPass.Destroy(); });
@@ -481,7 +669,7 @@ void pompeii::Renderer::InitializeVulkan()
 
 	// -- Shadow Pass --
 	{
-		m_ShadowPass.Initialize(m_Context);
+		m_ShadowPass.Initialize(m_Context, m_GPUCuller);
 		m_Context.deletionQueue.Push([&] {m_ShadowPass.Destroy(); });
 	}
 
@@ -490,6 +678,7 @@ void pompeii::Renderer::InitializeVulkan()
 		DepthPrePassCreateInfo createInfo{};
 		createInfo.depthFormat = m_vDepthImages[0].GetFormat();
 		createInfo.pGeometryPass = &m_GeometryPass;
+		createInfo.pGPUCuller = &m_GPUCuller;
 
 		m_DepthPrePass.Initialize(m_Context, createInfo);
 		m_Context.deletionQueue.Push([&] {m_DepthPrePass.Destroy(); });
@@ -501,6 +690,7 @@ void pompeii::Renderer::InitializeVulkan()
 		createInfo.pGeometryPass = &m_GeometryPass;
 		createInfo.format = m_vRenderTargets.front().GetFormat();
 		createInfo.pDepthImages = &m_vDepthImages;
+		createInfo.useDiffuseSH = true; // false to compare against the convolved cube map
 
 		m_LightingPass.Initialize(m_Context, createInfo);
 		m_Context.deletionQueue.Push([&] { m_LightingPass.Destroy(); });
@@ -509,9 +699,11 @@ void pompeii::Renderer::InitializeVulkan()
 		m_EnvMap
 			.CreateSampler(m_Context)
 			.CreateSkyboxCube(m_Context, "textures/golden_gate_hills_4k.hdr")
-			.CreateDiffIrradianceMap(m_Context)
+			.CreateDiffIrradianceSH(m_Context)
 			.CreateSpecIrradianceMap(m_Context)
 			.CreateBRDFLut(m_Context);
+		if (!createInfo.useDiffuseSH)
+			m_EnvMap.CreateDiffIrradianceMap(m_Context);
 		m_LightingPass.UpdateEnvironmentMap(m_Context, m_EnvMap);
 		m_Context.deletionQueue.Push([&] { m_EnvMap.Destroy(m_Context); });
 	}
@@ -538,6 +730,8 @@ void pompeii::Renderer::InitializeVulkan()
 //--------------------------------------------------
 void pompeii::Renderer::RecreateSwapChain()
 {
+	POMPEII_CPU_SCOPE("Recreate Swap Chain");
+
 	auto size = m_pWindow->GetFramebufferSize();
 	while (size.x == 0 || size.y == 0)
 	{
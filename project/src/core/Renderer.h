@@ -11,6 +11,10 @@
 #include "Context.h"
 #include "SwapChain.h"
 #include "SyncManager.h"
+#include "SecondaryRecorder.h"
+#include "TextureStreamer.h"
+#include "FrustumCuller.h"
+#include "GPUCuller.h"
 
 #include "ShadowPass.h"
 #include "DepthPrePass.h"
@@ -23,6 +27,8 @@
 #include "Mesh.h"
 #include "RenderingItems.h"
 #include "GPUCamera.h"
+#include "ThreadPool.h"
+#include "GPUProfiler.h"
 
 // -- Forward Declarations --
 namespace pompeii
@@ -79,8 +85,14 @@ namespace pompeii
 		std::vector<Image>& GetOutputImages();
 
 		void UpdateLights(const std::vector<Light*>& lights);
-		void UpdateTextures(const std::vector<Image*>& textures);
+		void SetTextureBudget(VkDeviceSize budget);
+		// Keeps the pass draws in secondaries across frames and only records them again once their state changes
+		void SetDrawCaching(bool enabled);
 		void UpdateEnvironmentMap() const;
+		// Visible and culled Sub Meshes, read back from the GPU maxFramesInFlight frames late
+		PassCullStats GetCullStats() const;
+		// Per pass GPU timings over the last frames, measured with timestamp queries
+		const GPUProfiler& GetGPUProfiler() const;
 
 	private:
 		//--------------------------------------------------
@@ -105,10 +117,25 @@ namespace pompeii
 		// -- Sync --
 		SyncManager					m_SyncManager			{ };
 
+		// -- Textures --
+		TextureStreamer				m_TextureStreamer		{ };
+		uint64_t					m_TextureRegistryVersion{ };
+
 		using FuncVector = std::vector<std::function<void()>>;
 		FuncVector m_BeforeCommandBufferExecutions			{ };
 		FuncVector m_AfterCommandBufferExecutions			{ };
 
+		// -- Workers --
+		ThreadPool					m_ThreadPool			{ };
+		SecondaryRecorder			m_SecondaryRecorder		{ };
+
+		// -- Profiling --
+		GPUProfiler					m_GPUProfiler			{ };
+
+		// -- Culling --
+		FrustumCuller				m_FrustumCuller			{ };
+		GPUCuller					m_GPUCuller				{ };
+
 		// -- Passes --
 		ShadowPass					m_ShadowPass			{ };
 		DepthPrePass				m_DepthPrePass			{ };
@@ -1,19 +1,16 @@
 // -- Standard Library --
-#include <array>
+#include <algorithm>
 
 // -- Pompeii Includes --
 #include "EnvironmentMap.h"
+#include "IBLCache.h"
 #include "Context.h"
 #include "DescriptorSet.h"
 #include "Pipeline.h"
 #include "Shader.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "Material.h"
 
-// -- Math Includes --
-#include "glm/ext/matrix_clip_space.hpp"
-#include "glm/ext/matrix_transform.hpp"
-
 //--------------------------------------------------
 //    Constructor & Destructor
 //--------------------------------------------------
@@ -21,6 +18,7 @@ void pompeii::EnvironmentMap::Destroy(const Context& context)
 {
 	m_BRDFLut.Destroy(context);
 	m_SpecularIrradiance.Destroy(context);
+	m_DiffuseIrradianceSH.Destroy(context);
 	m_DiffuseIrradiance.Destroy(context);
 	m_Skybox.Destroy(context);
 	m_Sampler.Destroy(context);
@@ -43,59 +41,60 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateSampler(const Context& c
 }
 pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateSkyboxCube(const Context& context, const std::string& path, uint32_t size)
 {
-	// -- Load HDRI Texture on CPU --
-	Texture tex{ path, VK_FORMAT_R32G32B32A32_SFLOAT, true};
-	glm::ivec2 extent = tex.GetExtent();
-
-	// -- Build HDR Image on GPU --
-	Image HDRI{};
-	ImageBuilder builder{};
-	builder
-		.SetDebugName(tex.GetPath().c_str())
-		.SetWidth(extent.x)
-		.SetHeight(extent.y)
-		.SetFormat(tex.GetFormat())
-		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
-		.SetUsageFlags(VK_IMAGE_USAGE_SAMPLED_BIT)
-		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-		.InitialData(tex.GetPixels(), 0, extent.x, extent.y, tex.GetMemorySize(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-		.Build(context, HDRI);
-	HDRI.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1);
-
 	// -- Build Cube Map Image on GPU --
 	uint32_t maxMipsLevels = static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
-	builder = {};
+	ImageBuilder builder{};
 	builder
 		.SetDebugName("Cube Map Skybox")
 		.SetWidth(size)
 		.SetHeight(size)
-		.SetFormat(VK_FORMAT_R32G32B32A32_SFLOAT)
+		.SetFormat(VK_FORMAT_R16G16B16A16_SFLOAT)
 		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
 		.SetMipLevels(maxMipsLevels)
-		.SetUsageFlags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+		.SetUsageFlags(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
 		.SetCreateFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
 		.SetArrayLayers(6) // 6 beautiful cubic faces :)
 		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
 		.Build(context, m_Skybox);
-	// -- Generate the 6 views to each face --
-	std::array<std::vector<ImageView>, 6> faces{};
-	for (uint32_t i{}; i < 6; ++i)
+
+	// -- Cached from a previous run, the maps built from it are keyed on the same inputs --
+	m_SourcePath = path;
+	m_SkyboxKey = IBLCache::HashFile("shaders/equirect_to_cube.comp.spv", IBLCache::HashFile(path));
+	const std::string cachePath = IBLCache::GetCachePath(path, "skybox", size);
+	if (!IBLCache::Read(context, cachePath, m_SkyboxKey, m_Skybox))
 	{
-		faces[i].resize(1);
-		faces[i][0] = m_Skybox.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, 1, i, 1);
+		// -- Load HDRI Texture on CPU, packed to shared exponent while decoding --
+		Texture tex{ path, VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, true };
+		glm::ivec2 extent = tex.GetExtent();
+
+		// -- Build HDR Image on GPU --
+		Image HDRI{};
+		builder = {};
+		builder
+			.SetDebugName(tex.GetPath().c_str())
+			.SetWidth(extent.x)
+			.SetHeight(extent.y)
+			.SetFormat(tex.GetFormat())
+			.SetTiling(VK_IMAGE_TILING_OPTIMAL)
+			.SetUsageFlags(VK_IMAGE_USAGE_SAMPLED_BIT)
+			.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+			.InitialData(tex.GetPixels(), 0, extent.x, extent.y, tex.GetMemorySize(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+			.Build(context, HDRI);
+		tex.FreePixels();
+		HDRI.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1);
+
+		// -- Convert the top Mip, the rest is blitted from it --
+		DispatchToCubeMap(context, "shaders/equirect_to_cube.comp.spv",
+						  HDRI.GetView(), m_Sampler, m_Skybox, 1, size);
+		m_Skybox.GenerateMipMaps(context, size, size, maxMipsLevels, 6, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		HDRI.Destroy(context);
+
+		IBLCache::Write(context, cachePath, m_SkyboxKey, m_Skybox);
 	}
 
-	// -- Render To CubeMap --
-	RenderToCubeMap(context, "shaders/cubemap.vert.spv", "shaders/cubemap.frag.spv", 
-				 HDRI, HDRI.GetView(), m_Sampler, 
-				 m_Skybox, faces, size);
-	m_Skybox.GenerateMipMaps(context, size, size, maxMipsLevels, 6, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-	m_Skybox.DestroyAllViews(context);
-
 	// -- Generate a view to all faces --
 	m_Skybox.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_CUBE, 0, m_Skybox.GetMipLevels(), 0, 6);
 
-	HDRI.Destroy(context);
 	return *this;
 }
 
@@ -109,26 +108,24 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateDiffIrradianceMap(const
 		.SetDebugName("Cube Map Diffuse Irradiance")
 		.SetWidth(size)
 		.SetHeight(size)
-		.SetFormat(VK_FORMAT_R32G32B32A32_SFLOAT)
+		.SetFormat(VK_FORMAT_R16G16B16A16_SFLOAT)
 		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
-		.SetUsageFlags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+		.SetUsageFlags(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
 		.SetCreateFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
 		.SetArrayLayers(6) // 6 beautiful cubic faces :)
 		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
 		.Build(context, m_DiffuseIrradiance);
-	// -- Generate the 6 views to each face --
-	std::array<std::vector<ImageView>, 6> faces{};
-	for (uint32_t i{}; i < 6; ++i)
+
+	const uint64_t key = IBLCache::HashFile("shaders/diffuse_irradiance.comp.spv", m_SkyboxKey);
+	const std::string cachePath = IBLCache::GetCachePath(m_SourcePath, "diffuse", size);
+	if (!IBLCache::Read(context, cachePath, key, m_DiffuseIrradiance))
 	{
-		faces[i].resize(1);
-		faces[i][0] = m_DiffuseIrradiance.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, 1, i, 1);
-	}
+		// -- Convolute --
+		DispatchToCubeMap(context, "shaders/diffuse_irradiance.comp.spv",
+						  m_Skybox.GetView(), m_Sampler, m_DiffuseIrradiance, 1, size);
 
-	// -- Render To CubeMap --
-	RenderToCubeMap(context, "shaders/cubemap.vert.spv", "shaders/diffuse_irradiance.frag.spv",
-		m_Skybox, m_Skybox.GetView(), m_Sampler,
-		m_DiffuseIrradiance, faces, size);
-	m_DiffuseIrradiance.DestroyAllViews(context);
+		IBLCache::Write(context, cachePath, key, m_DiffuseIrradiance);
+	}
 
 	// -- Generate a view to all faces --
 	m_DiffuseIrradiance.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_CUBE, 0, 1, 0, 6);
@@ -136,6 +133,156 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateDiffIrradianceMap(const
 	return *this;
 }
 
+pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateDiffIrradianceSH(const Context& context, uint32_t sampleSize)
+{
+	assert(m_Skybox.GetHandle() && "Cannot create diffuse irradiance harmonics without the skybox being set up!");
+
+	// -- Push Constant Struct --
+	struct PC
+	{
+		uint32_t mip;
+		uint32_t faceSize;
+		float roughness;
+	};
+
+	// -- Project from a low Mip, the harmonics can't hold more detail than that anyway --
+	const uint32_t skyboxSize = m_Skybox.GetExtent2D().width;
+	uint32_t mip{};
+	while (mip + 1 < m_Skybox.GetMipLevels() && (skyboxSize >> (mip + 1)) >= sampleSize)
+		++mip;
+	const uint32_t faceSize = std::max(1u, skyboxSize >> mip);
+	const uint32_t groupCount = (faceSize + 7) / 8;
+	const uint32_t partialCount = groupCount * groupCount * 6;
+
+	// -- Buffers --
+	constexpr uint32_t coefficientCount = 9;
+	Buffer partials{};
+	BufferAllocator bufferAlloc{};
+	bufferAlloc
+		.SetDebugName("SSBO (Partial Diffuse SH)")
+		.SetUsage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+		.SetSize(static_cast<uint32_t>(partialCount * coefficientCount * sizeof(glm::vec4)))
+		.HostAccess(false)
+		.Allocate(context, partials);
+	bufferAlloc = {};
+	bufferAlloc
+		.SetDebugName("UBO (Diffuse SH)")
+		.SetUsage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+		.SetSize(static_cast<uint32_t>(coefficientCount * sizeof(glm::vec4)))
+		.HostAccess(false)
+		.Allocate(context, m_DiffuseIrradianceSH);
+
+	// -- Descriptor Set Layout --
+	DescriptorSetLayout DSL{};
+	DescriptorSetLayoutBuilder DSLBuilder{};
+	DSLBuilder
+		.SetDebugName("Diffuse SH DSL")
+		.NewLayoutBinding()
+			.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+			.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT)
+		.NewLayoutBinding()
+			.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+			.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT)
+		.NewLayoutBinding()
+			.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+			.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT)
+		.Build(context, DSL);
+
+	// -- Pipeline Layout, shared by both passes --
+	PipelineLayout pipelineLayout{};
+	PipelineLayoutBuilder pipelineLayoutBuilder{};
+	pipelineLayoutBuilder
+		.NewPushConstantRange()
+			.SetPCSize(sizeof(PC))
+			.SetPCStageFlags(VK_SHADER_STAGE_COMPUTE_BIT)
+		.AddLayout(DSL)
+		.Build(context, pipelineLayout);
+
+	// -- Load Shaders --
+	ShaderLoader shaderLoader{};
+	ShaderModule projectShader;
+	ShaderModule reduceShader;
+	shaderLoader.Load(context, "shaders/sh_project.comp.spv", projectShader);
+	shaderLoader.Load(context, "shaders/sh_reduce.comp.spv", reduceShader);
+
+	// -- Pipelines --
+	Pipeline projectPipeline{};
+	Pipeline reducePipeline{};
+	ComputePipelineBuilder pipelineBuilder{};
+	pipelineBuilder
+		.SetDebugName("Compute Pipeline (Project SH)")
+		.SetPipelineLayout(pipelineLayout)
+		.SetShader(projectShader)
+		.Build(context, projectPipeline);
+	pipelineBuilder = {};
+	pipelineBuilder
+		.SetDebugName("Compute Pipeline (Reduce SH)")
+		.SetPipelineLayout(pipelineLayout)
+		.SetShader(reduceShader)
+		.Build(context, reducePipeline);
+
+	// -- Allocate & Write Descriptor Set --
+	DescriptorSet DS{};
+	DS = context.descriptorPool->AllocateSets(context, DSL, 1, "Diffuse SH DS").front();
+	DescriptorSetWriter writer{};
+	writer
+		.AddImageInfo(m_Skybox.GetView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_Sampler)
+		.WriteImages(DS, 0)
+		.Execute(context);
+	writer
+		.AddBufferInfo(partials, 0, static_cast<uint32_t>(partials.Size()))
+		.WriteBuffers(DS, 1)
+		.Execute(context);
+	writer
+		.AddBufferInfo(m_DiffuseIrradianceSH, 0, static_cast<uint32_t>(m_DiffuseIrradianceSH.Size()))
+		.WriteBuffers(DS, 2)
+		.Execute(context);
+
+	// -- Dispatch --
+	CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
+	cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	{
+		POMPEII_GPU_BEGIN(cmd, "Project Diffuse SH", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+		const VkCommandBuffer& vCmd = cmd.GetHandle();
+		vkCmdBindDescriptorSets(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout.GetHandle(), 0, 1, &DS.GetHandle(), 0, nullptr);
+
+		// -- Every Group reduces its own Texels to one set of Coefficients --
+		PC pc{ .mip = mip, .faceSize = faceSize, .roughness = 0.f };
+		vkCmdPushConstants(vCmd, pipelineLayout.GetHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PC), &pc);
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, projectPipeline.GetHandle());
+		vkCmdDispatch(vCmd, groupCount, groupCount, 6);
+
+		partials.InsertBarrier(cmd,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+		// -- One Group sums the Partials and convolves them with the cosine lobe --
+		vkCmdPushConstants(vCmd, pipelineLayout.GetHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &partialCount);
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline.GetHandle());
+		vkCmdDispatch(vCmd, 1, 1, 1);
+
+		m_DiffuseIrradianceSH.InsertBarrier(cmd,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_UNIFORM_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+
+		POMPEII_GPU_END(cmd);
+	}
+	cmd.End();
+	cmd.Submit(context.device.GetGraphicQueue(), true);
+	cmd.Free(context.device);
+
+	// -- Cleanup --
+	reducePipeline.Destroy(context);
+	projectPipeline.Destroy(context);
+	reduceShader.Destroy(context);
+	projectShader.Destroy(context);
+	pipelineLayout.Destroy(context);
+	DSL.Destroy(context);
+	partials.Destroy(context);
+
+	return *this;
+}
+
 pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateSpecIrradianceMap(const Context& context, uint32_t size)
 {
 	assert(m_Skybox.GetHandle() && "Cannot create a diffuse irradiance map without the skybox being set up!");
@@ -146,30 +293,25 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateSpecIrradianceMap(const
 		.SetDebugName("Cube Map Specular Irradiance")
 		.SetWidth(size)
 		.SetHeight(size)
-		.SetFormat(VK_FORMAT_R32G32B32A32_SFLOAT)
+		.SetFormat(VK_FORMAT_R16G16B16A16_SFLOAT)
 		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
-		.SetUsageFlags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+		.SetUsageFlags(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
 		.SetCreateFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT)
 		.SetMipLevels(5) // 5 mip for 5 roughness levels (0.00; 0.25; 0.50; 0.75; 1.00)
 		.SetArrayLayers(6) // 6 beautiful cubic faces :)
 		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
 		.Build(context, m_SpecularIrradiance);
-	// -- Generate the 6 views to each face --
-	std::array<std::vector<ImageView>, 6> faces{};
-	for (uint32_t i{}; i < 6; ++i)
+
+	const uint64_t key = IBLCache::HashFile("shaders/specular_irradiance.comp.spv", m_SkyboxKey);
+	const std::string cachePath = IBLCache::GetCachePath(m_SourcePath, "specular", size);
+	if (!IBLCache::Read(context, cachePath, key, m_SpecularIrradiance))
 	{
-		faces[i].resize(5);
-		for (uint32_t j{}; j < 5; ++j)
-		{
-			faces[i][j] = m_SpecularIrradiance.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, j, 1, i, 1);
-		}
-	}
+		// -- Prefilter, one Mip per roughness level --
+		DispatchToCubeMap(context, "shaders/specular_irradiance.comp.spv",
+						  m_Skybox.GetView(), m_Sampler, m_SpecularIrradiance, 5, size);
 
-	// -- Render To CubeMap --
-	RenderToCubeMap(context, "shaders/cubemap.vert.spv", "shaders/specular_irradiance.frag.spv",
-		m_Skybox, m_Skybox.GetView(), m_Sampler,
-		m_SpecularIrradiance, faces, size);
-	m_SpecularIrradiance.DestroyAllViews(context);
+		IBLCache::Write(context, cachePath, key, m_SpecularIrradiance);
+	}
 
 	// -- Generate a view to all faces --
 	m_SpecularIrradiance.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_CUBE, 0, 5, 0, 6);
@@ -189,11 +331,17 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateBRDFLut(const Context& c
 		.SetHeight(size)
 		.SetFormat(VK_FORMAT_R32G32_SFLOAT)
 		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
-		.SetUsageFlags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT)
+		.SetUsageFlags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
 		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
 		.Build(context, m_BRDFLut);
 	m_BRDFLut.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, 1, 0, 1);
 
+	// -- Doesn't depend on the scene, only the shader that integrates it --
+	const uint64_t key = IBLCache::HashFile("shaders/brdf_lut.frag.spv");
+	const std::string cachePath = IBLCache::GetCachePath("shaders/brdf_lut.frag.spv", "lut", size);
+	if (IBLCache::Read(context, cachePath, key, m_BRDFLut))
+		return *this;
+
 	// -- Pipeline Layout --
 	PipelineLayout pipelineLayout{};
 	PipelineLayoutBuilder pipelineLayoutBuilder{};
@@ -235,7 +383,7 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateBRDFLut(const Context& c
 	CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
 	cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 	{
-		RenderDebugger::BeginDebugLabel(cmd, "Render To BRDF LUT", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+		POMPEII_GPU_BEGIN(cmd, "Render To BRDF LUT", glm::vec4(0.6f, 0.2f, 0.8f, 1));
 		const VkCommandBuffer& vCmd = cmd.GetHandle();
 
 		// -- Ready outImage to be rendered to --
@@ -298,7 +446,7 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateBRDFLut(const Context& c
 			VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
 			0, m_BRDFLut.GetMipLevels(), 0, m_BRDFLut.GetLayerCount());
 
-		RenderDebugger::EndDebugLabel(cmd);
+		POMPEII_GPU_END(cmd);
 	}
 	cmd.End();
 	cmd.Submit(context.device.GetGraphicQueue(), true);
@@ -310,6 +458,7 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateBRDFLut(const Context& c
 	vertShader.Destroy(context);
 	pipelineLayout.Destroy(context);
 
+	IBLCache::Write(context, cachePath, key, m_BRDFLut);
 	return *this;
 }
 
@@ -319,31 +468,37 @@ pompeii::EnvironmentMap& pompeii::EnvironmentMap::CreateBRDFLut(const Context& c
 const pompeii::Sampler& pompeii::EnvironmentMap::GetSampler()				const { return m_Sampler; }
 const pompeii::Image& pompeii::EnvironmentMap::GetSkybox()					const { return m_Skybox; }
 const pompeii::Image& pompeii::EnvironmentMap::GetDiffuseIrradianceMap()	const { return m_DiffuseIrradiance; }
+const pompeii::Buffer& pompeii::EnvironmentMap::GetDiffuseIrradianceSH()	const { return m_DiffuseIrradianceSH; }
 const pompeii::Image& pompeii::EnvironmentMap::GetSpecularIrradianceMap()	const { return m_SpecularIrradiance; }
 const pompeii::Image& pompeii::EnvironmentMap::GetBRDFLut()					const { return m_BRDFLut; }
 
 //--------------------------------------------------
 //    Helpers
 //--------------------------------------------------
-void pompeii::EnvironmentMap::RenderToCubeMap(const Context& context, const std::string& vert, const std::string& frag,
-										  Image&, const ImageView& inView, const Sampler& inSampler,
-										  Image& outImage, std::array<std::vector<ImageView>, 6>& outViews, uint32_t size)
+void pompeii::EnvironmentMap::DispatchToCubeMap(const Context& context, const std::string& comp,
+												const ImageView& inView, const Sampler& inSampler,
+												Image& outImage, uint32_t mipCount, uint32_t size)
 {
 	// -- Push Constant Struct --
 	struct PC
 	{
-		glm::mat4 view;
-		glm::mat4 projection;
+		uint32_t mip;
+		uint32_t faceSize;
+		float roughness;
 	};
 
 	// -- Descriptor Set Layout --
 	DescriptorSetLayout DSL{};
 	DescriptorSetLayoutBuilder DSLBuilder{};
 	DSLBuilder
-		.SetDebugName("Render To CubeMap DSL")
+		.SetDebugName("Dispatch To CubeMap DSL")
 		.NewLayoutBinding()
 			.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
-			.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
+			.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT)
+		.NewLayoutBinding()
+			.SetType(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+			.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT)
+			.SetCount(mipCount)
 		.Build(context, DSL);
 
 	// -- Pipeline Layout --
@@ -352,164 +507,92 @@ void pompeii::EnvironmentMap::RenderToCubeMap(const Context& context, const std:
 	pipelineLayoutBuilder
 		.NewPushConstantRange()
 			.SetPCSize(sizeof(PC))
-			.SetPCStageFlags(VK_SHADER_STAGE_VERTEX_BIT)
-		.NewPushConstantRange()
-			.SetPCOffset(sizeof(PC))
-			.SetPCSize(sizeof(float))
-			.SetPCStageFlags(VK_SHADER_STAGE_FRAGMENT_BIT)
+			.SetPCStageFlags(VK_SHADER_STAGE_COMPUTE_BIT)
 		.AddLayout(DSL)
 		.Build(context, pipelineLayout);
 
-	// -- Load Shaders --
+	// -- Load Shader --
 	ShaderLoader shaderLoader{};
-	ShaderModule vertShader;
-	ShaderModule fragShader;
-	shaderLoader.Load(context, vert, vertShader);
-	shaderLoader.Load(context, frag, fragShader);
-
-	// -- Pipeline --
-	VkPipelineRenderingCreateInfo renderingCreateInfo{};
-	VkFormat format = outImage.GetFormat();
-	renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-	renderingCreateInfo.colorAttachmentCount = 1;
-	renderingCreateInfo.pColorAttachmentFormats = &format;
+	ShaderModule compShader;
+	shaderLoader.Load(context, comp, compShader);
 
+	// -- Pipeline, the output array is sized through a specialization constant --
 	Pipeline pipeline{};
-	GraphicsPipelineBuilder pipelineBuilder{};
+	ComputePipelineBuilder pipelineBuilder{};
 	pipelineBuilder
-		.SetDebugName("Graphics Pipeline (Render To CubeMap)")
+		.SetDebugName("Compute Pipeline (Dispatch To CubeMap)")
 		.SetPipelineLayout(pipelineLayout)
-		.SetupDynamicRendering(renderingCreateInfo)
-		.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
-		.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
-		.AddShader(vertShader, VK_SHADER_STAGE_VERTEX_BIT)
-		.AddShader(fragShader, VK_SHADER_STAGE_FRAGMENT_BIT)
-		.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-		.SetCullMode(VK_CULL_MODE_NONE)
-		.SetFrontFace(VK_FRONT_FACE_CLOCKWISE)
-		.SetPolygonMode(VK_POLYGON_MODE_FILL)
-		.SetDepthTest(VK_FALSE, VK_FALSE, VK_COMPARE_OP_NEVER)
+		.SetShader(compShader)
+		.SetShaderSpecialization(0, 0, sizeof(uint32_t), &mipCount)
 		.Build(context, pipeline);
 
+	// -- One View per Mip covering all Faces --
+	for (uint32_t mipIdx{}; mipIdx < mipCount; ++mipIdx)
+		outImage.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D_ARRAY, mipIdx, 1, 0, 6);
+
 	// -- Allocate & Write Descriptor Set --
 	DescriptorSet DS{};
-	DS = context.descriptorPool->AllocateSets(context, DSL, 1, "Render To CubeMap DS").front();
+	DS = context.descriptorPool->AllocateSets(context, DSL, 1, "Dispatch To CubeMap DS").front();
 	DescriptorSetWriter writer{};
 	writer
 		.AddImageInfo(inView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, inSampler)
 		.WriteImages(DS, 0)
 		.Execute(context);
+	for (uint32_t mipIdx{}; mipIdx < mipCount; ++mipIdx)
+		writer.AddImageInfo(outImage.GetView(mipIdx), VK_IMAGE_LAYOUT_GENERAL);
+	writer
+		.WriteImages(DS, 1)
+		.Execute(context);
 
-	// -- CPU Views per Face --
-	glm::vec3 eye = glm::vec3(0.f);
-	glm::mat4 captureViews[6] = {
-		glm::lookAt(eye, eye + glm::vec3( 1.f,  0.f,  0.f), glm::vec3(0.f, -1.f,  0.f)), // +X
-		glm::lookAt(eye, eye + glm::vec3(-1.f,  0.f,  0.f), glm::vec3(0.f, -1.f,  0.f)), // -X
-		glm::lookAt(eye, eye + glm::vec3( 0.f, -1.f,  0.f), glm::vec3(0.f,  0.f, -1.f)), // -Y
-		glm::lookAt(eye, eye + glm::vec3( 0.f,  1.f,  0.f), glm::vec3(0.f,  0.f,  1.f)), // +Y
-		glm::lookAt(eye, eye + glm::vec3( 0.f,  0.f,  1.f), glm::vec3(0.f, -1.f,  0.f)), // +Z
-		glm::lookAt(eye, eye + glm::vec3( 0.f,  0.f, -1.f), glm::vec3(0.f, -1.f,  0.f)), // -Z
-	};
-	glm::mat4 captureProj = glm::perspective(glm::radians(90.f), 1.f, 0.1f, 10.f);
-	captureProj[1][1] *= -1.f;
-
-	// -- Render --
+	// -- Dispatch --
 	CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
 	cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 	{
-		RenderDebugger::BeginDebugLabel(cmd, "Render To CubeMap", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+		POMPEII_GPU_BEGIN(cmd, "Dispatch To CubeMap", glm::vec4(0.6f, 0.2f, 0.8f, 1));
 		const VkCommandBuffer& vCmd = cmd.GetHandle();
 
-		// -- Ready outImage to be rendered to --
+		// -- Ready outImage to be written to --
 		outImage.TransitionLayout(cmd,
-			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_IMAGE_LAYOUT_GENERAL,
 			VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_NONE,
-			VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
 			0, outImage.GetMipLevels(), 0, outImage.GetLayerCount());
 
-		// -- Render --
-		for (uint32_t layerIdx{}; layerIdx < outViews.size(); ++layerIdx)
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.GetHandle());
+		vkCmdBindDescriptorSets(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout.GetHandle(), 0, 1, &DS.GetHandle(), 0, nullptr);
+
+		// -- Mips don't depend on each other, every Dispatch writes all 6 faces of one --
+		for (uint32_t mipIdx{}; mipIdx < mipCount; ++mipIdx)
 		{
-			for (uint32_t mipIdx{}; mipIdx < outViews[layerIdx].size(); ++mipIdx)
+			PC pc
 			{
-				// -- Setup Attachment --
-				VkRenderingAttachmentInfo colorAttachment{};
-				colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-				colorAttachment.imageView = outViews[layerIdx][mipIdx].GetHandle();
-				colorAttachment.imageLayout = outImage.GetCurrentLayout();
-				colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-				colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-				colorAttachment.clearValue.color = { {0.f, 0.f, 0.f, 1.0f} };
-
-				// -- Rendering Info --
-				uint32_t mip_size = std::max(1u, size >> mipIdx);
-				VkRenderingInfo renderingInfo{};
-				renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-				renderingInfo.renderArea.offset = {.x = 0, .y = 0};
-				renderingInfo.renderArea.extent = {.width = mip_size, .height = mip_size };
-				renderingInfo.layerCount = 1;
-				renderingInfo.colorAttachmentCount = 1;
-				renderingInfo.pColorAttachments = &colorAttachment;
-
-				// -- Begin Rendering --
-				vkCmdBeginRendering(vCmd, &renderingInfo);
-				{
-					// -- Set Dynamic Viewport --
-					VkViewport viewport{};
-					viewport.x = 0.0f;
-					viewport.y = 0.0f;
-					viewport.width = static_cast<float>(mip_size);
-					viewport.height = static_cast<float>(mip_size);
-					viewport.minDepth = 0.0f;
-					viewport.maxDepth = 1.0f;
-					vkCmdSetViewport(vCmd, 0, 1, &viewport);
-
-					// -- Set Dynamic Scissors --
-					VkRect2D scissor{};
-					scissor.offset = { .x = 0, .y = 0 };
-					scissor.extent = { .width = mip_size, .height = mip_size };
-					vkCmdSetScissor(vCmd, 0, 1, &scissor);
-
-					// -- Bind Pipeline --
-					vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.GetHandle());
-
-					// -- Bind Descriptors --
-					vkCmdBindDescriptorSets(vCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout.GetHandle(), 0, 1, &DS.GetHandle(), 0, nullptr);
-
-					// -- Push Constants --
-					PC pc
-					{
-						.view = captureViews[layerIdx],
-						.projection = captureProj
-					};
-					float roughness = static_cast<float>(mipIdx) / static_cast<float>(outViews[layerIdx].size() - 1);
-					vkCmdPushConstants(vCmd, pipelineLayout.GetHandle(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PC), &pc);
-					vkCmdPushConstants(vCmd, pipelineLayout.GetHandle(), VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(PC), sizeof(float), &roughness);
-
-					// -- Draw --
-					vkCmdDraw(vCmd, 36, 1, 0, 0);
-				}
-				vkCmdEndRendering(vCmd);
-			}
+				.mip = mipIdx,
+				.faceSize = std::max(1u, size >> mipIdx),
+				.roughness = mipCount > 1 ? static_cast<float>(mipIdx) / static_cast<float>(mipCount - 1) : 0.f
+			};
+			vkCmdPushConstants(vCmd, pipelineLayout.GetHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PC), &pc);
+
+			const uint32_t groupCount = (pc.faceSize + 7) / 8;
+			vkCmdDispatch(vCmd, groupCount, groupCount, 6);
 		}
 
 		// -- Ready outImage to be read from --
 		outImage.TransitionLayout(cmd,
 			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-			VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-			VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
 			0, outImage.GetMipLevels(), 0, outImage.GetLayerCount());
 
-		RenderDebugger::EndDebugLabel(cmd);
+		POMPEII_GPU_END(cmd);
 	}
 	cmd.End();
 	cmd.Submit(context.device.GetGraphicQueue(), true);
 	cmd.Free(context.device);
 
 	// -- Cleanup --
+	outImage.DestroyAllViews(context);
 	pipeline.Destroy(context);
-	fragShader.Destroy(context);
-	vertShader.Destroy(context);
+	compShader.Destroy(context);
 	pipelineLayout.Destroy(context);
 	DSL.Destroy(context);
 }
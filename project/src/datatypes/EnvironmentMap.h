@@ -5,6 +5,7 @@
 #include <string>
 
 // -- Pompeii Includes --
+#include "Buffer.h"
 #include "Image.h"
 #include "Sampler.h"
 
@@ -28,6 +29,8 @@ namespace pompeii
 		EnvironmentMap& CreateSampler(const Context& context);
 		EnvironmentMap& CreateSkyboxCube(const Context& context, const std::string& path, uint32_t size = 1024);
 		EnvironmentMap& CreateDiffIrradianceMap(const Context& context, uint32_t size = 64);
+		// L2 spherical harmonics of the skybox, projected from the mip whose faces are closest to sampleSize
+		EnvironmentMap& CreateDiffIrradianceSH(const Context& context, uint32_t sampleSize = 64);
 		EnvironmentMap& CreateSpecIrradianceMap(const Context& context, uint32_t size = 128);
 		EnvironmentMap& CreateBRDFLut(const Context& context, uint32_t size = 512);
 
@@ -37,20 +40,24 @@ namespace pompeii
 		const Sampler& GetSampler() const;
 		const Image& GetSkybox() const;
 		const Image& GetDiffuseIrradianceMap() const;
+		const Buffer& GetDiffuseIrradianceSH() const;
 		const Image& GetSpecularIrradianceMap() const;
 		const Image& GetBRDFLut() const;
 
 	private:
 		// -- Helpers --
-		void RenderToCubeMap(const Context& context,
-							 const std::string& vert, const std::string& frag,
-							 Image& inImage, const ImageView& inView, const Sampler& inSampler,
-							 Image& outImage, std::array<std::vector<ImageView>, 6>& outViews, uint32_t size);
+		// Writes the first mipCount mips of outImage, all six faces of a mip in one dispatch
+		void DispatchToCubeMap(const Context& context, const std::string& comp,
+							   const ImageView& inView, const Sampler& inSampler,
+							   Image& outImage, uint32_t mipCount, uint32_t size);
 
 		// -- Data --
+		std::string m_SourcePath{};
+		uint64_t m_SkyboxKey{};
 		Sampler m_Sampler{};
 		Image m_Skybox;
 		Image m_DiffuseIrradiance;
+		Buffer m_DiffuseIrradianceSH;
 		Image m_SpecularIrradiance;
 		Image m_BRDFLut;
 	};
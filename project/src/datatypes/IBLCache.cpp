@@ -0,0 +1,212 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "IBLCache.h"
+#include "Context.h"
+#include "CommandBuffer.h"
+#include "ConsoleTextSettings.h"
+#include "Image.h"
+#include "UploadBatch.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  IBLCache
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Cache
+//--------------------------------------------------
+std::string pompeii::IBLCache::GetCachePath(const std::string& sourcePath, const std::string& name, uint32_t size)
+{
+	return sourcePath + "." + name + "_" + std::to_string(size) + ".pibl";
+}
+uint64_t pompeii::IBLCache::HashFile(const std::string& path, uint64_t seed)
+{
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+		throw std::runtime_error("Failed to open file for hashing: " + path);
+
+	// -- FNV-1a, fast enough to run every startup and good enough to spot an edited file --
+	uint64_t hash = seed;
+	std::vector<char> chunk(1 << 20);
+	while (file)
+	{
+		file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+		const std::streamsize count = file.gcount();
+		for (std::streamsize idx{}; idx < count; ++idx)
+		{
+			hash ^= static_cast<uint8_t>(chunk[idx]);
+			hash *= FNV_PRIME;
+		}
+	}
+	return hash;
+}
+
+void pompeii::IBLCache::Write(const Context& context, const std::string& cachePath, uint64_t key, Image& image)
+{
+	const uint64_t dataSize = GetDataSize(image);
+	const VkExtent2D extent = image.GetExtent2D();
+	const uint32_t texelSize = GetTexelSize(image.GetFormat());
+
+	// -- Read Back, one region per mip with all layers packed after each other --
+	Buffer readback{};
+	BufferAllocator allocator{};
+	allocator
+		.SetDebugName("Readback Buffer (IBL Cache)")
+		.SetUsage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+		.HostAccess(true)
+		.SetSize(static_cast<uint32_t>(dataSize))
+		.Allocate(context, readback);
+
+	std::vector<VkBufferImageCopy> vRegions{};
+	VkDeviceSize offset{};
+	for (uint32_t mip{}; mip < image.GetMipLevels(); ++mip)
+	{
+		const uint32_t width = std::max(1u, extent.width >> mip);
+		const uint32_t height = std::max(1u, extent.height >> mip);
+		VkBufferImageCopy& region = vRegions.emplace_back();
+		region.bufferOffset = offset;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, image.GetLayerCount() };
+		region.imageExtent = { width, height, 1 };
+		offset += static_cast<VkDeviceSize>(width) * height * texelSize * image.GetLayerCount();
+	}
+
+	CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
+	cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	{
+		image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+			VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			0, image.GetMipLevels(), 0, image.GetLayerCount());
+		vkCmdCopyImageToBuffer(cmd.GetHandle(), image.GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			readback.GetHandle(), static_cast<uint32_t>(vRegions.size()), vRegions.data());
+		image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			VK_ACCESS_2_SHADER_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+			0, image.GetMipLevels(), 0, image.GetLayerCount());
+	}
+	cmd.End();
+	cmd.Submit(context.device.GetGraphicQueue(), true);
+	cmd.Free(context.device);
+
+	std::vector<char> vData(dataSize);
+	vmaCopyAllocationToMemory(context.allocator, readback.GetMemoryHandle(), 0, vData.data(), dataSize);
+	readback.Destroy(context);
+
+	// -- Write through a temporary so a partial file never looks valid --
+	IBLCacheHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.format = image.GetFormat();
+	header.width = extent.width;
+	header.height = extent.height;
+	header.mipLevels = image.GetMipLevels();
+	header.layerCount = image.GetLayerCount();
+	header.dataSize = dataSize;
+
+	const std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(IBLCacheHeader));
+		file.write(vData.data(), static_cast<std::streamsize>(vData.size()));
+		if (file)
+		{
+			file.close();
+			std::error_code ec;
+			std::filesystem::rename(tempPath, cachePath, ec);
+			if (!ec)
+				return;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::remove(tempPath, ec);
+	std::cout << WARNING_TXT << "Failed to write IBL Cache: " << cachePath << "\n" << RESET_TXT;
+}
+bool pompeii::IBLCache::Read(const Context& context, const std::string& cachePath, uint64_t key, Image& image)
+{
+	std::ifstream file{ cachePath, std::ios::binary };
+	if (!file)
+		return false;
+
+	// -- Validate, anything that doesn't match the image is recomputed --
+	IBLCacheHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(IBLCacheHeader));
+	const VkExtent2D extent = image.GetExtent2D();
+	const bool valid = file &&
+		std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+		header.version == VERSION &&
+		header.key == key &&
+		header.format == image.GetFormat() &&
+		header.width == extent.width &&
+		header.height == extent.height &&
+		header.mipLevels == image.GetMipLevels() &&
+		header.layerCount == image.GetLayerCount() &&
+		header.dataSize == GetDataSize(image);
+	if (!valid)
+		return false;
+
+	std::vector<char> vData(header.dataSize);
+	file.read(vData.data(), static_cast<std::streamsize>(vData.size()));
+	if (!file)
+		return false;
+
+	// -- Upload, the data is already laid out the way the copy regions expect --
+	std::vector<VkBufferImageCopy> vRegions{};
+	const uint32_t texelSize = GetTexelSize(header.format);
+	VkDeviceSize offset{};
+	for (uint32_t mip{}; mip < header.mipLevels; ++mip)
+	{
+		const uint32_t width = std::max(1u, header.width >> mip);
+		const uint32_t height = std::max(1u, header.height >> mip);
+		VkBufferImageCopy& region = vRegions.emplace_back();
+		region.bufferOffset = offset;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, header.layerCount };
+		region.imageExtent = { width, height, 1 };
+		offset += static_cast<VkDeviceSize>(width) * height * texelSize * header.layerCount;
+	}
+
+	UploadBatch batch{};
+	batch.AddImageCopy(context, image, vData.data(), header.dataSize, vRegions, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false);
+	batch.Submit(context);
+	return true;
+}
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+uint32_t pompeii::IBLCache::GetTexelSize(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R32G32B32A32_SFLOAT:		return 16;
+	case VK_FORMAT_R32G32_SFLOAT:
+	case VK_FORMAT_R16G16B16A16_SFLOAT:		return 8;
+	case VK_FORMAT_R16G16_SFLOAT:
+	case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+	case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+	case VK_FORMAT_R8G8B8A8_UNORM:			return 4;
+	default:
+		throw std::runtime_error("IBL Cache does not support this format!");
+	}
+}
+uint64_t pompeii::IBLCache::GetDataSize(const Image& image)
+{
+	const VkExtent2D extent = image.GetExtent2D();
+	const uint32_t texelSize = GetTexelSize(image.GetFormat());
+	uint64_t size{};
+	for (uint32_t mip{}; mip < image.GetMipLevels(); ++mip)
+	{
+		const uint64_t width = std::max(1u, extent.width >> mip);
+		const uint64_t height = std::max(1u, extent.height >> mip);
+		size += width * height * texelSize * image.GetLayerCount();
+	}
+	return size;
+}
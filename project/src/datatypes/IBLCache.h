@@ -0,0 +1,68 @@
+#ifndef IBL_CACHE_H
+#define IBL_CACHE_H
+
+// -- Vulkan Includes --
+#include <vulkan/vulkan.h>
+
+// -- Standard Library --
+#include <cstdint>
+#include <string>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class Image;
+	struct Context;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  IBLCache
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct IBLCacheHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		VkFormat format;
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipLevels;
+		uint32_t layerCount;
+		uint32_t _padding;
+		uint64_t dataSize;
+	};
+
+	class IBLCache final
+	{
+	public:
+		//--------------------------------------------------
+		//    Cache
+		//--------------------------------------------------
+		static std::string GetCachePath(const std::string& sourcePath, const std::string& name, uint32_t size);
+		// Hash of the file contents, chain calls through seed to key a result on several inputs
+		static uint64_t HashFile(const std::string& path, uint64_t seed = FNV_OFFSET);
+
+		// Reads back every mip and layer of image, which has to be in SHADER_READ_ONLY_OPTIMAL and allow TRANSFER_SRC
+		static void Write(const Context& context, const std::string& cachePath, uint64_t key, Image& image);
+		// Uploads the cached mips into image when the key and image layout match, leaving it in SHADER_READ_ONLY_OPTIMAL
+		static bool Read(const Context& context, const std::string& cachePath, uint64_t key, Image& image);
+
+		static constexpr uint64_t FNV_OFFSET{ 0xcbf29ce484222325ull };
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		static uint32_t GetTexelSize(VkFormat format);
+		static uint64_t GetDataSize(const Image& image);
+
+		// -- Format --
+		static constexpr char MAGIC[4]{ 'P', 'I', 'B', 'L' };
+		static constexpr uint32_t VERSION{ 1 };
+		static constexpr uint64_t FNV_PRIME{ 0x100000001b3ull };
+	};
+}
+
+#endif // IBL_CACHE_H
@@ -1,9 +1,15 @@
 // -- Standard Library --
+#include <cmath>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
 
 // -- Pompeii Includes --
 #include "Material.h"
 
+// -- Math Includes --
+#include "glm/gtc/packing.hpp"
+
 // -- Texture Includes --
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -20,6 +26,35 @@ pompeii::Texture::Texture(const std::string& path, VkFormat format, bool isHDR)
 {
 	m_Format = format;
 	m_Path = path;
+	m_pPixels = nullptr;
+
+	// -- Fall back to uncompressed when the device can't sample BCn --
+	if (TextureTranscoder::IsBlockCompressed(m_Format) && !m_BlockCompressionSupported)
+		m_Format = TextureTranscoder::GetUncompressedFallback(m_Format);
+
+	// -- Pre-Made Containers --
+	if (TextureTranscoder::IsContainerPath(path))
+	{
+		LoadContainer(path);
+		return;
+	}
+
+	// -- Transcode to a cached BCn file on first use --
+	if (!isHDR && TextureTranscoder::IsBlockCompressed(m_Format))
+	{
+		const std::string cachePath = TextureTranscoder::GetCachePath(path, m_Format);
+		if (!TextureTranscoder::IsCacheValid(path, cachePath))
+			TextureTranscoder::Transcode(path, cachePath, m_Format);
+		LoadContainer(cachePath);
+		return;
+	}
+
+	// -- HDR straight to a compact format, the float image is never held in full --
+	if (isHDR && (m_Format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 || m_Format == VK_FORMAT_R16G16B16A16_SFLOAT))
+	{
+		LoadPackedHDR(path);
+		return;
+	}
 
 	m_pPixels = isHDR ? static_cast<void*>(stbi_loadf(path.c_str(), &m_Width, &m_Height, &m_Channels, STBI_rgb_alpha)) :
 						static_cast<void*>(stbi_load(path.c_str(), &m_Width, &m_Height, &m_Channels, STBI_rgb_alpha));
@@ -42,6 +77,9 @@ pompeii::Texture::Texture(Texture&& other) noexcept
 	m_Channels = other.m_Channels;
 	m_Format = other.m_Format;
 	other.m_Format = VK_FORMAT_UNDEFINED;
+	m_vContainerData = std::move(other.m_vContainerData);
+	m_vMips = std::move(other.m_vMips);
+	m_Path = std::move(other.m_Path);
 }
 pompeii::Texture& pompeii::Texture::operator=(Texture&& other) noexcept
 {
@@ -55,6 +93,9 @@ pompeii::Texture& pompeii::Texture::operator=(Texture&& other) noexcept
 	m_Channels = other.m_Channels;
 	m_Format = other.m_Format;
 	other.m_Format = VK_FORMAT_UNDEFINED;
+	m_vContainerData = std::move(other.m_vContainerData);
+	m_vMips = std::move(other.m_vMips);
+	m_Path = std::move(other.m_Path);
 	return *this;
 }
 
@@ -65,17 +106,193 @@ void pompeii::Texture::FreePixels()
 		stbi_image_free(m_pPixels);
 		m_pPixels = nullptr;
 	}
+	m_vContainerData.clear();
+	m_vContainerData.shrink_to_fit();
 }
 
 //--------------------------------------------------
 //    Accessors & Mutators
 //--------------------------------------------------
-void* pompeii::Texture::GetPixels()			const {	return m_pPixels; }
+void* pompeii::Texture::GetPixels()			const
+{
+	if (m_DataType == TextureDataType::CONTAINER || m_DataType == TextureDataType::PACKED_HDR)
+		return const_cast<uint8_t*>(m_vContainerData.data());
+	return m_pPixels;
+}
 uint32_t pompeii::Texture::GetMemorySize()	const
 {
+	if (m_DataType == TextureDataType::CONTAINER || m_DataType == TextureDataType::PACKED_HDR)
+		return static_cast<uint32_t>(m_vContainerData.size());
 	const int pixelSize = (m_DataType == TextureDataType::FLOAT32) ? sizeof(float) : sizeof(stbi_uc);
 	return m_Width * m_Height * m_Channels * pixelSize;
 }
 glm::ivec2 pompeii::Texture::GetExtent()		const { return {m_Width, m_Height}; }
 VkFormat pompeii::Texture::GetFormat()			const { return m_Format; }
 const std::string& pompeii::Texture::GetPath()	const { return m_Path; }
+
+bool pompeii::Texture::IsBlockCompressed()						const { return TextureTranscoder::IsBlockCompressed(m_Format); }
+bool pompeii::Texture::HasPrecomputedMips()						const { return !m_vMips.empty(); }
+uint32_t pompeii::Texture::GetMipCount()						const { return m_vMips.empty() ? 1 : static_cast<uint32_t>(m_vMips.size()); }
+const pompeii::TextureMip& pompeii::Texture::GetMip(uint32_t mip) const { return m_vMips.at(mip); }
+
+//--------------------------------------------------
+//    Block Compression
+//--------------------------------------------------
+void pompeii::Texture::SetBlockCompressionSupported(bool supported) { m_BlockCompressionSupported = supported; }
+bool pompeii::Texture::IsBlockCompressionSupported() { return m_BlockCompressionSupported; }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::Texture::LoadContainer(const std::string& path)
+{
+	TextureFileData data = TextureTranscoder::ReadContainer(path);
+	if (TextureTranscoder::IsBlockCompressed(data.format) && !m_BlockCompressionSupported)
+		throw std::runtime_error("Block compressed Texture is not supported by the device: " + path);
+
+	// -- Containers often store UNORM, honor the requested color space --
+	m_Format = TextureTranscoder::IsSRGB(m_Format) ? TextureTranscoder::ToSRGB(data.format) : data.format;
+	m_Width = static_cast<int>(data.width);
+	m_Height = static_cast<int>(data.height);
+	m_Channels = 4;
+	m_DataType = TextureDataType::CONTAINER;
+	m_vContainerData = std::move(data.vData);
+	m_vMips = std::move(data.vMips);
+}
+void pompeii::Texture::LoadPackedHDR(const std::string& path)
+{
+	m_Channels = 4;
+	m_DataType = TextureDataType::PACKED_HDR;
+	const uint32_t texelSize = m_Format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 ? 4 : 8;
+
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+		throw std::runtime_error("Failed to load Texture: " + path);
+
+	// -- Anything that isn't Radiance RGBE is decoded by stb and packed afterwards --
+	std::string line{};
+	std::getline(file, line);
+	if (line != "#?RADIANCE" && line != "#?RGBE")
+	{
+		file.close();
+		float* pPixels = stbi_loadf(path.c_str(), &m_Width, &m_Height, &m_Channels, STBI_rgb_alpha);
+		m_Channels = 4;
+		if (!pPixels)
+			throw std::runtime_error("Failed to load Texture: " + path);
+
+		m_vContainerData.resize(static_cast<size_t>(m_Width) * m_Height * texelSize);
+		for (uint32_t row{}; row < static_cast<uint32_t>(m_Height); ++row)
+			PackHDRRow(pPixels + static_cast<size_t>(row) * m_Width * 4, 4, row);
+		stbi_image_free(pPixels);
+		return;
+	}
+
+	// -- Header, ends at the first empty line --
+	while (std::getline(file, line) && !line.empty() && line != "\r")
+	{
+		if (line.starts_with("FORMAT=") && !line.starts_with("FORMAT=32-bit_rle_rgbe"))
+			throw std::runtime_error("Unsupported HDR format, only RGBE is supported: " + path);
+	}
+
+	// -- Resolution, only the standard top to bottom, left to right orientation --
+	std::getline(file, line);
+	std::istringstream resolution{ line };
+	std::string yAxis{};
+	std::string xAxis{};
+	resolution >> yAxis >> m_Height >> xAxis >> m_Width;
+	if (!resolution || yAxis != "-Y" || xAxis != "+X" || m_Width <= 0 || m_Height <= 0)
+		throw std::runtime_error("Unsupported HDR orientation: " + path);
+
+	// -- Files either encode every scanline or none, decided by the first one --
+	const uint32_t width = static_cast<uint32_t>(m_Width);
+	uint8_t head[4]{};
+	const std::streampos dataStart = file.tellg();
+	file.read(reinterpret_cast<char*>(head), sizeof(head));
+	file.seekg(dataStart);
+	const bool flat = width < 8 || width > 0x7fff || head[0] != 2 || head[1] != 2 || (head[2] & 0x80);
+
+	// -- Decode and Pack one Scanline at a time --
+	m_vContainerData.resize(static_cast<size_t>(m_Width) * m_Height * texelSize);
+	std::vector<uint8_t> vScanline(width * 4);
+	std::vector<float> vRow(width * 3);
+	for (uint32_t row{}; row < static_cast<uint32_t>(m_Height); ++row)
+	{
+		if (!ReadRGBEScanline(file, vScanline.data(), width, flat))
+			throw std::runtime_error("Corrupt HDR scanline in: " + path);
+
+		for (uint32_t x{}; x < width; ++x)
+		{
+			const uint8_t* pRGBE = &vScanline[x * 4];
+			const float scale = pRGBE[3] ? std::ldexp(1.f, static_cast<int>(pRGBE[3]) - (128 + 8)) : 0.f;
+			vRow[x * 3 + 0] = pRGBE[0] * scale;
+			vRow[x * 3 + 1] = pRGBE[1] * scale;
+			vRow[x * 3 + 2] = pRGBE[2] * scale;
+		}
+		PackHDRRow(vRow.data(), 3, row);
+	}
+}
+void pompeii::Texture::PackHDRRow(const float* pRow, uint32_t channelCount, uint32_t row)
+{
+	const uint32_t width = static_cast<uint32_t>(m_Width);
+	if (m_Format == VK_FORMAT_E5B9G9R9_UFLOAT_PACK32)
+	{
+		uint32_t* pDst = reinterpret_cast<uint32_t*>(m_vContainerData.data()) + static_cast<size_t>(row) * width;
+		for (uint32_t x{}; x < width; ++x)
+		{
+			const float* pTexel = pRow + x * channelCount;
+			pDst[x] = glm::packF3x9_E1x5(glm::vec3(pTexel[0], pTexel[1], pTexel[2]));
+		}
+	}
+	else
+	{
+		// -- Clamped, the sun in most captures is brighter than half floats reach --
+		constexpr float maxHalf = 65504.f;
+		uint64_t* pDst = reinterpret_cast<uint64_t*>(m_vContainerData.data()) + static_cast<size_t>(row) * width;
+		for (uint32_t x{}; x < width; ++x)
+		{
+			const float* pTexel = pRow + x * channelCount;
+			const glm::vec3 color = glm::min(glm::vec3(pTexel[0], pTexel[1], pTexel[2]), glm::vec3(maxHalf));
+			pDst[x] = glm::packHalf4x16(glm::vec4(color, 1.f));
+		}
+	}
+}
+bool pompeii::Texture::ReadRGBEScanline(std::istream& file, uint8_t* pScanline, uint32_t width, bool flat)
+{
+	if (flat)
+	{
+		file.read(reinterpret_cast<char*>(pScanline), static_cast<std::streamsize>(width) * 4);
+		return static_cast<bool>(file);
+	}
+
+	uint8_t head[4]{};
+	file.read(reinterpret_cast<char*>(head), sizeof(head));
+	if (!file || head[0] != 2 || head[1] != 2 || static_cast<uint32_t>((head[2] << 8) | head[3]) != width)
+		return false;
+
+	// -- Run Length Encoded, one channel after the other --
+	for (uint32_t channel{}; channel < 4; ++channel)
+	{
+		uint32_t x{};
+		while (x < width)
+		{
+			uint32_t count = static_cast<uint8_t>(file.get());
+			if (count > 128)
+			{
+				count -= 128;
+				const uint8_t value = static_cast<uint8_t>(file.get());
+				if (x + count > width)
+					return false;
+				for (; count > 0; --count)
+					pScanline[(x++) * 4 + channel] = value;
+			}
+			else
+			{
+				if (count == 0 || x + count > width)
+					return false;
+				for (; count > 0; --count)
+					pScanline[(x++) * 4 + channel] = static_cast<uint8_t>(file.get());
+			}
+		}
+	}
+	return static_cast<bool>(file);
+}
@@ -5,7 +5,12 @@
 #include <vulkan/vulkan.h>
 
 // -- Standard Library --
+#include <istream>
 #include <string>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "TextureTranscoder.h"
 
 // -- Math Includes --
 #include "glm/glm.hpp"
@@ -22,6 +27,7 @@ namespace pompeii
 		//--------------------------------------------------
 		//    Constructor & Destructor
 		//--------------------------------------------------
+		// HDR loaded as E5B9G9R9_UFLOAT_PACK32 or R16G16B16A16_SFLOAT is packed row by row while decoding
 		explicit Texture(const std::string& path, VkFormat format, bool isHDR = false);
 		~Texture();
 		Texture(const Texture& other) = delete;
@@ -39,8 +45,24 @@ namespace pompeii
 		VkFormat GetFormat() const;
 		const std::string& GetPath() const;
 
+		bool IsBlockCompressed() const;
+		bool HasPrecomputedMips() const;
+		uint32_t GetMipCount() const;
+		const TextureMip& GetMip(uint32_t mip) const;
+
+		//--------------------------------------------------
+		//    Block Compression
+		//--------------------------------------------------
+		static void SetBlockCompressionSupported(bool supported);
+		static bool IsBlockCompressionSupported();
+
 	private:
-		enum class TextureDataType { UINT8, FLOAT32 };
+		void LoadContainer(const std::string& path);
+		void LoadPackedHDR(const std::string& path);
+		void PackHDRRow(const float* pRow, uint32_t channelCount, uint32_t row);
+		static bool ReadRGBEScanline(std::istream& file, uint8_t* pScanline, uint32_t width, bool flat);
+
+		enum class TextureDataType { UINT8, FLOAT32, CONTAINER, PACKED_HDR };
 		TextureDataType m_DataType;
 
 		void* m_pPixels;
@@ -49,7 +71,13 @@ namespace pompeii
 		int m_Channels;
 		VkFormat m_Format;
 
+		// -- Owned Data, containers and packed HDR, mips are stored tightly packed largest first --
+		std::vector<uint8_t> m_vContainerData{};
+		std::vector<TextureMip> m_vMips{};
+
 		std::string m_Path{};
+
+		inline static bool m_BlockCompressionSupported{ false };
 	};
 
 
@@ -1,61 +1,41 @@
 // -- Pompeii Includes --
 #include "Mesh.h"
-#include "CommandBuffer.h"
 #include "RenderDebugger.h"
+#include "TextureRegistry.h"
+#include "MeshOptimizer.h"
+#include "ConsoleTextSettings.h"
 
 // -- Model Loading --
 #include <assimp/postprocess.h>
 
+// -- Math Includes --
+#include <glm/gtc/packing.hpp>
+
 // -- Standard Library --
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+
+namespace
+{
+	glm::vec2 OctahedralEncode(glm::vec3 n)
+	{
+		const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+		if (l1 <= 0.f)
+			return glm::vec2{ 0.f };
+
+		n /= l1;
+		if (n.z >= 0.f)
+			return glm::vec2{ n.x, n.y };
+		const glm::vec2 signs{ n.x >= 0.f ? 1.f : -1.f, n.y >= 0.f ? 1.f : -1.f };
+		return (1.f - glm::abs(glm::vec2{ n.y, n.x })) * signs;
+	}
+}
 
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //? ~~	  Vertex
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-VkVertexInputBindingDescription pompeii::Vertex::GetBindingDescription()
-{
-	VkVertexInputBindingDescription bindingDescription{};
-	bindingDescription.binding = 0;
-	bindingDescription.stride = sizeof(Vertex);
-	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-	return bindingDescription;
-}
-std::vector<VkVertexInputAttributeDescription> pompeii::Vertex::GetAttributeDescriptions()
-{
-	std::vector<VkVertexInputAttributeDescription> attributeDescriptions(6);
-	attributeDescriptions[0].binding = 0;
-	attributeDescriptions[0].location = 0;
-	attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[0].offset = offsetof(Vertex, position);
-
-	attributeDescriptions[1].binding = 0;
-	attributeDescriptions[1].location = 1;
-	attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[1].offset = offsetof(Vertex, normal);
-
-	attributeDescriptions[2].binding = 0;
-	attributeDescriptions[2].location = 2;
-	attributeDescriptions[2].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[2].offset = offsetof(Vertex, tangent);
-
-	attributeDescriptions[3].binding = 0;
-	attributeDescriptions[3].location = 3;
-	attributeDescriptions[3].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[3].offset = offsetof(Vertex, bitangent);
-
-	attributeDescriptions[4].binding = 0;
-	attributeDescriptions[4].location = 4;
-	attributeDescriptions[4].format = VK_FORMAT_R32G32B32_SFLOAT;
-	attributeDescriptions[4].offset = offsetof(Vertex, color);
-
-	attributeDescriptions[5].binding = 0;
-	attributeDescriptions[5].location = 5;
-	attributeDescriptions[5].format = VK_FORMAT_R32G32_SFLOAT;
-	attributeDescriptions[5].offset = offsetof(Vertex, texCoord);
-
-	return attributeDescriptions;
-}
 bool pompeii::Vertex::operator==(const Vertex& other) const
 {
 	return position == other.position &&
@@ -67,6 +47,48 @@ bool pompeii::Vertex::operator==(const Vertex& other) const
 }
 
 
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Packed Vertex
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::PackedVertex pompeii::PackedVertex::Pack(const Vertex& vertex, const glm::vec3& positionOffset, const glm::vec3& positionScale)
+{
+	// -- Bitangent is rebuilt in the shader from cross(normal, tangent) and this sign --
+	const float bitangentSign = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.f ? -1.f : 1.f;
+	const glm::vec3 localPosition = glm::clamp((vertex.position - positionOffset) / positionScale, -1.f, 1.f);
+
+	PackedVertex packed{};
+	packed.position = glm::packSnorm<int16_t>(glm::vec4{ localPosition, bitangentSign });
+	packed.normal = glm::packSnorm<int16_t>(OctahedralEncode(vertex.normal));
+	packed.tangent = glm::packSnorm<int16_t>(OctahedralEncode(vertex.tangent));
+	packed.texCoord = glm::packHalf(vertex.texCoord);
+	packed.color = glm::packUnorm<uint8_t>(glm::vec4{ glm::clamp(vertex.color, 0.f, 1.f), 1.f });
+	return packed;
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  SubMesh
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+glm::vec4 pompeii::SubMesh::GetPositionOffset() const
+{
+	if (vertexCount == 0)
+		return glm::vec4{ 0.f };
+	return glm::vec4{ (aabb.min + aabb.max) * 0.5f, 0.f };
+}
+glm::vec4 pompeii::SubMesh::GetPositionScale() const
+{
+	// -- Flat sub meshes still need a non-zero scale to divide by --
+	if (vertexCount == 0)
+		return glm::vec4{ 1.f };
+	return glm::vec4{ glm::max((aabb.max - aabb.min) * 0.5f, glm::vec3{ 1e-6f }), 0.f };
+}
+glm::mat4 pompeii::SubMesh::GetDequantizeMatrix() const
+{
+	const glm::mat4 translation = glm::translate(glm::mat4{ 1.f }, glm::vec3{ GetPositionOffset() });
+	return glm::scale(translation, glm::vec3{ GetPositionScale() });
+}
+
+
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //? ~~	  Mesh
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -76,6 +98,15 @@ bool pompeii::Vertex::operator==(const Vertex& other) const
 //--------------------------------------------------
 pompeii::Mesh::Mesh(const std::string& path)
 {
+	// -- Warm Start --
+	if (m_Cache.Open(path))
+	{
+		m_Cache.Read(*this);
+		ResolveTextures();
+		return;
+	}
+
+	// -- Import --
 	Assimp::Importer importer;
 	const aiScene* pScene =
 		importer.ReadFile(path,
@@ -93,43 +124,76 @@ pompeii::Mesh::Mesh(const std::string& path)
 	}
 
 	ProcessNode(pScene->mRootNode, pScene);
+	BuildMeshlets();
+	BuildLods();
+	Optimize(path);
+
+	// -- Write Cache, with the mesh-local texture indices --
+	MeshCache::Write(path, *this);
+	ResolveTextures();
 }
 
 //--------------------------------------------------
 //    Helpers
 //--------------------------------------------------
-void pompeii::Mesh::Bind(CommandBuffer& cmdBuffer) const
-{
-	// -- Get Vulkan Command Buffer --
-	const VkCommandBuffer& vCmdBuffer = cmdBuffer.GetHandle();
-
-	// -- Bind Vertex Buffer --
-	VkBuffer vertexBuffers[] = { vertexBuffer.GetHandle() };
-	VkDeviceSize offsets[] = { 0 };
-	vkCmdBindVertexBuffers(vCmdBuffer, 0, 1, vertexBuffers, offsets);
-	RenderDebugger::InsertDebugLabel(cmdBuffer, "Bind Vertex Buffer", glm::vec4(0.6f, 1.f, 0.6f, 1.f));
-
-	// -- Bind Index Buffer --
-	vkCmdBindIndexBuffer(vCmdBuffer, indexBuffer.GetHandle(), 0, VK_INDEX_TYPE_UINT32);
-	RenderDebugger::InsertDebugLabel(cmdBuffer, "Bind Index Buffer", glm::vec4(1.f, 0.4f, 1.f, 1.f));
-}
 void pompeii::Mesh::AllocateResources(const Context& context)
 {
 	// -- Create Buffers --
 	CreateVertexBuffer(context);
 	CreateIndexBuffer(context);
-
-	// -- Build Image --
-	//CreateImages(context);
 }
 void pompeii::Mesh::Destroy(const Context& context)
 {
 	// -- Flush --
-	for (Image& image : images)
-		image.Destroy(context);
-	images.clear();
-	indexBuffer.Destroy(context);
-	vertexBuffer.Destroy(context);
+	context.geometryArena->FreeIndices(indexRange, m_UploadTicket);
+	context.geometryArena->FreeVertices(vertexRange, m_UploadTicket);
+	indexRange = {};
+	vertexRange = {};
+	m_Cache.Close();
+
+	for (uint32_t slot : m_vTextureSlots)
+		TextureRegistry::Release(slot);
+	m_vTextureSlots.clear();
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+std::span<const pompeii::Vertex> pompeii::Mesh::GetVertices() const
+{
+	if (m_Cache.IsOpen())
+		return m_Cache.GetSection<Vertex>(MeshCacheSection::Vertices);
+	return vertices;
+}
+std::span<const uint32_t> pompeii::Mesh::GetIndices() const
+{
+	if (m_Cache.IsOpen())
+		return m_Cache.GetSection<uint32_t>(MeshCacheSection::Indices);
+	return indices;
+}
+std::span<const pompeii::Meshlet> pompeii::Mesh::GetMeshlets() const
+{
+	if (m_Cache.IsOpen())
+		return m_Cache.GetSection<Meshlet>(MeshCacheSection::Meshlets);
+	return vMeshlets;
+}
+std::span<const pompeii::Meshlet> pompeii::Mesh::GetMeshlets(const SubMesh& subMesh) const
+{
+	return GetMeshlets().subspan(subMesh.meshletOffset, subMesh.meshletCount);
+}
+std::span<const pompeii::SubMeshLod> pompeii::Mesh::GetLods() const
+{
+	if (m_Cache.IsOpen())
+		return m_Cache.GetSection<SubMeshLod>(MeshCacheSection::Lods);
+	return vLods;
+}
+std::span<const pompeii::SubMeshLod> pompeii::Mesh::GetLods(const SubMesh& subMesh) const
+{
+	return GetLods().subspan(subMesh.lodOffset, subMesh.lodCount);
+}
+uint64_t pompeii::Mesh::GetUploadTicket() const
+{
+	return m_UploadTicket;
 }
 
 void pompeii::Mesh::ProcessNode(const aiNode* pNode, const aiScene* pScene, const glm::mat4& transform)
@@ -154,6 +218,7 @@ void pompeii::Mesh::ProcessMesh(const aiMesh* pMesh, const aiScene* pScene, glm:
 
 	// -- Process Vertices --
 	vSubMeshes.back().vertexOffset = static_cast<uint32_t>(vertices.size());
+	vSubMeshes.back().vertexCount = pMesh->mNumVertices;
 	for (uint32_t vIdx{}; vIdx < pMesh->mNumVertices; ++vIdx)
 	{
 		Vertex vertex{};
@@ -203,6 +268,21 @@ void pompeii::Mesh::ProcessMesh(const aiMesh* pMesh, const aiScene* pScene, glm:
 	}
 	vSubMeshes.back().indexCount = static_cast<uint32_t>(indices.size()) - vSubMeshes.back().indexOffset;
 
+	// -- Texture Density, used to pick which mips get streamed in --
+	float surfaceArea{};
+	float texCoordArea{};
+	for (uint32_t iIdx{ vSubMeshes.back().indexOffset }; iIdx + 2 < indices.size(); iIdx += 3)
+	{
+		const Vertex& v0 = vertices[vSubMeshes.back().vertexOffset + indices[iIdx]];
+		const Vertex& v1 = vertices[vSubMeshes.back().vertexOffset + indices[iIdx + 1]];
+		const Vertex& v2 = vertices[vSubMeshes.back().vertexOffset + indices[iIdx + 2]];
+		const glm::vec2 uvEdge0 = v1.texCoord - v0.texCoord;
+		const glm::vec2 uvEdge1 = v2.texCoord - v0.texCoord;
+		surfaceArea += glm::length(glm::cross(v1.position - v0.position, v2.position - v0.position));
+		texCoordArea += std::abs(uvEdge0.x * uvEdge1.y - uvEdge0.y * uvEdge1.x);
+	}
+	vSubMeshes.back().uvDensity = surfaceArea > 0.f ? std::sqrt(texCoordArea / surfaceArea) : 0.f;
+
 	// -- Process Materials --
 	const aiMaterial* material = pScene->mMaterials[pMesh->mMaterialIndex];
 	auto LoadMatTexture = [&](aiTextureType type, uint32_t& targetIdx, VkFormat format)
@@ -218,80 +298,208 @@ void pompeii::Mesh::ProcessMesh(const aiMesh* pMesh, const aiScene* pScene, glm:
 				targetIdx = it->second;
 
 				if (succeeded)
-					textures.emplace_back(fullPath, format);
+					m_vTextureRequests.emplace_back(fullPath, format);
 			}
 		};
 
 	// -- Diffuse --
 	auto& mat = vSubMeshes.back().material;
-	LoadMatTexture(aiTextureType_DIFFUSE, mat.albedoIdx, VK_FORMAT_R8G8B8A8_SRGB);
+	// Block compressed formats fall back to R8G8B8A8 when the device doesn't support them
+	LoadMatTexture(aiTextureType_DIFFUSE, mat.albedoIdx, VK_FORMAT_BC7_SRGB_BLOCK);
 
-	LoadMatTexture(aiTextureType_SPECULAR, mat.specularIdx, VK_FORMAT_R8G8B8A8_UNORM);
-	LoadMatTexture(aiTextureType_SHININESS, mat.shininessIdx, VK_FORMAT_R8G8B8A8_UNORM);
+	LoadMatTexture(aiTextureType_SPECULAR, mat.specularIdx, VK_FORMAT_BC7_UNORM_BLOCK);
+	LoadMatTexture(aiTextureType_SHININESS, mat.shininessIdx, VK_FORMAT_BC7_UNORM_BLOCK);
 
-	LoadMatTexture(aiTextureType_HEIGHT, mat.heightIdx, VK_FORMAT_R8G8B8A8_UNORM);
-	LoadMatTexture(aiTextureType_NORMALS, mat.normalIdx, VK_FORMAT_R8G8B8A8_UNORM);
+	LoadMatTexture(aiTextureType_HEIGHT, mat.heightIdx, VK_FORMAT_BC7_UNORM_BLOCK);
+	LoadMatTexture(aiTextureType_NORMALS, mat.normalIdx, VK_FORMAT_BC5_UNORM_BLOCK);
 
-	LoadMatTexture(aiTextureType_DIFFUSE_ROUGHNESS, mat.roughnessIdx, VK_FORMAT_R8G8B8A8_UNORM);
-	LoadMatTexture(aiTextureType_METALNESS, mat.metalnessIdx, VK_FORMAT_R8G8B8A8_UNORM);
+	LoadMatTexture(aiTextureType_DIFFUSE_ROUGHNESS, mat.roughnessIdx, VK_FORMAT_BC7_UNORM_BLOCK);
+	LoadMatTexture(aiTextureType_METALNESS, mat.metalnessIdx, VK_FORMAT_BC7_UNORM_BLOCK);
 
-	LoadMatTexture(aiTextureType_OPACITY, mat.opacityIdx, VK_FORMAT_R8G8B8A8_UNORM);
+	LoadMatTexture(aiTextureType_OPACITY, mat.opacityIdx, VK_FORMAT_BC7_UNORM_BLOCK);
 }
 
-void pompeii::Mesh::CreateVertexBuffer(const Context& context)
+void pompeii::Mesh::BuildMeshlets()
 {
-	BufferAllocator alloc{};
-	const uint32_t bufferSize = static_cast<uint32_t>(vertices.size()) * sizeof(Vertex);
-	alloc
-		.SetDebugName("Vertex Buffer")
-		.SetSize(bufferSize)
-		.SetUsage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
-		.HostAccess(false)
-		.AddInitialData(vertices.data(), 0, bufferSize)
-		.Allocate(context, vertexBuffer);
+	for (SubMesh& subMesh : vSubMeshes)
+	{
+		subMesh.meshletOffset = static_cast<uint32_t>(vMeshlets.size());
+		MeshletBuilder::Build(
+			std::span<const Vertex>(vertices).subspan(subMesh.vertexOffset, subMesh.vertexCount),
+			std::span<uint32_t>(indices).subspan(subMesh.indexOffset, subMesh.indexCount),
+			vMeshlets);
+		subMesh.meshletCount = static_cast<uint32_t>(vMeshlets.size()) - subMesh.meshletOffset;
+	}
 }
-void pompeii::Mesh::CreateIndexBuffer(const Context& context)
+void pompeii::Mesh::BuildLods()
 {
-	BufferAllocator alloc{};
-	const uint32_t bufferSize = static_cast<uint32_t>(indices.size()) * sizeof(uint32_t);
-	alloc
-		.SetDebugName("Index Buffer")
-		.SetSize(bufferSize)
-		.SetUsage(VK_BUFFER_USAGE_INDEX_BUFFER_BIT)
-		.HostAccess(false)
-		.AddInitialData(indices.data(), 0, bufferSize)
-		.Allocate(context, indexBuffer);
+	// -- Every Sub Mesh's LODs follow its full detail indices, so it stays one contiguous block --
+	std::vector<uint32_t> vBlocked{};
+	std::vector<uint32_t> vLodIndices{};
+	std::vector<SubMeshLod> vSubMeshLods{};
+	vBlocked.reserve(indices.size() * 2);
+	for (SubMesh& subMesh : vSubMeshes)
+	{
+		const std::span<const uint32_t> fullDetail = std::span<const uint32_t>(indices).subspan(subMesh.indexOffset, subMesh.indexCount);
+
+		vLodIndices.clear();
+		vSubMeshLods.clear();
+		MeshSimplifier::BuildChain(
+			std::span<const Vertex>(vertices).subspan(subMesh.vertexOffset, subMesh.vertexCount),
+			fullDetail, vLodIndices, vSubMeshLods);
+
+		subMesh.indexOffset = static_cast<uint32_t>(vBlocked.size());
+		vBlocked.insert(vBlocked.end(), fullDetail.begin(), fullDetail.end());
+		vBlocked.insert(vBlocked.end(), vLodIndices.begin(), vLodIndices.end());
+
+		subMesh.lodOffset = static_cast<uint32_t>(vLods.size());
+		subMesh.lodCount = static_cast<uint32_t>(vSubMeshLods.size());
+		for (SubMeshLod& lod : vSubMeshLods)
+		{
+			lod.indexOffset += subMesh.indexCount;
+			vLods.push_back(lod);
+		}
+	}
+	indices = std::move(vBlocked);
 }
-void pompeii::Mesh::CreateImages(const Context& context)
+void pompeii::Mesh::Optimize(const std::string& path)
 {
-	for (const Texture& tex : textures)
+	VertexCacheStats before{};
+	VertexCacheStats after{};
+	for (const SubMesh& subMesh : vSubMeshes)
+	{
+		const std::span<Vertex> subMeshVertices = std::span<Vertex>(vertices).subspan(subMesh.vertexOffset, subMesh.vertexCount);
+		const std::span<uint32_t> block = std::span<uint32_t>(indices).subspan(subMesh.indexOffset, GetIndexBlockCount(subMesh));
+		const std::span<uint32_t> fullDetail = block.first(subMesh.indexCount);
+		before += MeshOptimizer::AnalyzeVertexCache(fullDetail, subMesh.vertexCount);
+
+		// -- Vertex Cache, per cluster so the meshlet ranges stay intact --
+		const std::span<Meshlet> meshlets = std::span<Meshlet>(vMeshlets).subspan(subMesh.meshletOffset, subMesh.meshletCount);
+		for (const Meshlet& meshlet : meshlets)
+			MeshOptimizer::OptimizeVertexCache(fullDetail.subspan(meshlet.indexOffset, meshlet.indexCount), subMesh.vertexCount);
+		for (const SubMeshLod& lod : std::span<const SubMeshLod>(vLods).subspan(subMesh.lodOffset, subMesh.lodCount))
+			MeshOptimizer::OptimizeVertexCache(block.subspan(lod.indexOffset, lod.indexCount), subMesh.vertexCount);
+
+		// -- Overdraw, then Vertex Fetch over every LOD --
+		MeshOptimizer::OptimizeOverdraw(subMeshVertices, fullDetail, meshlets);
+		MeshOptimizer::OptimizeVertexFetch(subMeshVertices, block);
+
+		after += MeshOptimizer::AnalyzeVertexCache(fullDetail, subMesh.vertexCount);
+	}
+
+	if (RenderDebugger::IsEnabled())
+	{
+		std::cout << INFO_TXT << "Optimized Mesh: " << path << "\n"
+			<< "\tACMR: " << before.GetACMR() << " -> " << after.GetACMR() << "\n"
+			<< "\tATVR: " << before.GetATVR() << " -> " << after.GetATVR() << "\n\n" << RESET_TXT;
+	}
+}
+void pompeii::Mesh::ResolveTextures()
+{
+	// -- Shared textures are only loaded once, by whichever mesh asks first --
+	m_vTextureSlots.reserve(m_vTextureRequests.size());
+	try
+	{
+		for (const auto& [path, format] : m_vTextureRequests)
+			m_vTextureSlots.push_back(TextureRegistry::Acquire(path, format));
+		TextureRegistry::DecodePending();
+	}
+	catch (...)
+	{
+		// -- The mesh never finishes loading, so nothing would release what it acquired --
+		for (uint32_t slot : m_vTextureSlots)
+			TextureRegistry::Release(slot);
+		m_vTextureSlots.clear();
+		throw;
+	}
+
+	// -- Materials point straight at the registry slots from here on --
+	const auto resolve = [this](uint32_t& idx)
+		{
+			if (idx < m_vTextureSlots.size())
+				idx = m_vTextureSlots[idx];
+		};
+	for (SubMesh& subMesh : vSubMeshes)
 	{
-		images.emplace_back();
-
-		uint32_t texW = tex.GetExtent().x;
-		uint32_t texH = tex.GetExtent().y;
-		uint32_t maxMipsLevels = 1;
-		// only generate mipmaps for big enough textures
-		if (texW >= 256 || texH >= 256)
-			maxMipsLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texW, texH)))) + 1;
-		uint32_t mipLevels = maxMipsLevels;
-
-		ImageBuilder builder{};
-		builder
-			.SetDebugName(tex.GetPath().c_str())
-			.SetWidth(texW)
-			.SetHeight(texH)
-			.SetFormat(tex.GetFormat())
-			.SetTiling(VK_IMAGE_TILING_OPTIMAL)
-			.SetMipLevels(mipLevels)
-			.SetUsageFlags(VK_IMAGE_USAGE_SAMPLED_BIT)
-			.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-			.InitialData(tex.GetPixels(), 0, texW, texH, tex.GetMemorySize(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-			.Build(context, images.back());
-		images.back().CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, mipLevels, 0, 1);
+		Material& material = subMesh.material;
+		for (uint32_t* pIdx : { &material.albedoIdx, &material.normalIdx, &material.metalnessIdx, &material.roughnessIdx,
+								&material.opacityIdx, &material.specularIdx, &material.shininessIdx, &material.heightIdx })
+			resolve(*pIdx);
 	}
 }
 
+void pompeii::Mesh::CreateVertexBuffer(const Context& context)
+{
+	const std::span<const Vertex> vertexData = GetVertices();
+
+	// -- Quantize each Sub Mesh against its own AABB --
+	std::vector<PackedVertex> vPacked(vertexData.size());
+	for (const SubMesh& subMesh : vSubMeshes)
+	{
+		const glm::vec3 positionOffset = subMesh.GetPositionOffset();
+		const glm::vec3 positionScale = subMesh.GetPositionScale();
+		for (uint32_t vIdx{ subMesh.vertexOffset }; vIdx < subMesh.vertexOffset + subMesh.vertexCount; ++vIdx)
+			vPacked[vIdx] = PackedVertex::Pack(vertexData[vIdx], positionOffset, positionScale);
+	}
+
+	// -- Sub Meshes keep their local indices, baseVertex moves them to the arena range --
+	vertexRange = context.geometryArena->AllocateVertices(static_cast<uint32_t>(vPacked.size()));
+	const int32_t arenaVertexOffset = static_cast<int32_t>(vertexRange.offset / sizeof(PackedVertex));
+	for (SubMesh& subMesh : vSubMeshes)
+		subMesh.baseVertex = arenaVertexOffset + static_cast<int32_t>(subMesh.vertexOffset);
+
+	m_UploadTicket = std::max(m_UploadTicket, context.geometryArena->UploadVertices(context, vertexRange, vPacked.data()));
+}
+void pompeii::Mesh::CreateIndexBuffer(const Context& context)
+{
+	const std::span<const uint32_t> indexData = GetIndices();
+
+	// -- Sub Meshes that fit in 16 bits get narrow indices --
+	uint32_t index16Count{};
+	uint32_t index32Count{};
+	for (SubMesh& subMesh : vSubMeshes)
+	{
+		const bool narrow = subMesh.vertexCount <= std::numeric_limits<uint16_t>::max();
+		subMesh.indexType = narrow ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+		subMesh.firstIndex = narrow ? index16Count : index32Count;
+		(narrow ? index16Count : index32Count) += GetIndexBlockCount(subMesh);
+	}
+
+	// -- Pack both regions, 32-bit region is kept 4-byte aligned --
+	const VkDeviceSize index32Offset = (index16Count * sizeof(uint16_t) + 3) & ~VkDeviceSize{ 3 };
+	indexRange = context.geometryArena->AllocateIndices(index32Offset + index32Count * sizeof(uint32_t));
+	std::vector<uint8_t> vIndexData(indexRange.size);
+	uint16_t* pIndices16 = reinterpret_cast<uint16_t*>(vIndexData.data());
+	uint32_t* pIndices32 = reinterpret_cast<uint32_t*>(vIndexData.data() + index32Offset);
+	for (const SubMesh& subMesh : vSubMeshes)
+	{
+		const std::span<const uint32_t> subMeshIndices = indexData.subspan(subMesh.indexOffset, GetIndexBlockCount(subMesh));
+		if (subMesh.indexType == VK_INDEX_TYPE_UINT16)
+			std::ranges::transform(subMeshIndices, pIndices16 + subMesh.firstIndex, [](uint32_t index) { return static_cast<uint16_t>(index); });
+		else
+			std::ranges::copy(subMeshIndices, pIndices32 + subMesh.firstIndex);
+	}
+
+	// -- The arena is bound at offset 0, so firstIndex moves to the start of the range --
+	for (SubMesh& subMesh : vSubMeshes)
+	{
+		if (subMesh.indexType == VK_INDEX_TYPE_UINT16)
+			subMesh.firstIndex += static_cast<uint32_t>(indexRange.offset / sizeof(uint16_t));
+		else
+			subMesh.firstIndex += static_cast<uint32_t>((indexRange.offset + index32Offset) / sizeof(uint32_t));
+	}
+
+	m_UploadTicket = std::max(m_UploadTicket, context.geometryArena->UploadIndices(context, indexRange, vIndexData.data()));
+}
+
+uint32_t pompeii::Mesh::GetIndexBlockCount(const SubMesh& subMesh) const
+{
+	// -- Full detail plus every LOD --
+	const std::span<const SubMeshLod> lods = GetLods(subMesh);
+	if (lods.empty())
+		return subMesh.indexCount;
+	return lods.back().indexOffset + lods.back().indexCount;
+}
 glm::mat4 pompeii::Mesh::ConvertAssimpMatrix(const aiMatrix4x4& mat)
 {
 	return glm::mat4(
@@ -4,12 +4,17 @@
 // -- Standard Library --
 #include <vector>
 #include <unordered_map>
+#include <span>
 
 // -- Pompeii Includes --
 #include "Material.h"
 #include "Shapes.h"
 #include "Buffer.h"
+#include "GeometryArena.h"
 #include "Image.h"
+#include "MeshCache.h"
+#include "Meshlet.h"
+#include "MeshLod.h"
 
 // -- Vulkan Includes
 #include <vulkan/vulkan.h>
@@ -20,6 +25,7 @@
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 // -- Model Loading --
 #include <assimp/Importer.hpp>
@@ -42,19 +48,49 @@ namespace pompeii
 		//--------------------------------------------------
 		//    Helpers
 		//--------------------------------------------------
-		static VkVertexInputBindingDescription GetBindingDescription();
-		static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
 		bool operator==(const Vertex& other) const;
 	};
 
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Packed Vertex
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Lives in the GeometryArena and is pulled by the vertex shaders, mirrors PackedVertex in helpers_vertex.glsl.
+	// The only GPU vertex layout, the arena strides by it and every pass dequantizes it. Full precision stays on the CPU in Vertex
+	struct PackedVertex
+	{
+		glm::i16vec4 position;		// snorm xyz inside the sub mesh AABB, w holds the bitangent sign
+		glm::i16vec2 normal;		// snorm octahedral
+		glm::i16vec2 tangent;		// snorm octahedral
+		glm::u16vec2 texCoord;		// half float
+		glm::u8vec4 color;			// unorm
+
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		static PackedVertex Pack(const Vertex& vertex, const glm::vec3& positionOffset, const glm::vec3& positionScale);
+	};
+
 	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//? ~~	  Mesh
 	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	struct SubMesh
 	{
 		std::uint32_t vertexOffset;
+		uint32_t vertexCount;
 		uint32_t indexOffset;
 		uint32_t indexCount;
+		uint32_t meshletOffset;
+		uint32_t meshletCount;
+		uint32_t lodOffset;
+		uint32_t lodCount;
+
+		// -- Texture coordinates per SubMesh space unit, averaged over the surface --
+		float uvDensity{};
+
+		// -- Geometry Arena location, filled in by AllocateResources --
+		VkIndexType indexType{ VK_INDEX_TYPE_UINT32 };
+		uint32_t firstIndex{};
+		int32_t baseVertex{};
 
 		Material material{};
 
@@ -62,6 +98,13 @@ namespace pompeii
 		AABB aabb{};
 
 		std::string name;
+
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		glm::vec4 GetPositionOffset() const;
+		glm::vec4 GetPositionScale() const;
+		glm::mat4 GetDequantizeMatrix() const;
 	};
 
 	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -83,16 +126,28 @@ namespace pompeii
 		//--------------------------------------------------
 		//    Helpers
 		//--------------------------------------------------
-		void Bind(CommandBuffer& cmdBuffer) const;
 		void AllocateResources(const Context& context);
 		void Destroy(const Context& context);
 
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		std::span<const Vertex> GetVertices() const;
+		std::span<const uint32_t> GetIndices() const;
+		std::span<const Meshlet> GetMeshlets() const;
+		std::span<const Meshlet> GetMeshlets(const SubMesh& subMesh) const;
+		std::span<const SubMeshLod> GetLods() const;
+		std::span<const SubMeshLod> GetLods(const SubMesh& subMesh) const;
+		// -- Timeline value of the buffer uploads, drawable once the context's uploader reports it complete --
+		uint64_t GetUploadTicket() const;
+
 		//--------------------------------------------------
 		//    CPU Data
 		//--------------------------------------------------
 		std::vector<Vertex> vertices{};
 		std::vector<uint32_t> indices{};
-		std::vector<Texture> textures{};
+		std::vector<Meshlet> vMeshlets{};
+		std::vector<SubMeshLod> vLods{};
 		std::unordered_map<std::string, uint32_t> pathToIdx{};
 		std::vector<SubMesh> vSubMeshes{};
 		AABB aabb{};
@@ -100,9 +155,10 @@ namespace pompeii
 		//--------------------------------------------------
 		//    GPU Data
 		//--------------------------------------------------
-		Buffer vertexBuffer{};
-		Buffer indexBuffer{};
-		std::vector<Image> images{};
+		// -- Textures live in the TextureRegistry, the Renderer's TextureStreamer uploads them --
+		// -- Vertices and indices are ranges of the context's GeometryArena --
+		GeometryRange vertexRange{};
+		GeometryRange indexRange{};
 
 	private:
 		//--------------------------------------------------
@@ -111,11 +167,26 @@ namespace pompeii
 		void ProcessNode(const aiNode* pNode, const aiScene* pScene, const glm::mat4& transform = glm::mat4(1.0f));
 		void ProcessMesh(const aiMesh* pMesh, const aiScene* pScene, glm::mat4 transform);
 
+		void BuildMeshlets();
+		void BuildLods();
+		void Optimize(const std::string& path);
+		void ResolveTextures();
+
 		void CreateVertexBuffer(const Context& context);
 		void CreateIndexBuffer(const Context& context);
-		void CreateImages(const Context& context);
 
+		uint32_t GetIndexBlockCount(const SubMesh& subMesh) const;
 		static glm::mat4 ConvertAssimpMatrix(const aiMatrix4x4& mat);
+
+		uint64_t m_UploadTicket{};
+
+		// -- Warm Start Cache, vertices and indices stay mapped instead of being copied --
+		friend class MeshCache;
+		MeshCache m_Cache{};
+
+		// -- Unique textures in pathToIdx order, materials index these until ResolveTextures swaps in registry slots --
+		std::vector<std::pair<std::string, VkFormat>> m_vTextureRequests{};
+		std::vector<uint32_t> m_vTextureSlots{};
 	};
 }
 
@@ -0,0 +1,352 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "MeshCache.h"
+#include "Mesh.h"
+#include "ConsoleTextSettings.h"
+
+// -- Memory Mapping --
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	// -- On-Disk Records --
+	struct CachedSubMesh
+	{
+		uint32_t vertexOffset;
+		uint32_t vertexCount;
+		uint32_t indexOffset;
+		uint32_t indexCount;
+		uint32_t meshletOffset;
+		uint32_t meshletCount;
+		uint32_t lodOffset;
+		uint32_t lodCount;
+		float uvDensity;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+
+		pompeii::Material material;
+		glm::mat4 matrix;
+		pompeii::AABB aabb;
+	};
+	struct CachedTexture
+	{
+		VkFormat format;
+		uint32_t pathOffset;
+		uint32_t pathLength;
+	};
+
+	uint32_t AppendString(std::string& strings, const std::string& str)
+	{
+		const uint32_t offset = static_cast<uint32_t>(strings.size());
+		strings += str;
+		return offset;
+	}
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  MeshCache
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+pompeii::MeshCache::~MeshCache()
+{
+	Close();
+}
+
+//--------------------------------------------------
+//    Cache
+//--------------------------------------------------
+std::string pompeii::MeshCache::GetCachePath(const std::string& sourcePath)
+{
+	return sourcePath + ".pmesh";
+}
+void pompeii::MeshCache::Write(const std::string& sourcePath, const Mesh& mesh)
+{
+	MeshCacheHeader header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.aabb = mesh.aabb;
+	if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime))
+		return;
+
+	// -- Gather Records --
+	std::string strings{};
+	std::vector<CachedSubMesh> vSubMeshes{};
+	vSubMeshes.reserve(mesh.vSubMeshes.size());
+	for (const SubMesh& subMesh : mesh.vSubMeshes)
+	{
+		CachedSubMesh& cached = vSubMeshes.emplace_back();
+		cached.vertexOffset = subMesh.vertexOffset;
+		cached.vertexCount = subMesh.vertexCount;
+		cached.indexOffset = subMesh.indexOffset;
+		cached.indexCount = subMesh.indexCount;
+		cached.meshletOffset = subMesh.meshletOffset;
+		cached.meshletCount = subMesh.meshletCount;
+		cached.lodOffset = subMesh.lodOffset;
+		cached.lodCount = subMesh.lodCount;
+		cached.uvDensity = subMesh.uvDensity;
+		cached.nameOffset = AppendString(strings, subMesh.name);
+		cached.nameLength = static_cast<uint32_t>(subMesh.name.size());
+		cached.material = subMesh.material;
+		cached.matrix = subMesh.matrix;
+		cached.aabb = subMesh.aabb;
+	}
+	std::vector<CachedTexture> vTextures{};
+	vTextures.reserve(mesh.m_vTextureRequests.size());
+	for (const auto& [path, format] : mesh.m_vTextureRequests)
+	{
+		CachedTexture& cached = vTextures.emplace_back();
+		cached.format = format;
+		cached.pathOffset = AppendString(strings, path);
+		cached.pathLength = static_cast<uint32_t>(path.size());
+	}
+
+	// -- Layout --
+	const std::span<const Vertex> vertices = mesh.GetVertices();
+	const std::span<const uint32_t> indices = mesh.GetIndices();
+	const std::span<const Meshlet> meshlets = mesh.GetMeshlets();
+	const std::span<const SubMeshLod> lods = mesh.GetLods();
+	const void* pSectionData[static_cast<uint32_t>(MeshCacheSection::Count)]{};
+	uint64_t cursor = sizeof(MeshCacheHeader);
+	auto PlaceSection = [&](MeshCacheSection section, const void* pData, uint64_t size)
+		{
+			cursor = (cursor + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+			header.sections[static_cast<uint32_t>(section)] = { cursor, size };
+			pSectionData[static_cast<uint32_t>(section)] = pData;
+			cursor += size;
+		};
+	PlaceSection(MeshCacheSection::Vertices, vertices.data(), vertices.size_bytes());
+	PlaceSection(MeshCacheSection::Indices, indices.data(), indices.size_bytes());
+	PlaceSection(MeshCacheSection::Meshlets, meshlets.data(), meshlets.size_bytes());
+	PlaceSection(MeshCacheSection::Lods, lods.data(), lods.size_bytes());
+	PlaceSection(MeshCacheSection::SubMeshes, vSubMeshes.data(), vSubMeshes.size() * sizeof(CachedSubMesh));
+	PlaceSection(MeshCacheSection::Textures, vTextures.data(), vTextures.size() * sizeof(CachedTexture));
+	PlaceSection(MeshCacheSection::Strings, strings.data(), strings.size());
+
+	// -- Write --
+	const std::string cachePath = GetCachePath(sourcePath);
+	std::ofstream file{ cachePath, std::ios::binary | std::ios::trunc };
+	if (!file)
+	{
+		std::cout << WARNING_TXT << "Failed to write Mesh Cache: " << cachePath << "\n" << RESET_TXT;
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+	uint64_t written = sizeof(MeshCacheHeader);
+	for (uint32_t sIdx{}; sIdx < static_cast<uint32_t>(MeshCacheSection::Count); ++sIdx)
+	{
+		static constexpr char padding[SECTION_ALIGNMENT]{};
+		const MeshCacheSectionEntry& entry = header.sections[sIdx];
+		file.write(padding, static_cast<std::streamsize>(entry.offset - written));
+		if (entry.size > 0)
+			file.write(static_cast<const char*>(pSectionData[sIdx]), static_cast<std::streamsize>(entry.size));
+		written = entry.offset + entry.size;
+	}
+
+	if (!file)
+	{
+		file.close();
+		std::error_code ec;
+		std::filesystem::remove(cachePath, ec);
+		std::cout << WARNING_TXT << "Failed to write Mesh Cache: " << cachePath << "\n" << RESET_TXT;
+	}
+}
+
+bool pompeii::MeshCache::Open(const std::string& sourcePath)
+{
+	Close();
+
+	uint64_t sourceSize{};
+	int64_t sourceWriteTime{};
+	if (!GetSourceStamp(sourcePath, sourceSize, sourceWriteTime))
+		return false;
+
+	const std::string cachePath = GetCachePath(sourcePath);
+	std::error_code ec;
+	const uint64_t fileSize = std::filesystem::file_size(cachePath, ec);
+	if (ec || fileSize < sizeof(MeshCacheHeader))
+		return false;
+
+	// -- Map File --
+#ifdef _WIN32
+	HANDLE file = CreateFileA(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void* pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!pView)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_pFileHandle = file;
+	m_pMappingHandle = mapping;
+#else
+	const int fd = open(cachePath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	void* pView = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (pView == MAP_FAILED)
+		return false;
+#endif
+	m_pData = static_cast<const uint8_t*>(pView);
+	m_DataSize = fileSize;
+
+	// -- Validate --
+	const MeshCacheHeader& header = GetHeader();
+	bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+				 header.version == VERSION &&
+				 header.sourceSize == sourceSize &&
+				 header.sourceWriteTime == sourceWriteTime;
+	for (const MeshCacheSectionEntry& entry : header.sections)
+		valid = valid && entry.offset <= m_DataSize && entry.size <= m_DataSize - entry.offset;
+
+	// -- Every range a record holds is used without further checks, a corrupt record must not point past its section --
+	if (valid)
+	{
+		const auto IsInRange = [](uint64_t offset, uint64_t count, uint64_t size)
+			{
+				return offset <= size && count <= size - offset;
+			};
+		const uint64_t stringsSize = header.sections[static_cast<uint32_t>(MeshCacheSection::Strings)].size;
+		const std::span<const Vertex> vertices = GetSection<Vertex>(MeshCacheSection::Vertices);
+		const std::span<const uint32_t> indices = GetSection<uint32_t>(MeshCacheSection::Indices);
+		const std::span<const Meshlet> meshlets = GetSection<Meshlet>(MeshCacheSection::Meshlets);
+		const std::span<const SubMeshLod> lods = GetSection<SubMeshLod>(MeshCacheSection::Lods);
+
+		for (const CachedSubMesh& cached : GetSection<CachedSubMesh>(MeshCacheSection::SubMeshes))
+		{
+			valid = valid &&
+					IsInRange(cached.nameOffset, cached.nameLength, stringsSize) &&
+					IsInRange(cached.vertexOffset, cached.vertexCount, vertices.size()) &&
+					IsInRange(cached.meshletOffset, cached.meshletCount, meshlets.size()) &&
+					IsInRange(cached.lodOffset, cached.lodCount, lods.size());
+			if (!valid)
+				break;
+
+			// Meshlets are drawn on their own, each has to stay inside the full detail indices
+			for (const Meshlet& meshlet : meshlets.subspan(cached.meshletOffset, cached.meshletCount))
+				valid = valid && IsInRange(meshlet.indexOffset, meshlet.indexCount, cached.indexCount);
+
+			// Full detail and every LOD make up the Sub Mesh's index block
+			uint64_t blockCount = cached.indexCount;
+			for (const SubMeshLod& lod : lods.subspan(cached.lodOffset, cached.lodCount))
+				blockCount = std::max(blockCount, static_cast<uint64_t>(lod.indexOffset) + lod.indexCount);
+			valid = valid && IsInRange(cached.indexOffset, blockCount, indices.size());
+		}
+		for (const CachedTexture& cached : GetSection<CachedTexture>(MeshCacheSection::Textures))
+			valid = valid && IsInRange(cached.pathOffset, cached.pathLength, stringsSize);
+	}
+
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+void pompeii::MeshCache::Read(Mesh& mesh) const
+{
+	const std::span<const char> strings = GetSection<char>(MeshCacheSection::Strings);
+	mesh.aabb = GetHeader().aabb;
+
+	// -- Sub Meshes --
+	const std::span<const CachedSubMesh> vSubMeshes = GetSection<CachedSubMesh>(MeshCacheSection::SubMeshes);
+	mesh.vSubMeshes.reserve(vSubMeshes.size());
+	for (const CachedSubMesh& cached : vSubMeshes)
+	{
+		SubMesh& subMesh = mesh.vSubMeshes.emplace_back();
+		subMesh.vertexOffset = cached.vertexOffset;
+		subMesh.vertexCount = cached.vertexCount;
+		subMesh.indexOffset = cached.indexOffset;
+		subMesh.indexCount = cached.indexCount;
+		subMesh.meshletOffset = cached.meshletOffset;
+		subMesh.meshletCount = cached.meshletCount;
+		subMesh.lodOffset = cached.lodOffset;
+		subMesh.lodCount = cached.lodCount;
+		subMesh.uvDensity = cached.uvDensity;
+		subMesh.material = cached.material;
+		subMesh.matrix = cached.matrix;
+		subMesh.aabb = cached.aabb;
+		subMesh.name.assign(strings.data() + cached.nameOffset, cached.nameLength);
+	}
+
+	// -- Textures --
+	const std::span<const CachedTexture> vTextures = GetSection<CachedTexture>(MeshCacheSection::Textures);
+	mesh.m_vTextureRequests.reserve(vTextures.size());
+	for (const CachedTexture& cached : vTextures)
+	{
+		std::string path{ strings.data() + cached.pathOffset, cached.pathLength };
+		mesh.pathToIdx.insert({ path, static_cast<uint32_t>(mesh.m_vTextureRequests.size()) });
+		mesh.m_vTextureRequests.emplace_back(std::move(path), cached.format);
+	}
+}
+void pompeii::MeshCache::Close()
+{
+	if (!m_pData)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_pData);
+	CloseHandle(static_cast<HANDLE>(m_pMappingHandle));
+	CloseHandle(static_cast<HANDLE>(m_pFileHandle));
+	m_pMappingHandle = nullptr;
+	m_pFileHandle = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(m_pData), m_DataSize);
+#endif
+	m_pData = nullptr;
+	m_DataSize = 0;
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+bool pompeii::MeshCache::IsOpen() const { return m_pData != nullptr; }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+const pompeii::MeshCacheHeader& pompeii::MeshCache::GetHeader() const
+{
+	return *reinterpret_cast<const MeshCacheHeader*>(m_pData);
+}
+bool pompeii::MeshCache::GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& writeTime)
+{
+	std::error_code ec;
+	size = std::filesystem::file_size(sourcePath, ec);
+	if (ec)
+		return false;
+	writeTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, ec).time_since_epoch().count());
+	return !ec;
+}
@@ -0,0 +1,107 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+// -- Standard Library --
+#include <cstdint>
+#include <span>
+#include <string>
+
+// -- Pompeii Includes --
+#include "Shapes.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Mesh;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  MeshCache
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	enum class MeshCacheSection : uint32_t
+	{
+		Vertices,
+		Indices,
+		Meshlets,
+		Lods,
+		SubMeshes,
+		Textures,
+		Strings,
+		Count
+	};
+	struct MeshCacheSectionEntry
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+	struct MeshCacheHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		AABB aabb;
+		MeshCacheSectionEntry sections[static_cast<uint32_t>(MeshCacheSection::Count)];
+	};
+
+	class MeshCache final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit MeshCache() = default;
+		~MeshCache();
+		MeshCache(const MeshCache& other) = delete;
+		MeshCache(MeshCache&& other) noexcept = delete;
+		MeshCache& operator=(const MeshCache& other) = delete;
+		MeshCache& operator=(MeshCache&& other) noexcept = delete;
+
+		//--------------------------------------------------
+		//    Cache
+		//--------------------------------------------------
+		static std::string GetCachePath(const std::string& sourcePath);
+		static void Write(const std::string& sourcePath, const Mesh& mesh);
+
+		bool Open(const std::string& sourcePath);
+		void Read(Mesh& mesh) const;
+		void Close();
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		bool IsOpen() const;
+		template<typename T>
+		std::span<const T> GetSection(MeshCacheSection section) const
+		{
+			if (!m_pData)
+				return {};
+			const MeshCacheSectionEntry& entry = GetHeader().sections[static_cast<uint32_t>(section)];
+			return { reinterpret_cast<const T*>(m_pData + entry.offset), static_cast<size_t>(entry.size / sizeof(T)) };
+		}
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		const MeshCacheHeader& GetHeader() const;
+		static bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& writeTime);
+
+		const uint8_t* m_pData{ nullptr };
+		uint64_t m_DataSize{ 0 };
+
+#ifdef _WIN32
+		void* m_pFileHandle{ nullptr };
+		void* m_pMappingHandle{ nullptr };
+#endif
+
+		// -- Format --
+		static constexpr char MAGIC[4]{ 'P', 'M', 'S', 'H' };
+		static constexpr uint32_t VERSION{ 9 };
+		static constexpr uint64_t SECTION_ALIGNMENT{ 16 };
+	};
+}
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,293 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+// -- Pompeii Includes --
+#include "MeshLod.h"
+#include "Mesh.h"
+
+namespace
+{
+	// -- Symmetric plane quadric, w is the accumulated area so errors come out as distances --
+	struct Quadric
+	{
+		float a00, a01, a02, a11, a12, a22;
+		float b0, b1, b2;
+		float c;
+		float w;
+
+		void AddPlane(const glm::vec3& n, float d, float weight)
+		{
+			a00 += weight * n.x * n.x; a01 += weight * n.x * n.y; a02 += weight * n.x * n.z;
+			a11 += weight * n.y * n.y; a12 += weight * n.y * n.z; a22 += weight * n.z * n.z;
+			b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+			c += weight * d * d;
+			w += weight;
+		}
+		Quadric& operator+=(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02;
+			a11 += other.a11; a12 += other.a12; a22 += other.a22;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			w += other.w;
+			return *this;
+		}
+		float Evaluate(const glm::vec3& p) const
+		{
+			const float r = p.x * (a00 * p.x + 2.f * (a01 * p.y + a02 * p.z + b0)) +
+							p.y * (a11 * p.y + 2.f * (a12 * p.z + b1)) +
+							p.z * (a22 * p.z + 2.f * b2) + c;
+			return w > 0.f ? std::max(r, 0.f) / w : 0.f;
+		}
+	};
+
+	struct PositionHash
+	{
+		size_t operator()(const glm::vec3& p) const
+		{
+			// Adding zero folds -0 into +0, they compare equal so they must hash equal
+			const glm::vec3 q = p + glm::vec3{ 0.f };
+			uint32_t bits[3];
+			std::memcpy(bits, &q, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  LOD Selector
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::LodSelector pompeii::LodSelector::FromCamera(const glm::mat4& view, const glm::mat4& proj, float viewportHeight, float lodBias)
+{
+	LodSelector selector{};
+	selector.viewPosition = glm::inverse(view)[3];
+	selector.pixelScale = std::abs(proj[1][1]) * 0.5f * viewportHeight;
+	selector.pixelError = PIXEL_ERROR * lodBias;
+	selector.orthographic = proj[3][3] == 1.f;
+	return selector;
+}
+float pompeii::LodSelector::GetTexCoordsPerPixel(const SubMesh& subMesh, const glm::mat4& model) const
+{
+	const float maxScale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+	if (maxScale <= 0.f || pixelScale <= 0.f)
+		return 0.f;
+
+	// -- World Units per Pixel --
+	float unitsPerPixel = 1.f / pixelScale;
+	if (!orthographic)
+	{
+		const glm::vec3 worldCenter = model * glm::vec4((subMesh.aabb.min + subMesh.aabb.max) * 0.5f, 1.f);
+		const float worldRadius = glm::length(subMesh.aabb.max - subMesh.aabb.min) * 0.5f * maxScale;
+		const float distance = glm::length(worldCenter - viewPosition) - worldRadius;
+		if (distance <= 0.f)
+			return 0.f;
+		unitsPerPixel *= distance;
+	}
+
+	// -- uvDensity is measured in SubMesh space --
+	return subMesh.uvDensity / maxScale * unitsPerPixel;
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Mesh Simplifier
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Simplification
+//--------------------------------------------------
+float pompeii::MeshSimplifier::Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, std::vector<uint32_t>& vOut)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	vOut.assign(indices.begin(), indices.end());
+
+	// -- Lock Seams --
+	// Vertices split for UVs or normals share a position, moving one would tear the surface
+	std::vector<bool> vLocked(vertexCount, false);
+	{
+		std::unordered_map<glm::vec3, uint32_t, PositionHash> positionToVertex{};
+		positionToVertex.reserve(vertexCount);
+		for (uint32_t vIdx{}; vIdx < vertexCount; ++vIdx)
+		{
+			auto [it, inserted] = positionToVertex.insert({ vertices[vIdx].position, vIdx });
+			if (!inserted)
+				vLocked[vIdx] = vLocked[it->second] = true;
+		}
+	}
+
+	// -- Lock Borders --
+	{
+		std::unordered_map<uint64_t, uint32_t> edgeUses{};
+		edgeUses.reserve(indices.size());
+		auto EdgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b); };
+		for (size_t iIdx{}; iIdx < indices.size(); iIdx += 3)
+			for (uint32_t eIdx{}; eIdx < 3; ++eIdx)
+				++edgeUses[EdgeKey(indices[iIdx + eIdx], indices[iIdx + (eIdx + 1) % 3])];
+		for (const auto& [key, uses] : edgeUses)
+		{
+			if (uses != 1)
+				continue;
+			vLocked[static_cast<uint32_t>(key >> 32)] = true;
+			vLocked[static_cast<uint32_t>(key & 0xFFFFFFFF)] = true;
+		}
+	}
+
+	// -- Quadrics --
+	std::vector<Quadric> vQuadrics(vertexCount, Quadric{});
+	for (size_t iIdx{}; iIdx + 2 < indices.size(); iIdx += 3)
+	{
+		const glm::vec3& p0 = vertices[indices[iIdx]].position;
+		const glm::vec3 normal = glm::cross(vertices[indices[iIdx + 1]].position - p0, vertices[indices[iIdx + 2]].position - p0);
+		const float doubleArea = glm::length(normal);
+		if (doubleArea <= 0.f)
+			continue;
+		const glm::vec3 n = normal / doubleArea;
+		for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+			vQuadrics[indices[iIdx + cIdx]].AddPlane(n, -glm::dot(n, p0), doubleArea * 0.5f);
+	}
+
+	// -- Collapse in Independent Passes --
+	float maxError{};
+	std::vector<uint32_t> vAdjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> vAdjacency{};
+	std::vector<float> vBestCost(vertexCount);
+	std::vector<uint32_t> vBestTarget(vertexCount);
+	std::vector<uint32_t> vCollapseTo(vertexCount);
+	std::vector<bool> vTouched(vertexCount);
+	std::vector<uint32_t> vCandidates{};
+	while (vOut.size() > targetIndexCount)
+	{
+		const uint32_t triangleCount = static_cast<uint32_t>(vOut.size() / 3);
+
+		// Vertex to triangle adjacency of the current mesh
+		std::ranges::fill(vAdjacencyOffsets, 0u);
+		for (uint32_t index : vOut)
+			++vAdjacencyOffsets[index + 1];
+		std::partial_sum(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end(), vAdjacencyOffsets.begin());
+		vAdjacency.resize(vOut.size());
+		{
+			std::vector<uint32_t> vFill(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end() - 1);
+			for (uint32_t iIdx{}; iIdx < vOut.size(); ++iIdx)
+				vAdjacency[vFill[vOut[iIdx]]++] = iIdx / 3;
+		}
+
+		// Cheapest collapse per movable vertex
+		std::ranges::fill(vBestCost, std::numeric_limits<float>::max());
+		for (uint32_t iIdx{}; iIdx < vOut.size(); ++iIdx)
+		{
+			const uint32_t from = vOut[iIdx];
+			if (vLocked[from])
+				continue;
+			const uint32_t triangle = iIdx / 3;
+			for (uint32_t offset{ 1 }; offset < 3; ++offset)
+			{
+				const uint32_t to = vOut[triangle * 3 + (iIdx % 3 + offset) % 3];
+				Quadric combined = vQuadrics[from];
+				combined += vQuadrics[to];
+				const float cost = combined.Evaluate(vertices[to].position);
+				if (cost < vBestCost[from])
+				{
+					vBestCost[from] = cost;
+					vBestTarget[from] = to;
+				}
+			}
+		}
+		vCandidates.clear();
+		for (uint32_t vIdx{}; vIdx < vertexCount; ++vIdx)
+			if (vBestCost[vIdx] != std::numeric_limits<float>::max())
+				vCandidates.push_back(vIdx);
+		std::ranges::sort(vCandidates, [&](uint32_t a, uint32_t b) { return vBestCost[a] < vBestCost[b]; });
+
+		// Apply collapses whose one-rings don't overlap, so every flip check stays valid
+		std::iota(vCollapseTo.begin(), vCollapseTo.end(), 0u);
+		std::fill(vTouched.begin(), vTouched.end(), false);
+		uint32_t removedTriangles{};
+		for (uint32_t from : vCandidates)
+		{
+			const uint32_t to = vBestTarget[from];
+			if (vTouched[from] || vTouched[to])
+				continue;
+
+			bool flips = false;
+			uint32_t collapsedTriangles{};
+			for (uint32_t aIdx{ vAdjacencyOffsets[from] }; aIdx < vAdjacencyOffsets[from + 1] && !flips; ++aIdx)
+			{
+				const uint32_t* pTriangle = &vOut[vAdjacency[aIdx] * 3];
+				if (pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to)
+				{
+					++collapsedTriangles;
+					continue;
+				}
+				glm::vec3 p[3];
+				for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+					p[cIdx] = vertices[pTriangle[cIdx]].position;
+				const glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+				for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+					if (pTriangle[cIdx] == from)
+						p[cIdx] = vertices[to].position;
+				const glm::vec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+				flips = glm::dot(before, after) <= 0.f;
+			}
+			if (flips)
+				continue;
+
+			vCollapseTo[from] = to;
+			vQuadrics[to] += vQuadrics[from];
+			maxError = std::max(maxError, vBestCost[from]);
+			for (uint32_t aIdx{ vAdjacencyOffsets[from] }; aIdx < vAdjacencyOffsets[from + 1]; ++aIdx)
+				for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+					vTouched[vOut[vAdjacency[aIdx] * 3 + cIdx]] = true;
+
+			removedTriangles += collapsedTriangles;
+			if ((triangleCount - removedTriangles) * 3 <= targetIndexCount)
+				break;
+		}
+		if (removedTriangles == 0)
+			break;
+
+		// Rewrite the triangles, dropping the degenerate ones
+		size_t writeIdx{};
+		for (size_t iIdx{}; iIdx < vOut.size(); iIdx += 3)
+		{
+			const uint32_t a = vCollapseTo[vOut[iIdx]];
+			const uint32_t b = vCollapseTo[vOut[iIdx + 1]];
+			const uint32_t c = vCollapseTo[vOut[iIdx + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+			vOut[writeIdx++] = a;
+			vOut[writeIdx++] = b;
+			vOut[writeIdx++] = c;
+		}
+		vOut.resize(writeIdx);
+	}
+
+	return std::sqrt(maxError);
+}
+void pompeii::MeshSimplifier::BuildChain(std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::vector<uint32_t>& vLodIndices, std::vector<SubMeshLod>& vLods)
+{
+	// -- Halve the triangle count per level, each level starts from the previous one --
+	std::vector<uint32_t> vPrevious(indices.begin(), indices.end());
+	std::vector<uint32_t> vSimplified{};
+	float error{};
+	for (uint32_t lodIdx{}; lodIdx < MAX_LODS; ++lodIdx)
+	{
+		const uint32_t target = static_cast<uint32_t>(vPrevious.size() / 6) * 3;
+		if (target < MIN_TRIANGLES * 3)
+			break;
+
+		// Each level is measured against the previous one, summing keeps the bound conservative
+		error += Simplify(vertices, vPrevious, target, vSimplified);
+		if (vSimplified.size() * 10 > vPrevious.size() * 9)
+			break;
+
+		vLods.push_back({ static_cast<uint32_t>(vLodIndices.size()), static_cast<uint32_t>(vSimplified.size()), error });
+		vLodIndices.insert(vLodIndices.end(), vSimplified.begin(), vSimplified.end());
+		vPrevious.swap(vSimplified);
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+// -- Standard Library --
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// -- Math Includes --
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_LEFT_HANDED
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Vertex;
+	struct SubMesh;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  SubMesh LOD
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct SubMeshLod
+	{
+		// -- Range after the owning SubMesh's full detail indices, relative to its indexOffset --
+		uint32_t indexOffset;
+		uint32_t indexCount;
+
+		// -- Largest deviation from the full detail surface, in SubMesh space --
+		float error;
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  LOD Selector
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct LodSelector
+	{
+		glm::vec3 viewPosition{};
+		float pixelScale{};			// pixels per world unit at distance one, or at any distance when orthographic
+		float pixelError{ PIXEL_ERROR };
+		bool orthographic{ false };
+
+		static LodSelector FromCamera(const glm::mat4& view, const glm::mat4& proj, float viewportHeight, float lodBias = 1.f);
+		// Texture coordinates one pixel covers at the closest point of the SubMesh, 0 once the camera is inside
+		float GetTexCoordsPerPixel(const SubMesh& subMesh, const glm::mat4& model) const;
+
+		static constexpr float PIXEL_ERROR{ 1.f };
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Mesh Simplifier
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class MeshSimplifier final
+	{
+	public:
+		//--------------------------------------------------
+		//    Simplification
+		//--------------------------------------------------
+		// Quadric half-edge collapse, seam and border vertices stay put so no cracks open up
+		static float Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, std::vector<uint32_t>& vOut);
+		static void BuildChain(std::span<const Vertex> vertices, std::span<const uint32_t> indices, std::vector<uint32_t>& vLodIndices, std::vector<SubMeshLod>& vLods);
+
+		static constexpr uint32_t MAX_LODS{ 4 };
+		static constexpr uint32_t MIN_TRIANGLES{ 64 };
+	};
+}
+
+#endif // MESH_LOD_H
@@ -0,0 +1,249 @@
+// -- Standard Library --
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Vertex Cache Statistics
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+float pompeii::VertexCacheStats::GetACMR() const
+{
+	return triangleCount > 0 ? static_cast<float>(missCount) / static_cast<float>(triangleCount) : 0.f;
+}
+float pompeii::VertexCacheStats::GetATVR() const
+{
+	return vertexCount > 0 ? static_cast<float>(missCount) / static_cast<float>(vertexCount) : 0.f;
+}
+pompeii::VertexCacheStats& pompeii::VertexCacheStats::operator+=(const VertexCacheStats& other)
+{
+	triangleCount += other.triangleCount;
+	vertexCount += other.vertexCount;
+	missCount += other.missCount;
+	return *this;
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Mesh Optimizer
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Optimization
+//--------------------------------------------------
+void pompeii::MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount)
+{
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount < 2)
+		return;
+
+	// -- Vertex to Triangle Adjacency --
+	std::vector<uint32_t> vAdjacencyOffsets(vertexCount + 1, 0);
+	for (uint32_t index : indices)
+		++vAdjacencyOffsets[index + 1];
+	std::partial_sum(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end(), vAdjacencyOffsets.begin());
+	std::vector<uint32_t> vAdjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> vFill(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end() - 1);
+		for (uint32_t iIdx{}; iIdx < triangleCount * 3; ++iIdx)
+			vAdjacency[vFill[indices[iIdx]]++] = iIdx / 3;
+	}
+
+	// -- Tipsify --
+	std::vector<uint32_t> vLiveTriangles(vertexCount);
+	for (uint32_t vIdx{}; vIdx < vertexCount; ++vIdx)
+		vLiveTriangles[vIdx] = vAdjacencyOffsets[vIdx + 1] - vAdjacencyOffsets[vIdx];
+	std::vector<uint32_t> vCacheTime(vertexCount, 0);
+	std::vector<bool> vEmitted(triangleCount, false);
+	std::vector<uint32_t> vDeadEnds{};
+	std::vector<uint32_t> vCandidates{};
+	std::vector<uint32_t> vOut{};
+	vOut.reserve(indices.size());
+
+	constexpr uint32_t invalid = ~0u;
+	uint32_t time = CACHE_SIZE + 1;
+	uint32_t cursor{};
+	uint32_t fanning = indices[0];
+	while (fanning != invalid)
+	{
+		// Emit every live triangle around the fanning vertex
+		vCandidates.clear();
+		for (uint32_t aIdx{ vAdjacencyOffsets[fanning] }; aIdx < vAdjacencyOffsets[fanning + 1]; ++aIdx)
+		{
+			const uint32_t triangle = vAdjacency[aIdx];
+			if (vEmitted[triangle])
+				continue;
+			vEmitted[triangle] = true;
+			for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+			{
+				const uint32_t vertex = indices[triangle * 3 + cIdx];
+				vOut.push_back(vertex);
+				vDeadEnds.push_back(vertex);
+				vCandidates.push_back(vertex);
+				--vLiveTriangles[vertex];
+				if (time - vCacheTime[vertex] > CACHE_SIZE)
+					vCacheTime[vertex] = time++;
+			}
+		}
+
+		// Next fanning vertex, the one still in cache with the most work left
+		uint32_t best = invalid;
+		int32_t bestPriority = -1;
+		for (uint32_t vertex : vCandidates)
+		{
+			if (vLiveTriangles[vertex] == 0)
+				continue;
+			int32_t priority = 0;
+			if (time - vCacheTime[vertex] + 2 * vLiveTriangles[vertex] <= CACHE_SIZE)
+				priority = static_cast<int32_t>(time - vCacheTime[vertex]);
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				best = vertex;
+			}
+		}
+
+		// Dead end, back up through recently used vertices, then through the input order
+		while (best == invalid && !vDeadEnds.empty())
+		{
+			const uint32_t vertex = vDeadEnds.back();
+			vDeadEnds.pop_back();
+			if (vLiveTriangles[vertex] > 0)
+				best = vertex;
+		}
+		while (best == invalid && cursor < indices.size())
+		{
+			const uint32_t vertex = indices[cursor++];
+			if (vLiveTriangles[vertex] > 0)
+				best = vertex;
+		}
+		fanning = best;
+	}
+
+	std::ranges::copy(vOut, indices.begin());
+}
+void pompeii::MeshOptimizer::OptimizeOverdraw(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::span<Meshlet> meshlets)
+{
+	if (meshlets.size() < 2)
+		return;
+
+	// -- Area Weighted Centroid and Normal per Cluster --
+	struct ClusterInfo
+	{
+		glm::vec3 centroid{ 0.f };
+		glm::vec3 normal{ 0.f };
+		float area{};
+	};
+	std::vector<ClusterInfo> vClusters(meshlets.size());
+	glm::vec3 meshCentroid{ 0.f };
+	float meshArea{};
+	for (size_t mIdx{}; mIdx < meshlets.size(); ++mIdx)
+	{
+		ClusterInfo& cluster = vClusters[mIdx];
+		for (uint32_t iIdx{ meshlets[mIdx].indexOffset }; iIdx < meshlets[mIdx].indexOffset + meshlets[mIdx].indexCount; iIdx += 3)
+		{
+			const Vertex& v0 = vertices[indices[iIdx]];
+			const Vertex& v1 = vertices[indices[iIdx + 1]];
+			const Vertex& v2 = vertices[indices[iIdx + 2]];
+			glm::vec3 normal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+			const float area = glm::length(normal) * 0.5f;
+			// Face normals are flipped to agree with the vertex normals, the vertex normals decide what is out
+			if (glm::dot(normal, v0.normal + v1.normal + v2.normal) < 0.f)
+				normal = -normal;
+			cluster.centroid += (v0.position + v1.position + v2.position) * (area / 3.f);
+			cluster.normal += normal;
+			cluster.area += area;
+		}
+		meshCentroid += cluster.centroid;
+		meshArea += cluster.area;
+		if (cluster.area > 0.f)
+			cluster.centroid /= cluster.area;
+	}
+	if (meshArea <= 0.f)
+		return;
+	meshCentroid /= meshArea;
+
+	// -- Outward Facing Clusters First --
+	std::vector<float> vSortKeys(meshlets.size());
+	for (size_t mIdx{}; mIdx < meshlets.size(); ++mIdx)
+	{
+		const ClusterInfo& cluster = vClusters[mIdx];
+		const float normalLength = glm::length(cluster.normal);
+		vSortKeys[mIdx] = normalLength > 0.f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength) : 0.f;
+	}
+	std::vector<uint32_t> vOrder(meshlets.size());
+	std::iota(vOrder.begin(), vOrder.end(), 0u);
+	std::ranges::stable_sort(vOrder, [&](uint32_t a, uint32_t b) { return vSortKeys[a] > vSortKeys[b]; });
+
+	// -- Rewrite Ranges --
+	const uint32_t baseOffset = meshlets.front().indexOffset;
+	std::vector<uint32_t> vReordered{};
+	std::vector<Meshlet> vMeshlets{};
+	vReordered.reserve(indices.size());
+	vMeshlets.reserve(meshlets.size());
+	for (uint32_t mIdx : vOrder)
+	{
+		Meshlet meshlet = meshlets[mIdx];
+		const auto begin = indices.begin() + meshlet.indexOffset;
+		meshlet.indexOffset = baseOffset + static_cast<uint32_t>(vReordered.size());
+		vReordered.insert(vReordered.end(), begin, begin + meshlet.indexCount);
+		vMeshlets.push_back(meshlet);
+	}
+	std::ranges::copy(vReordered, indices.begin() + baseOffset);
+	std::ranges::copy(vMeshlets, meshlets.begin());
+}
+void pompeii::MeshOptimizer::OptimizeVertexFetch(std::span<Vertex> vertices, std::span<uint32_t> indices)
+{
+	// -- First Use Order, unreferenced vertices go last --
+	constexpr uint32_t invalid = ~0u;
+	std::vector<uint32_t> vRemap(vertices.size(), invalid);
+	uint32_t next{};
+	for (uint32_t index : indices)
+	{
+		if (vRemap[index] == invalid)
+			vRemap[index] = next++;
+	}
+	for (uint32_t& remap : vRemap)
+	{
+		if (remap == invalid)
+			remap = next++;
+	}
+
+	std::vector<Vertex> vReordered(vertices.size());
+	for (size_t vIdx{}; vIdx < vertices.size(); ++vIdx)
+		vReordered[vRemap[vIdx]] = vertices[vIdx];
+	std::ranges::copy(vReordered, vertices.begin());
+	for (uint32_t& index : indices)
+		index = vRemap[index];
+}
+
+//--------------------------------------------------
+//    Analysis
+//--------------------------------------------------
+pompeii::VertexCacheStats pompeii::MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount)
+{
+	VertexCacheStats stats{};
+	stats.triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+	// -- FIFO, a vertex is a hit while fewer than CACHE_SIZE misses happened since it was loaded --
+	std::vector<uint32_t> vLoadedAt(vertexCount, 0);
+	std::vector<bool> vSeen(vertexCount, false);
+	for (uint32_t index : indices)
+	{
+		if (!vSeen[index])
+		{
+			vSeen[index] = true;
+			++stats.vertexCount;
+		}
+		else if (stats.missCount - vLoadedAt[index] < CACHE_SIZE)
+			continue;
+
+		vLoadedAt[index] = stats.missCount;
+		++stats.missCount;
+	}
+	return stats;
+}
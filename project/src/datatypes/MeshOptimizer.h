@@ -0,0 +1,59 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+// -- Standard Library --
+#include <cstdint>
+#include <span>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Vertex;
+	struct Meshlet;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Vertex Cache Statistics
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct VertexCacheStats
+	{
+		uint32_t triangleCount{};
+		uint32_t vertexCount{};		// unique vertices referenced
+		uint32_t missCount{};
+
+		// -- Average Cache Miss Ratio, transformed vertices per triangle --
+		float GetACMR() const;
+		// -- Average Transformed to Vertex Ratio, 1 is ideal --
+		float GetATVR() const;
+		VertexCacheStats& operator+=(const VertexCacheStats& other);
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Mesh Optimizer
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class MeshOptimizer final
+	{
+	public:
+		//--------------------------------------------------
+		//    Optimization
+		//--------------------------------------------------
+		// Tipsify, reorders triangles so recently transformed vertices get reused
+		static void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount);
+		// Sorts the clusters so outward facing ones on the hull are drawn first, triangles inside a cluster keep their order
+		static void OptimizeOverdraw(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::span<Meshlet> meshlets);
+		// Renumbers vertices in first use order, indices holds every range drawing from these vertices
+		static void OptimizeVertexFetch(std::span<Vertex> vertices, std::span<uint32_t> indices);
+
+		//--------------------------------------------------
+		//    Analysis
+		//--------------------------------------------------
+		// Simulates a FIFO post-transform cache of CACHE_SIZE entries
+		static VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount);
+
+		static constexpr uint32_t CACHE_SIZE{ 16 };
+	};
+}
+
+#endif // MESH_OPTIMIZER_H
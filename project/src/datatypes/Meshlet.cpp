@@ -0,0 +1,186 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// -- Pompeii Includes --
+#include "Meshlet.h"
+#include "Mesh.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Meshlet Builder
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Building
+//--------------------------------------------------
+void pompeii::MeshletBuilder::Build(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::vector<Meshlet>& vMeshlets)
+{
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0)
+		return;
+
+	// -- Vertex to Triangle Adjacency --
+	std::vector<uint32_t> vAdjacencyOffsets(vertices.size() + 1, 0);
+	for (uint32_t index : indices)
+		++vAdjacencyOffsets[index + 1];
+	for (size_t vIdx{ 1 }; vIdx < vAdjacencyOffsets.size(); ++vIdx)
+		vAdjacencyOffsets[vIdx] += vAdjacencyOffsets[vIdx - 1];
+	std::vector<uint32_t> vAdjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> vFill(vAdjacencyOffsets.begin(), vAdjacencyOffsets.end() - 1);
+		for (uint32_t tIdx{}; tIdx < triangleCount * 3; ++tIdx)
+			vAdjacency[vFill[indices[tIdx]]++] = tIdx / 3;
+	}
+
+	std::vector<glm::vec3> vCentroids(triangleCount);
+	for (uint32_t tIdx{}; tIdx < triangleCount; ++tIdx)
+		vCentroids[tIdx] = (vertices[indices[tIdx * 3]].position + vertices[indices[tIdx * 3 + 1]].position + vertices[indices[tIdx * 3 + 2]].position) / 3.f;
+
+	// -- Grow Clusters --
+	std::vector<bool> vUsed(triangleCount, false);
+	std::vector<uint32_t> vFrontierStamp(triangleCount, 0);
+	std::vector<uint32_t> vFrontier{};
+	std::vector<uint32_t> vCluster{};
+	std::vector<uint32_t> vReordered{};
+	vReordered.reserve(indices.size());
+
+	uint32_t seedCursor{};
+	uint32_t stamp{};
+	while (true)
+	{
+		while (seedCursor < triangleCount && vUsed[seedCursor])
+			++seedCursor;
+		if (seedCursor == triangleCount)
+			break;
+
+		++stamp;
+		vFrontier.clear();
+		vCluster.clear();
+		glm::vec3 centroidSum{ 0.f };
+
+		uint32_t next = seedCursor;
+		while (true)
+		{
+			vUsed[next] = true;
+			vCluster.push_back(next);
+			centroidSum += vCentroids[next];
+			if (vCluster.size() == MAX_TRIANGLES)
+				break;
+
+			// Triangles sharing a vertex with the new one become candidates
+			for (uint32_t cIdx{}; cIdx < 3; ++cIdx)
+			{
+				const uint32_t vertex = indices[next * 3 + cIdx];
+				for (uint32_t aIdx{ vAdjacencyOffsets[vertex] }; aIdx < vAdjacencyOffsets[vertex + 1]; ++aIdx)
+				{
+					const uint32_t neighbour = vAdjacency[aIdx];
+					if (vUsed[neighbour] || vFrontierStamp[neighbour] == stamp)
+						continue;
+					vFrontierStamp[neighbour] = stamp;
+					vFrontier.push_back(neighbour);
+				}
+			}
+
+			// Pick the candidate closest to the cluster so clusters stay round
+			const glm::vec3 clusterCenter = centroidSum / static_cast<float>(vCluster.size());
+			float bestDistance = std::numeric_limits<float>::max();
+			size_t bestIdx = vFrontier.size();
+			for (size_t fIdx{}; fIdx < vFrontier.size(); ++fIdx)
+			{
+				const glm::vec3 delta = vCentroids[vFrontier[fIdx]] - clusterCenter;
+				const float distance = glm::dot(delta, delta);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIdx = fIdx;
+				}
+			}
+
+			if (bestIdx < vFrontier.size())
+			{
+				next = vFrontier[bestIdx];
+				vFrontier[bestIdx] = vFrontier.back();
+				vFrontier.pop_back();
+				continue;
+			}
+
+			// Disconnected pieces, keep filling small clusters with the next triangles in file order
+			if (vCluster.size() >= MIN_TRIANGLES)
+				break;
+			while (seedCursor < triangleCount && vUsed[seedCursor])
+				++seedCursor;
+			if (seedCursor == triangleCount)
+				break;
+			next = seedCursor;
+		}
+
+		const uint32_t indexOffset = static_cast<uint32_t>(vReordered.size());
+		for (uint32_t triangle : vCluster)
+			vReordered.insert(vReordered.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+		vMeshlets.push_back(ComputeBounds(vertices, std::span<const uint32_t>(vReordered).subspan(indexOffset), indexOffset));
+	}
+
+	std::ranges::copy(vReordered, indices.begin());
+}
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+pompeii::Meshlet pompeii::MeshletBuilder::ComputeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t indexOffset)
+{
+	Meshlet meshlet{};
+	meshlet.indexOffset = indexOffset;
+	meshlet.indexCount = static_cast<uint32_t>(indices.size());
+
+	// -- Sphere --
+	AABB bounds{};
+	for (uint32_t index : indices)
+		bounds.GrowToInclude(vertices[index].position);
+	meshlet.center = (bounds.min + bounds.max) * 0.5f;
+	for (uint32_t index : indices)
+		meshlet.radius = std::max(meshlet.radius, glm::length(vertices[index].position - meshlet.center));
+
+	// -- Normal Cone --
+	// Face normals are flipped to agree with the vertex normals, so the cone always points out
+	std::vector<glm::vec3> vNormals{};
+	vNormals.reserve(indices.size() / 3);
+	glm::vec3 axis{ 0.f };
+	for (size_t tIdx{}; tIdx + 2 < indices.size(); tIdx += 3)
+	{
+		const Vertex& v0 = vertices[indices[tIdx]];
+		const Vertex& v1 = vertices[indices[tIdx + 1]];
+		const Vertex& v2 = vertices[indices[tIdx + 2]];
+		glm::vec3 normal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+		const float length = glm::length(normal);
+		if (length <= 0.f)
+			continue;
+		normal /= length;
+
+		const float side = glm::dot(normal, v0.normal + v1.normal + v2.normal);
+		if (side == 0.f)
+		{
+			meshlet.coneCutoff = 1.f;
+			return meshlet;
+		}
+		if (side < 0.f)
+			normal = -normal;
+		vNormals.push_back(normal);
+		axis += normal;
+	}
+
+	meshlet.coneCutoff = 1.f;
+	const float axisLength = glm::length(axis);
+	if (axisLength <= 0.f)
+		return meshlet;
+	meshlet.coneAxis = axis / axisLength;
+
+	float minDot = 1.f;
+	for (const glm::vec3& normal : vNormals)
+		minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+	// Wide cones are almost never fully back facing, skip the test instead
+	if (minDot > 0.1f)
+		meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+	return meshlet;
+}
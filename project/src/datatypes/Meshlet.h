@@ -0,0 +1,60 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+// -- Standard Library --
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// -- Math Includes --
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_LEFT_HANDED
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Vertex;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Meshlet
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Spatially compact cluster of triangles, the GPU culler tests its bounds against every view and draws it on its own
+	struct Meshlet
+	{
+		// -- Range inside the owning SubMesh's indices --
+		uint32_t indexOffset;
+		uint32_t indexCount;
+
+		// -- Bounds, in SubMesh space --
+		glm::vec3 center;
+		float radius;
+		glm::vec3 coneAxis;
+		float coneCutoff;		// sine of the cone angle, 1 means the cluster can't be back face culled
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Meshlet Builder
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class MeshletBuilder final
+	{
+	public:
+		//--------------------------------------------------
+		//    Building
+		//--------------------------------------------------
+		// Reorders the triangles in indices so every Meshlet is a contiguous range
+		static void Build(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::vector<Meshlet>& vMeshlets);
+
+		static constexpr uint32_t MIN_TRIANGLES{ 64 };
+		static constexpr uint32_t MAX_TRIANGLES{ 128 };
+
+	private:
+		static Meshlet ComputeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t indexOffset);
+	};
+}
+
+#endif // MESHLET_H
@@ -17,6 +17,12 @@ namespace pompeii
     {
         Light* light;
     };
+    struct DrawItem
+    {
+        Mesh* mesh;
+        const SubMesh* subMesh;
+        glm::mat4 model;
+    };
 }
 
 #endif // RENDER_INSTANCE_TYPE_H
\ No newline at end of file
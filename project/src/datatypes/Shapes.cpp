@@ -14,3 +14,60 @@ void pompeii::AABB::GrowToInclude(const AABB& aabb)
 	min = glm::min(min, aabb.min);
 	max = glm::max(max, aabb.max);
 }
+pompeii::AABB pompeii::AABB::Transform(const glm::mat4& matrix) const
+{
+	// -- Arvo, the extent grows by the absolute of the rotation and scale --
+	const glm::vec3 center = (min + max) * 0.5f;
+	const glm::vec3 extent = (max - min) * 0.5f;
+	const glm::vec3 worldCenter = matrix * glm::vec4(center, 1.f);
+	const glm::mat3 absMatrix{ glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])), glm::abs(glm::vec3(matrix[2])) };
+	const glm::vec3 worldExtent = absMatrix * extent;
+	return { worldCenter - worldExtent, worldCenter + worldExtent };
+}
+
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Frustum	
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::Frustum pompeii::Frustum::FromMatrix(const glm::mat4& viewProj)
+{
+	// -- Gribb-Hartmann, depth is in [0, 1] --
+	const glm::vec4 row0{ viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0] };
+	const glm::vec4 row1{ viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1] };
+	const glm::vec4 row2{ viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2] };
+	const glm::vec4 row3{ viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3] };
+
+	Frustum frustum{};
+	frustum.planes[0] = row3 + row0;
+	frustum.planes[1] = row3 - row0;
+	frustum.planes[2] = row3 + row1;
+	frustum.planes[3] = row3 - row1;
+	frustum.planes[4] = row2;
+	frustum.planes[5] = row3 - row2;
+	for (glm::vec4& plane : frustum.planes)
+		plane /= glm::length(glm::vec3(plane));
+	return frustum;
+}
+bool pompeii::Frustum::Intersects(const glm::vec3& center, float radius) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
+bool pompeii::Frustum::Intersects(const AABB& aabb) const
+{
+	const glm::vec3 center = (aabb.min + aabb.max) * 0.5f;
+	const glm::vec3 extent = (aabb.max - aabb.min) * 0.5f;
+	for (const glm::vec4& plane : planes)
+	{
+		// -- Distance of the corner furthest along the plane normal --
+		const float radius = glm::dot(extent, glm::abs(glm::vec3(plane)));
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
@@ -19,6 +19,21 @@ namespace pompeii
 
 		void GrowToInclude(const glm::vec3& p);
 		void GrowToInclude(const AABB& aabb);
+		// Box around this one after transforming it, loose under rotation but never too small
+		AABB Transform(const glm::mat4& matrix) const;
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Frustum	
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct Frustum
+	{
+		// -- Inward facing planes, xyz is the normal and w the distance --
+		glm::vec4 planes[6]{};
+
+		static Frustum FromMatrix(const glm::mat4& viewProj);
+		bool Intersects(const glm::vec3& center, float radius) const;
+		bool Intersects(const AABB& aabb) const;
 	};
 }
 
@@ -0,0 +1,183 @@
+// -- Standard Library --
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <optional>
+
+// -- Pompeii Includes --
+#include "TextureRegistry.h"
+#include "ThreadPool.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Texture Registry
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Registry
+//--------------------------------------------------
+uint32_t pompeii::TextureRegistry::Acquire(const std::string& path, VkFormat format)
+{
+	const std::string key = MakeKey(path, format);
+	std::scoped_lock lock{ m_Mutex };
+
+	// -- Shared --
+	if (const auto it = m_KeyToIndex.find(key); it != m_KeyToIndex.end())
+	{
+		Entry& entry = m_vEntries[it->second];
+		if (entry.refCount++ == 0 && entry.pTexture)
+			++m_Version;
+		// A texture that failed to decode is tried again for whoever asks next
+		if (entry.failed)
+		{
+			entry.failed = false;
+			entry.pending = true;
+		}
+		return it->second;
+	}
+
+	// -- New, reusing a freed slot keeps the indices dense --
+	uint32_t index{};
+	if (!m_vFreeSlots.empty())
+	{
+		index = m_vFreeSlots.back();
+		m_vFreeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_vEntries.size());
+		m_vEntries.emplace_back();
+	}
+	Entry& entry = m_vEntries[index];
+	entry.path = path;
+	entry.key = key;
+	entry.format = format;
+	entry.refCount = 1;
+	entry.pending = true;
+	m_KeyToIndex.emplace(key, index);
+	return index;
+}
+void pompeii::TextureRegistry::Release(uint32_t index)
+{
+	std::scoped_lock lock{ m_Mutex };
+	if (index >= m_vEntries.size() || m_vEntries[index].refCount == 0)
+		return;
+
+	Entry& entry = m_vEntries[index];
+	if (--entry.refCount == 0)
+		entry.releasedVersion = ++m_Version;
+}
+void pompeii::TextureRegistry::DecodePending()
+{
+	// -- Claim the Pending Entries, other threads won't decode them again --
+	std::vector<uint32_t> vClaimed{};
+	std::vector<std::pair<std::string, VkFormat>> vRequests{};
+	{
+		std::scoped_lock lock{ m_Mutex };
+		for (uint32_t index{}; index < m_vEntries.size(); ++index)
+		{
+			Entry& entry = m_vEntries[index];
+			if (!entry.pending)
+				continue;
+			entry.pending = false;
+			entry.decoding = true;
+			vClaimed.push_back(index);
+			vRequests.emplace_back(entry.path, entry.format);
+		}
+	}
+
+	// -- Decode Concurrently --
+	std::vector<std::optional<Texture>> vDecoded(vRequests.size());
+	const auto decode = [&](uint32_t index)
+		{
+			const auto& [path, format] = vRequests[index];
+			vDecoded[index].emplace(path, format);
+		};
+	std::exception_ptr pError{};
+	try
+	{
+		GetDecodePool().ParallelFor(static_cast<uint32_t>(vRequests.size()), decode);
+	}
+	catch (...)
+	{
+		pError = std::current_exception();
+	}
+
+	// -- Publish, claims that failed to decode are marked so nobody waits on them forever, their references stay with the meshes holding them --
+	std::unique_lock lock{ m_Mutex };
+	if (!vClaimed.empty())
+	{
+		for (uint32_t claimIdx{}; claimIdx < vClaimed.size(); ++claimIdx)
+		{
+			Entry& entry = m_vEntries[vClaimed[claimIdx]];
+			entry.decoding = false;
+			if (vDecoded[claimIdx])
+				entry.pTexture = std::make_unique<Texture>(std::move(*vDecoded[claimIdx]));
+			else
+				entry.failed = true;
+		}
+		++m_Version;
+		m_DecodedCondition.notify_all();
+	}
+	if (pError)
+		std::rethrow_exception(pError);
+
+	// -- Textures shared with a mesh loading on another thread may still be decoding there --
+	m_DecodedCondition.wait(lock, []
+		{
+			return std::ranges::none_of(m_vEntries, &Entry::decoding);
+		});
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+std::vector<pompeii::Texture*> pompeii::TextureRegistry::GetTextures()
+{
+	std::scoped_lock lock{ m_Mutex };
+	std::vector<Texture*> vTextures(m_vEntries.size(), nullptr);
+	for (uint32_t index{}; index < m_vEntries.size(); ++index)
+	{
+		if (m_vEntries[index].refCount > 0)
+			vTextures[index] = m_vEntries[index].pTexture.get();
+	}
+	return vTextures;
+}
+uint64_t pompeii::TextureRegistry::GetVersion()
+{
+	std::scoped_lock lock{ m_Mutex };
+	return m_Version;
+}
+void pompeii::TextureRegistry::CollectReleased(uint64_t version)
+{
+	std::scoped_lock lock{ m_Mutex };
+	for (uint32_t index{}; index < m_vEntries.size(); ++index)
+	{
+		Entry& entry = m_vEntries[index];
+		if (entry.key.empty() || entry.refCount > 0 || entry.releasedVersion > version || entry.pending || entry.decoding)
+			continue;
+
+		m_KeyToIndex.erase(entry.key);
+		entry = Entry{};
+		m_vFreeSlots.push_back(index);
+	}
+}
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+std::string pompeii::TextureRegistry::MakeKey(const std::string& path, VkFormat format)
+{
+	// -- Different spellings of the same file share one entry --
+	std::error_code error{};
+	std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+	if (error)
+		canonical = std::filesystem::path(path).lexically_normal();
+	return canonical.generic_string() + "|" + std::to_string(static_cast<int32_t>(format));
+}
+pompeii::ThreadPool& pompeii::TextureRegistry::GetDecodePool()
+{
+	// -- Started by the first decode, joined at exit --
+	static ThreadPool decodePool{};
+	return decodePool;
+}
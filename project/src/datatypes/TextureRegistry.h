@@ -0,0 +1,80 @@
+#ifndef TEXTURE_REGISTRY_H
+#define TEXTURE_REGISTRY_H
+
+// -- Vulkan Includes --
+#include <vulkan/vulkan.h>
+
+// -- Standard Library --
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Material.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class ThreadPool;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Texture Registry
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class TextureRegistry final
+	{
+	public:
+		//--------------------------------------------------
+		//    Registry
+		//--------------------------------------------------
+		// Index of the texture for the canonical path and format, loaded once no matter how many meshes share it
+		static uint32_t Acquire(const std::string& path, VkFormat format);
+		// Drops one reference, the slot is freed by CollectReleased once nothing uses it anymore
+		static void Release(uint32_t index);
+		// Decodes everything acquired so far in parallel, returns once all of it is loaded.
+		// Rethrows the first decode that failed, the failed entries keep their references and stay empty until acquired again
+		static void DecodePending();
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		// Textures in index order, nullptr for slots that are free, released or still decoding
+		static std::vector<Texture*> GetTextures();
+		// Changes every time the result of GetTextures would
+		static uint64_t GetVersion();
+		// Frees textures released up to version, those may no longer be referenced by anything
+		static void CollectReleased(uint64_t version);
+
+	private:
+		struct Entry
+		{
+			std::string path{};
+			std::string key{};
+			VkFormat format{};
+			std::unique_ptr<Texture> pTexture{};
+			uint32_t refCount{};
+			uint64_t releasedVersion{};
+			bool pending{};
+			bool decoding{};
+			bool failed{};
+		};
+
+		static std::string MakeKey(const std::string& path, VkFormat format);
+		// Workers of the registry's own, decodes never queue behind frame work and work before any Renderer exists
+		static ThreadPool& GetDecodePool();
+
+		inline static std::vector<Entry>						m_vEntries		{ };
+		inline static std::vector<uint32_t>						m_vFreeSlots	{ };
+		inline static std::unordered_map<std::string, uint32_t>	m_KeyToIndex	{ };
+		inline static uint64_t									m_Version		{ };
+		inline static std::mutex								m_Mutex			{ };
+		inline static std::condition_variable					m_DecodedCondition{ };
+	};
+}
+
+#endif // TEXTURE_REGISTRY_H
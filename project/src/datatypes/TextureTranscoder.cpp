@@ -0,0 +1,882 @@
+// -- Standard Library --
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cfloat>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "TextureTranscoder.h"
+
+// -- Texture Includes --
+#include "stb_image.h"
+
+namespace
+{
+	//--------------------------------------------------
+	//    DDS
+	//--------------------------------------------------
+	constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(a))		|
+			   static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8	|
+			   static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16	|
+			   static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24;
+	}
+	constexpr uint32_t DDS_MAGIC				{ MakeFourCC('D', 'D', 'S', ' ') };
+	constexpr uint32_t DDSD_CAPS				{ 0x1 };
+	constexpr uint32_t DDSD_HEIGHT				{ 0x2 };
+	constexpr uint32_t DDSD_WIDTH				{ 0x4 };
+	constexpr uint32_t DDSD_PIXELFORMAT			{ 0x1000 };
+	constexpr uint32_t DDSD_MIPMAPCOUNT			{ 0x20000 };
+	constexpr uint32_t DDSD_LINEARSIZE			{ 0x80000 };
+	constexpr uint32_t DDPF_FOURCC				{ 0x4 };
+	constexpr uint32_t DDPF_RGB					{ 0x40 };
+	constexpr uint32_t DDSCAPS_COMPLEX			{ 0x8 };
+	constexpr uint32_t DDSCAPS_TEXTURE			{ 0x1000 };
+	constexpr uint32_t DDSCAPS_MIPMAP			{ 0x400000 };
+	constexpr uint32_t DDSCAPS2_CUBEMAP			{ 0x200 };
+	constexpr uint32_t DDS_DIMENSION_TEXTURE2D	{ 3 };
+
+	struct DDSPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rMask;
+		uint32_t gMask;
+		uint32_t bMask;
+		uint32_t aMask;
+	};
+	struct DDSHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DDSPixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+	struct DDSHeaderDX10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+	static_assert(sizeof(DDSHeader) == 124, "DDS header must match the file layout!");
+
+	struct DXGIMapping
+	{
+		uint32_t dxgiFormat;
+		VkFormat format;
+	};
+	constexpr std::array DXGI_MAPPINGS
+	{
+		DXGIMapping{ 28, VK_FORMAT_R8G8B8A8_UNORM },
+		DXGIMapping{ 29, VK_FORMAT_R8G8B8A8_SRGB },
+		DXGIMapping{ 71, VK_FORMAT_BC1_RGBA_UNORM_BLOCK },
+		DXGIMapping{ 72, VK_FORMAT_BC1_RGBA_SRGB_BLOCK },
+		DXGIMapping{ 77, VK_FORMAT_BC3_UNORM_BLOCK },
+		DXGIMapping{ 78, VK_FORMAT_BC3_SRGB_BLOCK },
+		DXGIMapping{ 80, VK_FORMAT_BC4_UNORM_BLOCK },
+		DXGIMapping{ 83, VK_FORMAT_BC5_UNORM_BLOCK },
+		DXGIMapping{ 98, VK_FORMAT_BC7_UNORM_BLOCK },
+		DXGIMapping{ 99, VK_FORMAT_BC7_SRGB_BLOCK },
+	};
+	VkFormat FromDXGI(uint32_t dxgiFormat)
+	{
+		for (const DXGIMapping& mapping : DXGI_MAPPINGS)
+			if (mapping.dxgiFormat == dxgiFormat)
+				return mapping.format;
+		return VK_FORMAT_UNDEFINED;
+	}
+	uint32_t ToDXGI(VkFormat format)
+	{
+		// -- BC1 without alpha is stored as its RGBA counterpart --
+		if (format == VK_FORMAT_BC1_RGB_UNORM_BLOCK) format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		if (format == VK_FORMAT_BC1_RGB_SRGB_BLOCK) format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+		for (const DXGIMapping& mapping : DXGI_MAPPINGS)
+			if (mapping.format == format)
+				return mapping.dxgiFormat;
+		return 0;
+	}
+
+	//--------------------------------------------------
+	//    KTX2
+	//--------------------------------------------------
+	constexpr uint8_t KTX2_IDENTIFIER[12]{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+	struct KTX2Header
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+	struct KTX2Level
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+	static_assert(sizeof(KTX2Header) == 80, "KTX2 header must match the file layout!");
+
+	//--------------------------------------------------
+	//    Files
+	//--------------------------------------------------
+	std::vector<uint8_t> ReadFile(const std::string& path)
+	{
+		std::ifstream file{ path, std::ios::binary | std::ios::ate };
+		if (!file)
+			throw std::runtime_error("Failed to load Texture: " + path);
+
+		std::vector<uint8_t> vBytes(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(vBytes.data()), static_cast<std::streamsize>(vBytes.size()));
+		return vBytes;
+	}
+
+	//--------------------------------------------------
+	//    Block Encoding
+	//--------------------------------------------------
+	class BitWriter final
+	{
+	public:
+		explicit BitWriter(uint8_t* pData) : m_pData{ pData } {}
+		void Write(uint32_t value, uint32_t count)
+		{
+			for (uint32_t bit{}; bit < count; ++bit, ++m_Bit)
+				if ((value >> bit) & 1u)
+					m_pData[m_Bit >> 3] |= static_cast<uint8_t>(1u << (m_Bit & 7u));
+		}
+
+	private:
+		uint8_t* m_pData;
+		uint32_t m_Bit{};
+	};
+
+	void FetchBlock(const uint8_t* pRGBA, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* pBlock)
+	{
+		for (uint32_t y{}; y < 4; ++y)
+		{
+			const uint32_t srcY = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x{}; x < 4; ++x)
+			{
+				const uint32_t srcX = std::min(blockX * 4 + x, width - 1);
+				std::memcpy(pBlock + (y * 4 + x) * 4, pRGBA + (static_cast<size_t>(srcY) * width + srcX) * 4, 4);
+			}
+		}
+	}
+
+	// Fits a line through the block along its principal axis and returns the extremes of the projected pixels
+	void ComputeEndpoints(const uint8_t* pBlock, uint32_t channels, float* pLow, float* pHigh)
+	{
+		float mean[4]{};
+		for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+			for (uint32_t c{}; c < channels; ++c)
+				mean[c] += pBlock[pIdx * 4 + c] / 16.f;
+
+		float covariance[4][4]{};
+		for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+			for (uint32_t r{}; r < channels; ++r)
+				for (uint32_t c{}; c < channels; ++c)
+					covariance[r][c] += (pBlock[pIdx * 4 + r] - mean[r]) * (pBlock[pIdx * 4 + c] - mean[c]);
+
+		// -- Power Iteration --
+		float axis[4]{ 1.f, 1.f, 1.f, 1.f };
+		for (uint32_t iteration{}; iteration < 8; ++iteration)
+		{
+			float next[4]{};
+			float length{};
+			for (uint32_t r{}; r < channels; ++r)
+			{
+				for (uint32_t c{}; c < channels; ++c)
+					next[r] += covariance[r][c] * axis[c];
+				length += next[r] * next[r];
+			}
+			if (length < FLT_EPSILON)
+				break;
+			length = std::sqrt(length);
+			for (uint32_t c{}; c < channels; ++c)
+				axis[c] = next[c] / length;
+		}
+
+		float minT{ FLT_MAX };
+		float maxT{ -FLT_MAX };
+		for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+		{
+			float t{};
+			for (uint32_t c{}; c < channels; ++c)
+				t += (pBlock[pIdx * 4 + c] - mean[c]) * axis[c];
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		float axisLengthSq{};
+		for (uint32_t c{}; c < channels; ++c)
+			axisLengthSq += axis[c] * axis[c];
+		if (axisLengthSq > FLT_EPSILON)
+		{
+			minT /= axisLengthSq;
+			maxT /= axisLengthSq;
+		}
+		for (uint32_t c{}; c < channels; ++c)
+		{
+			pLow[c] = std::clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+			pHigh[c] = std::clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+		}
+	}
+
+	uint16_t PackRGB565(const float* pColor)
+	{
+		const uint32_t r = static_cast<uint32_t>(std::lround(pColor[0] * 31.f / 255.f));
+		const uint32_t g = static_cast<uint32_t>(std::lround(pColor[1] * 63.f / 255.f));
+		const uint32_t b = static_cast<uint32_t>(std::lround(pColor[2] * 31.f / 255.f));
+		return static_cast<uint16_t>(r << 11 | g << 5 | b);
+	}
+	void UnpackRGB565(uint16_t color, int* pColor)
+	{
+		const int r = (color >> 11) & 31;
+		const int g = (color >> 5) & 63;
+		const int b = color & 31;
+		pColor[0] = (r << 3) | (r >> 2);
+		pColor[1] = (g << 2) | (g >> 4);
+		pColor[2] = (b << 3) | (b >> 2);
+	}
+
+	//--------------------------------------------------
+	//    Mip Generation
+	//--------------------------------------------------
+	float SRGBToLinear(uint8_t value)
+	{
+		static const std::array<float, 256> table = []
+			{
+				std::array<float, 256> result{};
+				for (uint32_t index{}; index < 256; ++index)
+				{
+					const float c = index / 255.f;
+					result[index] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				return result;
+			}();
+		return table[value];
+	}
+	uint8_t LinearToSRGB(float value)
+	{
+		const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+		return static_cast<uint8_t>(std::lround(std::clamp(c, 0.f, 1.f) * 255.f));
+	}
+
+	std::vector<uint8_t> Downsample(const std::vector<uint8_t>& vSource, uint32_t width, uint32_t height, bool isSRGB, bool isNormalMap)
+	{
+		const uint32_t dstWidth = std::max(width / 2, 1u);
+		const uint32_t dstHeight = std::max(height / 2, 1u);
+		std::vector<uint8_t> vResult(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+		for (uint32_t y{}; y < dstHeight; ++y)
+		{
+			for (uint32_t x{}; x < dstWidth; ++x)
+			{
+				float sum[4]{};
+				for (uint32_t sy{}; sy < 2; ++sy)
+				{
+					for (uint32_t sx{}; sx < 2; ++sx)
+					{
+						const uint32_t srcX = std::min(x * 2 + sx, width - 1);
+						const uint32_t srcY = std::min(y * 2 + sy, height - 1);
+						const uint8_t* pSrc = vSource.data() + (static_cast<size_t>(srcY) * width + srcX) * 4;
+						for (uint32_t c{}; c < 4; ++c)
+							sum[c] += (isSRGB && c < 3) ? SRGBToLinear(pSrc[c]) : pSrc[c] / 255.f;
+					}
+				}
+				for (float& s : sum)
+					s *= 0.25f;
+
+				// -- Keep tangent space normals unit length --
+				if (isNormalMap)
+				{
+					float n[3]{ sum[0] * 2.f - 1.f, sum[1] * 2.f - 1.f, sum[2] * 2.f - 1.f };
+					const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+					if (length > FLT_EPSILON)
+						for (uint32_t c{}; c < 3; ++c)
+							sum[c] = n[c] / length * 0.5f + 0.5f;
+				}
+
+				uint8_t* pDst = vResult.data() + (static_cast<size_t>(y) * dstWidth + x) * 4;
+				for (uint32_t c{}; c < 4; ++c)
+					pDst[c] = (isSRGB && c < 3) ? LinearToSRGB(sum[c]) : static_cast<uint8_t>(std::lround(std::clamp(sum[c], 0.f, 1.f) * 255.f));
+			}
+		}
+		return vResult;
+	}
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Texture Transcoder
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Containers
+//--------------------------------------------------
+bool pompeii::TextureTranscoder::IsContainerPath(const std::string& path)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::ranges::transform(extension, extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	return extension == ".ktx2" || extension == ".dds";
+}
+pompeii::TextureFileData pompeii::TextureTranscoder::ReadContainer(const std::string& path)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::ranges::transform(extension, extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	return extension == ".ktx2" ? ReadKTX2(path) : ReadDDS(path);
+}
+pompeii::TextureFileData pompeii::TextureTranscoder::ReadKTX2(const std::string& path)
+{
+	const std::vector<uint8_t> vFile = ReadFile(path);
+
+	// -- Header --
+	KTX2Header header{};
+	if (vFile.size() < sizeof(KTX2Header))
+		throw std::runtime_error("Invalid KTX2 file: " + path);
+	std::memcpy(&header, vFile.data(), sizeof(KTX2Header));
+	if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+		throw std::runtime_error("Invalid KTX2 file: " + path);
+	if (header.supercompressionScheme != 0)
+		throw std::runtime_error("Supercompressed KTX2 files are not supported: " + path);
+	if (header.faceCount != 1 || header.layerCount > 1 || header.pixelDepth > 1)
+		throw std::runtime_error("Only single 2D KTX2 textures are supported: " + path);
+
+	TextureFileData result{};
+	result.format = static_cast<VkFormat>(header.vkFormat);
+	result.width = header.pixelWidth;
+	result.height = header.pixelHeight;
+	if (!IsBlockCompressed(result.format) && result.format != VK_FORMAT_R8G8B8A8_UNORM && result.format != VK_FORMAT_R8G8B8A8_SRGB)
+		throw std::runtime_error("Unsupported KTX2 format: " + path);
+
+	// -- Levels --
+	const uint32_t levelCount = std::max(header.levelCount, 1u);
+	if (vFile.size() < sizeof(KTX2Header) + levelCount * sizeof(KTX2Level))
+		throw std::runtime_error("Invalid KTX2 file: " + path);
+
+	for (uint32_t level{}; level < levelCount; ++level)
+	{
+		KTX2Level levelInfo{};
+		std::memcpy(&levelInfo, vFile.data() + sizeof(KTX2Header) + level * sizeof(KTX2Level), sizeof(KTX2Level));
+		if (levelInfo.byteOffset > vFile.size() || levelInfo.byteLength > vFile.size() - levelInfo.byteOffset)
+			throw std::runtime_error("Invalid KTX2 file: " + path);
+
+		TextureMip& mip = result.vMips.emplace_back();
+		mip.offset = static_cast<uint32_t>(result.vData.size());
+		mip.size = static_cast<uint32_t>(levelInfo.byteLength);
+		mip.width = std::max(result.width >> level, 1u);
+		mip.height = std::max(result.height >> level, 1u);
+		result.vData.insert(result.vData.end(), vFile.begin() + static_cast<ptrdiff_t>(levelInfo.byteOffset),
+												vFile.begin() + static_cast<ptrdiff_t>(levelInfo.byteOffset + levelInfo.byteLength));
+	}
+	return result;
+}
+pompeii::TextureFileData pompeii::TextureTranscoder::ReadDDS(const std::string& path)
+{
+	const std::vector<uint8_t> vFile = ReadFile(path);
+
+	// -- Header --
+	uint32_t magic{};
+	DDSHeader header{};
+	if (vFile.size() < sizeof(uint32_t) + sizeof(DDSHeader))
+		throw std::runtime_error("Invalid DDS file: " + path);
+	std::memcpy(&magic, vFile.data(), sizeof(uint32_t));
+	std::memcpy(&header, vFile.data() + sizeof(uint32_t), sizeof(DDSHeader));
+	if (magic != DDS_MAGIC || header.size != sizeof(DDSHeader))
+		throw std::runtime_error("Invalid DDS file: " + path);
+	if (header.caps2 & DDSCAPS2_CUBEMAP)
+		throw std::runtime_error("Only single 2D DDS textures are supported: " + path);
+
+	// -- Format --
+	TextureFileData result{};
+	result.width = header.width;
+	result.height = header.height;
+	size_t dataOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+	if (header.pixelFormat.flags & DDPF_FOURCC)
+	{
+		switch (header.pixelFormat.fourCC)
+		{
+		case MakeFourCC('D', 'X', 'T', '1'): result.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK; break;
+		case MakeFourCC('D', 'X', 'T', '5'): result.format = VK_FORMAT_BC3_UNORM_BLOCK; break;
+		case MakeFourCC('A', 'T', 'I', '1'):
+		case MakeFourCC('B', 'C', '4', 'U'): result.format = VK_FORMAT_BC4_UNORM_BLOCK; break;
+		case MakeFourCC('A', 'T', 'I', '2'):
+		case MakeFourCC('B', 'C', '5', 'U'): result.format = VK_FORMAT_BC5_UNORM_BLOCK; break;
+		case MakeFourCC('D', 'X', '1', '0'):
+		{
+			DDSHeaderDX10 headerDX10{};
+			if (vFile.size() < dataOffset + sizeof(DDSHeaderDX10))
+				throw std::runtime_error("Invalid DDS file: " + path);
+			std::memcpy(&headerDX10, vFile.data() + dataOffset, sizeof(DDSHeaderDX10));
+			dataOffset += sizeof(DDSHeaderDX10);
+			if (headerDX10.resourceDimension != DDS_DIMENSION_TEXTURE2D || headerDX10.arraySize > 1)
+				throw std::runtime_error("Only single 2D DDS textures are supported: " + path);
+			result.format = FromDXGI(headerDX10.dxgiFormat);
+			break;
+		}
+		default: break;
+		}
+	}
+	else if ((header.pixelFormat.flags & DDPF_RGB) && header.pixelFormat.rgbBitCount == 32 &&
+			 header.pixelFormat.rMask == 0x000000FF && header.pixelFormat.gMask == 0x0000FF00 && header.pixelFormat.bMask == 0x00FF0000)
+	{
+		result.format = VK_FORMAT_R8G8B8A8_UNORM;
+	}
+	if (result.format == VK_FORMAT_UNDEFINED)
+		throw std::runtime_error("Unsupported DDS format: " + path);
+
+	// -- Mips, stored largest first and tightly packed --
+	const uint32_t mipCount = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mipMapCount, 1u) : 1u;
+	for (uint32_t level{}; level < mipCount; ++level)
+	{
+		TextureMip& mip = result.vMips.emplace_back();
+		mip.width = std::max(result.width >> level, 1u);
+		mip.height = std::max(result.height >> level, 1u);
+		mip.size = GetMipSize(result.format, mip.width, mip.height);
+		mip.offset = static_cast<uint32_t>(result.vData.size());
+		if (vFile.size() < dataOffset + mip.size)
+			throw std::runtime_error("Invalid DDS file: " + path);
+
+		result.vData.insert(result.vData.end(), vFile.begin() + static_cast<ptrdiff_t>(dataOffset),
+												vFile.begin() + static_cast<ptrdiff_t>(dataOffset + mip.size));
+		dataOffset += mip.size;
+	}
+	return result;
+}
+void pompeii::TextureTranscoder::WriteDDS(const std::string& path, const TextureFileData& data)
+{
+	const uint32_t dxgiFormat = ToDXGI(data.format);
+	if (dxgiFormat == 0)
+		throw std::runtime_error("Format can not be written to DDS: " + path);
+
+	DDSHeader header{};
+	header.size = sizeof(DDSHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.height = data.height;
+	header.width = data.width;
+	header.pitchOrLinearSize = data.vMips.empty() ? 0 : data.vMips.front().size;
+	header.mipMapCount = static_cast<uint32_t>(data.vMips.size());
+	header.pixelFormat.size = sizeof(DDSPixelFormat);
+	header.pixelFormat.flags = DDPF_FOURCC;
+	header.pixelFormat.fourCC = MakeFourCC('D', 'X', '1', '0');
+	header.caps = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+
+	DDSHeaderDX10 headerDX10{};
+	headerDX10.dxgiFormat = dxgiFormat;
+	headerDX10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+	headerDX10.arraySize = 1;
+
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	if (!file)
+		throw std::runtime_error("Failed to write Texture: " + path);
+	file.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(uint32_t));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(DDSHeader));
+	file.write(reinterpret_cast<const char*>(&headerDX10), sizeof(DDSHeaderDX10));
+	for (const TextureMip& mip : data.vMips)
+		file.write(reinterpret_cast<const char*>(data.vData.data() + mip.offset), mip.size);
+	if (!file)
+		throw std::runtime_error("Failed to write Texture: " + path);
+}
+
+//--------------------------------------------------
+//    Transcoding
+//--------------------------------------------------
+std::string pompeii::TextureTranscoder::GetCachePath(const std::string& sourcePath, VkFormat format)
+{
+	std::string suffix{};
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:		suffix = ".bc1";	break;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:			suffix = ".bc3";	break;
+	case VK_FORMAT_BC5_UNORM_BLOCK:			suffix = ".bc5";	break;
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:			suffix = ".bc7";	break;
+	default:								suffix = ".rgba8";	break;
+	}
+	if (IsSRGB(format))
+		suffix += "_srgb";
+	return sourcePath + suffix + ".dds";
+}
+bool pompeii::TextureTranscoder::IsCacheValid(const std::string& sourcePath, const std::string& cachePath)
+{
+	std::error_code ec;
+	const auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
+	if (ec)
+		return false;
+	const auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+	return !ec && cacheTime >= sourceTime;
+}
+void pompeii::TextureTranscoder::Transcode(const std::string& sourcePath, const std::string& cachePath, VkFormat format)
+{
+	int width{};
+	int height{};
+	int channels{};
+	stbi_uc* pPixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (!pPixels)
+		throw std::runtime_error("Failed to load Texture: " + sourcePath);
+
+	TextureFileData data{};
+	try
+	{
+		data = Encode(pPixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), format);
+	}
+	catch (...)
+	{
+		stbi_image_free(pPixels);
+		throw;
+	}
+	stbi_image_free(pPixels);
+
+	// -- Write through a temporary so a partial file never looks valid --
+	const std::string tempPath = cachePath + ".tmp";
+	WriteDDS(tempPath, data);
+	std::filesystem::rename(tempPath, cachePath);
+}
+pompeii::TextureFileData pompeii::TextureTranscoder::Encode(const uint8_t* pRGBA, uint32_t width, uint32_t height, VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		break;
+	default:
+		throw std::runtime_error("Unsupported Texture transcode target format!");
+	}
+
+	TextureFileData result{};
+	result.format = format;
+	result.width = width;
+	result.height = height;
+
+	const bool isSRGB = IsSRGB(format);
+	const bool isNormalMap = format == VK_FORMAT_BC5_UNORM_BLOCK;
+	const uint32_t blockSize = IsBlockCompressed(format) ? GetMipSize(format, 1, 1) : 0;
+	const uint32_t mipCount = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+	std::vector<uint8_t> vLevel(pRGBA, pRGBA + static_cast<size_t>(width) * height * 4);
+	uint32_t mipWidth = width;
+	uint32_t mipHeight = height;
+	for (uint32_t level{}; level < mipCount; ++level)
+	{
+		TextureMip& mip = result.vMips.emplace_back();
+		mip.offset = static_cast<uint32_t>(result.vData.size());
+		mip.size = GetMipSize(format, mipWidth, mipHeight);
+		mip.width = mipWidth;
+		mip.height = mipHeight;
+		result.vData.resize(static_cast<size_t>(mip.offset) + mip.size);
+
+		uint8_t* pDst = result.vData.data() + mip.offset;
+		if (blockSize == 0)
+			std::memcpy(pDst, vLevel.data(), mip.size);
+		else
+		{
+			uint8_t block[64];
+			for (uint32_t blockY{}; blockY < (mipHeight + 3) / 4; ++blockY)
+			{
+				for (uint32_t blockX{}; blockX < (mipWidth + 3) / 4; ++blockX)
+				{
+					FetchBlock(vLevel.data(), mipWidth, mipHeight, blockX, blockY, block);
+					switch (format)
+					{
+					case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+					case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+						EncodeBC1Block(block, pDst);
+						break;
+					case VK_FORMAT_BC3_UNORM_BLOCK:
+					case VK_FORMAT_BC3_SRGB_BLOCK:
+						EncodeBC4Block(block, 3, pDst);
+						EncodeBC1Block(block, pDst + 8);
+						break;
+					case VK_FORMAT_BC5_UNORM_BLOCK:
+						EncodeBC4Block(block, 0, pDst);
+						EncodeBC4Block(block, 1, pDst + 8);
+						break;
+					default:
+						EncodeBC7Block(block, pDst);
+						break;
+					}
+					pDst += blockSize;
+				}
+			}
+		}
+
+		// -- Next Mip --
+		if (level + 1 < mipCount)
+		{
+			vLevel = Downsample(vLevel, mipWidth, mipHeight, isSRGB, isNormalMap);
+			mipWidth = std::max(mipWidth / 2, 1u);
+			mipHeight = std::max(mipHeight / 2, 1u);
+		}
+	}
+	return result;
+}
+
+//--------------------------------------------------
+//    Format Helpers
+//--------------------------------------------------
+bool pompeii::TextureTranscoder::IsBlockCompressed(VkFormat format)
+{
+	return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+}
+bool pompeii::TextureTranscoder::IsSRGB(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_B8G8R8A8_SRGB:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return true;
+	default:
+		return false;
+	}
+}
+VkFormat pompeii::TextureTranscoder::ToSRGB(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8G8B8A8_UNORM:			return VK_FORMAT_R8G8B8A8_SRGB;
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:		return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:	return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+	case VK_FORMAT_BC2_UNORM_BLOCK:			return VK_FORMAT_BC2_SRGB_BLOCK;
+	case VK_FORMAT_BC3_UNORM_BLOCK:			return VK_FORMAT_BC3_SRGB_BLOCK;
+	case VK_FORMAT_BC7_UNORM_BLOCK:			return VK_FORMAT_BC7_SRGB_BLOCK;
+	default:								return format;
+	}
+}
+VkFormat pompeii::TextureTranscoder::GetUncompressedFallback(VkFormat format)
+{
+	if (!IsBlockCompressed(format))
+		return format;
+	return IsSRGB(format) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+}
+uint32_t pompeii::TextureTranscoder::GetMipSize(VkFormat format, uint32_t width, uint32_t height)
+{
+	if (!IsBlockCompressed(format))
+		return width * height * 4;
+
+	const bool isHalfBlock = format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK ||
+							 format == VK_FORMAT_BC4_UNORM_BLOCK || format == VK_FORMAT_BC4_SNORM_BLOCK;
+	return ((width + 3) / 4) * ((height + 3) / 4) * (isHalfBlock ? 8 : 16);
+}
+
+//--------------------------------------------------
+//    Block Encoders
+//--------------------------------------------------
+void pompeii::TextureTranscoder::EncodeBC1Block(const uint8_t* pBlock, uint8_t* pOut)
+{
+	float low[3];
+	float high[3];
+	ComputeEndpoints(pBlock, 3, low, high);
+
+	// -- Four color mode requires color0 > color1 --
+	uint16_t color0 = PackRGB565(high);
+	uint16_t color1 = PackRGB565(low);
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	uint32_t indices{};
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		UnpackRGB565(color0, palette[0]);
+		UnpackRGB565(color1, palette[1]);
+		for (uint32_t c{}; c < 3; ++c)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+		{
+			uint32_t bestIdx{};
+			int bestError{ INT32_MAX };
+			for (uint32_t entry{}; entry < 4; ++entry)
+			{
+				int error{};
+				for (uint32_t c{}; c < 3; ++c)
+				{
+					const int d = pBlock[pIdx * 4 + c] - palette[entry][c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIdx = entry;
+				}
+			}
+			indices |= bestIdx << (pIdx * 2);
+		}
+	}
+
+	pOut[0] = static_cast<uint8_t>(color0 & 0xFF);
+	pOut[1] = static_cast<uint8_t>(color0 >> 8);
+	pOut[2] = static_cast<uint8_t>(color1 & 0xFF);
+	pOut[3] = static_cast<uint8_t>(color1 >> 8);
+	for (uint32_t byte{}; byte < 4; ++byte)
+		pOut[4 + byte] = static_cast<uint8_t>(indices >> (byte * 8));
+}
+void pompeii::TextureTranscoder::EncodeBC4Block(const uint8_t* pBlock, uint32_t channel, uint8_t* pOut)
+{
+	uint8_t low{ 255 };
+	uint8_t high{ 0 };
+	for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+	{
+		low = std::min(low, pBlock[pIdx * 4 + channel]);
+		high = std::max(high, pBlock[pIdx * 4 + channel]);
+	}
+
+	// -- Eight value mode, index 0 is high, index 1 is low, 2-7 interpolate from high to low --
+	uint64_t indices{};
+	if (high != low)
+	{
+		for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+		{
+			const float t = static_cast<float>(pBlock[pIdx * 4 + channel] - low) / static_cast<float>(high - low);
+			const uint32_t step = static_cast<uint32_t>(std::lround(t * 7.f));
+			const uint32_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+			indices |= static_cast<uint64_t>(index) << (pIdx * 3);
+		}
+	}
+
+	pOut[0] = high;
+	pOut[1] = low;
+	for (uint32_t byte{}; byte < 6; ++byte)
+		pOut[2 + byte] = static_cast<uint8_t>(indices >> (byte * 8));
+}
+void pompeii::TextureTranscoder::EncodeBC7Block(const uint8_t* pBlock, uint8_t* pOut)
+{
+	// Mode 6: a single subset with 7.7.7.7 endpoints, a unique p-bit per endpoint and 4-bit indices
+	static constexpr uint32_t WEIGHTS[16]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	float low[4];
+	float high[4];
+	ComputeEndpoints(pBlock, 4, low, high);
+
+	auto Quantize = [](const float* pEndpoint, uint32_t* pQuantized, uint32_t& pBit)
+		{
+			float bestError{ FLT_MAX };
+			for (uint32_t p{}; p < 2; ++p)
+			{
+				uint32_t candidate[4];
+				float error{};
+				for (uint32_t c{}; c < 4; ++c)
+				{
+					candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((pEndpoint[c] - static_cast<float>(p)) / 2.f), 0l, 127l));
+					const float d = static_cast<float>(candidate[c] << 1 | p) - pEndpoint[c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					pBit = p;
+					std::copy_n(candidate, 4, pQuantized);
+				}
+			}
+		};
+	uint32_t endpoint0[4];
+	uint32_t endpoint1[4];
+	uint32_t pBit0{};
+	uint32_t pBit1{};
+	Quantize(low, endpoint0, pBit0);
+	Quantize(high, endpoint1, pBit1);
+
+	// -- Indices --
+	int palette[16][4];
+	for (uint32_t entry{}; entry < 16; ++entry)
+	{
+		for (uint32_t c{}; c < 4; ++c)
+		{
+			const int e0 = static_cast<int>(endpoint0[c] << 1 | pBit0);
+			const int e1 = static_cast<int>(endpoint1[c] << 1 | pBit1);
+			palette[entry][c] = ((64 - static_cast<int>(WEIGHTS[entry])) * e0 + static_cast<int>(WEIGHTS[entry]) * e1 + 32) >> 6;
+		}
+	}
+	uint32_t indices[16];
+	for (uint32_t pIdx{}; pIdx < 16; ++pIdx)
+	{
+		int bestError{ INT32_MAX };
+		for (uint32_t entry{}; entry < 16; ++entry)
+		{
+			int error{};
+			for (uint32_t c{}; c < 4; ++c)
+			{
+				const int d = pBlock[pIdx * 4 + c] - palette[entry][c];
+				error += d * d;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[pIdx] = entry;
+			}
+		}
+	}
+
+	// -- The anchor index has an implicit 0 msb, flip the endpoints if needed --
+	if (indices[0] >= 8)
+	{
+		std::swap(endpoint0, endpoint1);
+		std::swap(pBit0, pBit1);
+		for (uint32_t& index : indices)
+			index = 15 - index;
+	}
+
+	// -- Pack --
+	std::memset(pOut, 0, 16);
+	BitWriter writer{ pOut };
+	writer.Write(1u << 6, 7);
+	for (uint32_t c{}; c < 4; ++c)
+	{
+		writer.Write(endpoint0[c], 7);
+		writer.Write(endpoint1[c], 7);
+	}
+	writer.Write(pBit0, 1);
+	writer.Write(pBit1, 1);
+	writer.Write(indices[0], 3);
+	for (uint32_t pIdx{ 1 }; pIdx < 16; ++pIdx)
+		writer.Write(indices[pIdx], 4);
+}
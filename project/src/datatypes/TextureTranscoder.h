@@ -0,0 +1,72 @@
+#ifndef TEXTURE_TRANSCODER_H
+#define TEXTURE_TRANSCODER_H
+
+// -- Vulkan Includes --
+#include <vulkan/vulkan.h>
+
+// -- Standard Library --
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Texture File Data
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct TextureMip
+	{
+		uint32_t offset;
+		uint32_t size;
+		uint32_t width;
+		uint32_t height;
+	};
+	struct TextureFileData
+	{
+		VkFormat format{ VK_FORMAT_UNDEFINED };
+		uint32_t width{};
+		uint32_t height{};
+		std::vector<uint8_t> vData{};
+		std::vector<TextureMip> vMips{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Texture Transcoder
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class TextureTranscoder final
+	{
+	public:
+		//--------------------------------------------------
+		//    Containers
+		//--------------------------------------------------
+		static bool IsContainerPath(const std::string& path);
+		static TextureFileData ReadContainer(const std::string& path);
+		static TextureFileData ReadKTX2(const std::string& path);
+		static TextureFileData ReadDDS(const std::string& path);
+		static void WriteDDS(const std::string& path, const TextureFileData& data);
+
+		//--------------------------------------------------
+		//    Transcoding
+		//--------------------------------------------------
+		static std::string GetCachePath(const std::string& sourcePath, VkFormat format);
+		static bool IsCacheValid(const std::string& sourcePath, const std::string& cachePath);
+		static void Transcode(const std::string& sourcePath, const std::string& cachePath, VkFormat format);
+		static TextureFileData Encode(const uint8_t* pRGBA, uint32_t width, uint32_t height, VkFormat format);
+
+		//--------------------------------------------------
+		//    Format Helpers
+		//--------------------------------------------------
+		static bool IsBlockCompressed(VkFormat format);
+		static bool IsSRGB(VkFormat format);
+		static VkFormat ToSRGB(VkFormat format);
+		static VkFormat GetUncompressedFallback(VkFormat format);
+		static uint32_t GetMipSize(VkFormat format, uint32_t width, uint32_t height);
+
+	private:
+		static void EncodeBC1Block(const uint8_t* pBlock, uint8_t* pOut);
+		static void EncodeBC4Block(const uint8_t* pBlock, uint32_t channel, uint8_t* pOut);
+		static void EncodeBC7Block(const uint8_t* pBlock, uint8_t* pOut);
+	};
+}
+
+#endif // TEXTURE_TRANSCODER_H
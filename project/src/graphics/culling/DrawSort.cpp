@@ -0,0 +1,93 @@
+// -- Standard Library --
+#include <algorithm>
+#include <array>
+#include <bit>
+
+// -- Pompeii Includes --
+#include "DrawSort.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Draw Key
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+uint64_t pompeii::DrawKey::Make(DrawPass pass, uint32_t variant, uint32_t mesh, uint32_t material, float depth)
+{
+	const auto field = [](uint64_t value, uint32_t bits) { return value & ((uint64_t{ 1 } << bits) - 1); };
+
+	uint64_t key = field(static_cast<uint64_t>(pass), PASS_BITS);
+	key = key << VARIANT_BITS | field(variant, VARIANT_BITS);
+
+	// -- Depth only passes want early-Z, the Geometry Pass wants as few state changes as possible --
+	if (pass == DrawPass::Geometry)
+	{
+		key = key << MESH_BITS | field(mesh, MESH_BITS);
+		key = key << MATERIAL_BITS | field(material, MATERIAL_BITS);
+		key = key << DEPTH_BITS | field(QuantizeDepth(depth), DEPTH_BITS);
+	}
+	else
+	{
+		key = key << DEPTH_BITS | field(QuantizeDepth(depth), DEPTH_BITS);
+		key = key << MESH_BITS | field(mesh, MESH_BITS);
+		key = key << MATERIAL_BITS | field(material, MATERIAL_BITS);
+	}
+	return key;
+}
+uint32_t pompeii::DrawKey::QuantizeDepth(float depth)
+{
+	// -- Anything behind the view sorts first, it is culled anyway --
+	return std::bit_cast<uint32_t>(std::max(depth, 0.f)) >> (32 - DEPTH_BITS);
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Radix Sorter
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Sorting
+//--------------------------------------------------
+void pompeii::RadixSorter::Sort(std::vector<uint64_t>& vKeys, std::vector<uint32_t>& vValues)
+{
+	const size_t count = vKeys.size();
+	if (count < 2)
+		return;
+
+	// -- Every digit's histogram in a single read of the keys --
+	std::array<std::array<uint32_t, RADIX_SIZE>, DIGIT_COUNT> histograms{};
+	for (const uint64_t key : vKeys)
+	{
+		for (uint32_t digit{}; digit < DIGIT_COUNT; ++digit)
+			++histograms[digit][(key >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1)];
+	}
+
+	m_vKeyScratch.resize(count);
+	m_vValueScratch.resize(count);
+	for (uint32_t digit{}; digit < DIGIT_COUNT; ++digit)
+	{
+		std::array<uint32_t, RADIX_SIZE>& histogram = histograms[digit];
+
+		// -- All keys share this digit, scattering would not move anything --
+		const uint32_t firstKeyBucket = (vKeys.front() >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1);
+		if (histogram[firstKeyBucket] == count)
+			continue;
+
+		// -- Bucket offsets --
+		uint32_t offset{};
+		for (uint32_t& bucket : histogram)
+		{
+			const uint32_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+
+		// -- Scatter, in order so equal digits keep their relative order --
+		for (size_t idx{}; idx < count; ++idx)
+		{
+			const uint32_t dst = histogram[(vKeys[idx] >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+			m_vKeyScratch[dst] = vKeys[idx];
+			m_vValueScratch[dst] = vValues[idx];
+		}
+		vKeys.swap(m_vKeyScratch);
+		vValues.swap(m_vValueScratch);
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef DRAW_SORT_H
+#define DRAW_SORT_H
+
+// -- Standard Library --
+#include <cstdint>
+#include <vector>
+
+namespace pompeii
+{
+	// -- Which list a draw belongs to, decides how its key is laid out --
+	enum class DrawPass : uint8_t
+	{
+		DepthPrePass,
+		Geometry,
+		Shadow
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Draw Key
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// 64-bit sort key of one Sub Mesh draw, pass and pipeline variant always lead.
+	// Depth only passes put the quantized depth next for front-to-back order, the Geometry Pass groups by mesh and material first
+	struct DrawKey final
+	{
+		static uint64_t Make(DrawPass pass, uint32_t variant, uint32_t mesh, uint32_t material, float depth);
+		// Bit pattern of a non-negative float grows with its value, the top DEPTH_BITS keep the order
+		static uint32_t QuantizeDepth(float depth);
+
+		static constexpr uint32_t PASS_BITS{ 2 };
+		static constexpr uint32_t VARIANT_BITS{ 2 };
+		static constexpr uint32_t DEPTH_BITS{ 24 };
+		static constexpr uint32_t MESH_BITS{ 20 };
+		static constexpr uint32_t MATERIAL_BITS{ 16 };
+		static_assert(PASS_BITS + VARIANT_BITS + DEPTH_BITS + MESH_BITS + MATERIAL_BITS == 64);
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Radix Sorter
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// LSD radix sort over 8-bit digits, keeps its scratch memory so sorting every frame does not allocate
+	class RadixSorter final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit RadixSorter() = default;
+		~RadixSorter() = default;
+		RadixSorter(const RadixSorter& other) = delete;
+		RadixSorter(RadixSorter&& other) noexcept = default;
+		RadixSorter& operator=(const RadixSorter& other) = delete;
+		RadixSorter& operator=(RadixSorter&& other) noexcept = default;
+
+		//--------------------------------------------------
+		//    Sorting
+		//--------------------------------------------------
+		// Stable ascending sort of vValues by vKeys, both are permuted. Digits every key shares are skipped,
+		// so the constant pass bits cost nothing
+		void Sort(std::vector<uint64_t>& vKeys, std::vector<uint32_t>& vValues);
+
+	private:
+		static constexpr uint32_t RADIX_BITS{ 8 };
+		static constexpr uint32_t RADIX_SIZE{ 1 << RADIX_BITS };
+		static constexpr uint32_t DIGIT_COUNT{ 64 / RADIX_BITS };
+
+		std::vector<uint64_t>	m_vKeyScratch		{ };
+		std::vector<uint32_t>	m_vValueScratch		{ };
+	};
+}
+
+#endif // DRAW_SORT_H
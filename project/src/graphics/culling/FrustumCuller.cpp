@@ -0,0 +1,57 @@
+// -- Pompeii Includes --
+#include "FrustumCuller.h"
+#include "GPUCamera.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Cull Stats
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::CullStats& pompeii::CullStats::operator+=(const CullStats& other)
+{
+	visible += other.visible;
+	culled += other.culled;
+	return *this;
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Frustum Culler
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Culling
+//--------------------------------------------------
+void pompeii::FrustumCuller::Cull(const std::vector<RenderItem>& renderItems, const CameraData& camera)
+{
+	// -- Camera, the list keeps its capacity between frames --
+	CullList(renderItems, Frustum::FromMatrix(camera.proj * camera.view), m_CameraList);
+}
+
+//--------------------------------------------------
+//    Accessors
+//--------------------------------------------------
+const pompeii::VisibleList& pompeii::FrustumCuller::GetCameraList() const { return m_CameraList; }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::FrustumCuller::CullList(const std::vector<RenderItem>& renderItems, const Frustum& frustum, VisibleList& list)
+{
+	list.vDrawItems.clear();
+	list.stats = {};
+	for (const RenderItem& item : renderItems)
+	{
+		for (const SubMesh& subMesh : item.mesh->vSubMeshes)
+		{
+			const glm::mat4 model = item.transform * subMesh.matrix;
+			if (!frustum.Intersects(subMesh.aabb.Transform(model)))
+			{
+				++list.stats.culled;
+				continue;
+			}
+
+			list.vDrawItems.push_back({ item.mesh, &subMesh, model });
+			++list.stats.visible;
+		}
+	}
+}
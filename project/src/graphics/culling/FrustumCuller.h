@@ -0,0 +1,81 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+// -- Standard Library --
+#include <vector>
+
+// -- Pompeii Includes --
+#include "RenderingItems.h"
+#include "Shapes.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct CameraData;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Cull Stats
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct CullStats
+	{
+		uint32_t visible{};
+		uint32_t culled{};
+
+		CullStats& operator+=(const CullStats& other);
+	};
+	struct PassCullStats
+	{
+		CullStats shadow{};
+		CullStats depthPrePass{};
+		CullStats geometry{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Visible List
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct VisibleList
+	{
+		// -- Sub Meshes of one Mesh stay next to each other, so passes bind each Mesh once --
+		std::vector<DrawItem> vDrawItems{};
+		CullStats stats{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Frustum Culler
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class FrustumCuller final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit FrustumCuller() = default;
+		~FrustumCuller() = default;
+		FrustumCuller(const FrustumCuller& other) = delete;
+		FrustumCuller(FrustumCuller&& other) noexcept = delete;
+		FrustumCuller& operator=(const FrustumCuller& other) = delete;
+		FrustumCuller& operator=(FrustumCuller&& other) noexcept = delete;
+
+		//--------------------------------------------------
+		//    Culling
+		//--------------------------------------------------
+		// Tests every Sub Mesh's AABB against the camera, drawing itself is culled by the GPUCuller
+		void Cull(const std::vector<RenderItem>& renderItems, const CameraData& camera);
+
+		//--------------------------------------------------
+		//    Accessors
+		//--------------------------------------------------
+		// Feeds the texture streamer, which has to know on the CPU what the camera samples
+		const VisibleList& GetCameraList() const;
+
+	private:
+		static void CullList(const std::vector<RenderItem>& renderItems, const Frustum& frustum, VisibleList& list);
+
+		VisibleList		m_CameraList	{ };
+	};
+}
+
+#endif // FRUSTUM_CULLER_H
@@ -0,0 +1,575 @@
+// -- Standard Library --
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+// -- Pompeii Includes --
+#include "GPUCuller.h"
+#include "Context.h"
+#include "CommandBuffer.h"
+#include "DescriptorPool.h"
+#include "Instrumentation.h"
+#include "SecondaryRecorder.h"
+#include "Shader.h"
+#include "ThreadPool.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  GPU Culler
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::GPUCuller::Initialize(const Context& context, ThreadPool& threadPool)
+{
+	// -- Descriptor Set Layouts --
+	{
+		DescriptorSetLayoutBuilder builder{};
+		builder.SetDebugName("GPU Cull DS Layout");
+		// Instances, Sub Meshes, Views, Instance Counts, Visible Instances, Draws, Draw Counts, Stats, Draw Orders, Draw Slots, Cluster Work
+		for (uint32_t binding{}; binding < 11; ++binding)
+		{
+			builder
+				.NewLayoutBinding()
+					.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+					.SetShaderStages(VK_SHADER_STAGE_COMPUTE_BIT);
+		}
+		builder.Build(context, m_CullDSL);
+		m_DeletionQueue.Push([&] { m_CullDSL.Destroy(context); });
+
+		builder = {};
+		builder
+			.SetDebugName("Instance DS Layout")
+			.NewLayoutBinding()
+				.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.SetShaderStages(VK_SHADER_STAGE_VERTEX_BIT)
+			.NewLayoutBinding()
+				.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.SetShaderStages(VK_SHADER_STAGE_VERTEX_BIT)
+			.NewLayoutBinding()
+				.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.SetShaderStages(VK_SHADER_STAGE_VERTEX_BIT)
+			.NewLayoutBinding()
+				.SetType(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+				.SetShaderStages(VK_SHADER_STAGE_VERTEX_BIT)
+			.Build(context, m_InstanceDSL);
+		m_DeletionQueue.Push([&] { m_InstanceDSL.Destroy(context); });
+	}
+
+	// -- Pipeline Layout --
+	{
+		PipelineLayoutBuilder builder{};
+		builder
+			.NewPushConstantRange()
+				.SetPCSize(sizeof(PushConstants))
+				.SetPCStageFlags(VK_SHADER_STAGE_COMPUTE_BIT)
+			.AddLayout(m_CullDSL)
+			.Build(context, m_PipelineLayout);
+		m_DeletionQueue.Push([&] { m_PipelineLayout.Destroy(context); });
+	}
+
+	// -- Pipelines --
+	{
+		ShaderLoader shaderLoader{};
+		ShaderModule cullShader;
+		ShaderModule cullClustersShader;
+		ShaderModule buildDrawsShader;
+		shaderLoader.Load(context, "shaders/cull_instances.comp.spv", cullShader);
+		shaderLoader.Load(context, "shaders/cull_clusters.comp.spv", cullClustersShader);
+		shaderLoader.Load(context, "shaders/build_draws.comp.spv", buildDrawsShader);
+
+		ComputePipelineBuilder builder{};
+		builder
+			.SetDebugName("Compute Pipeline (Cull Instances)")
+			.SetPipelineLayout(m_PipelineLayout)
+			.SetShader(cullShader)
+			.Build(context, m_CullPipeline);
+		m_DeletionQueue.Push([&] { m_CullPipeline.Destroy(context); });
+
+		builder = {};
+		builder
+			.SetDebugName("Compute Pipeline (Cull Clusters)")
+			.SetPipelineLayout(m_PipelineLayout)
+			.SetShader(cullClustersShader)
+			.Build(context, m_CullClustersPipeline);
+		m_DeletionQueue.Push([&] { m_CullClustersPipeline.Destroy(context); });
+
+		builder = {};
+		builder
+			.SetDebugName("Compute Pipeline (Build Draws)")
+			.SetPipelineLayout(m_PipelineLayout)
+			.SetShader(buildDrawsShader)
+			.Build(context, m_BuildDrawsPipeline);
+		m_DeletionQueue.Push([&] { m_BuildDrawsPipeline.Destroy(context); });
+
+		buildDrawsShader.Destroy(context);
+		cullClustersShader.Destroy(context);
+		cullShader.Destroy(context);
+	}
+
+	// -- Frame Resources --
+	{
+		m_pGeometryArena = context.geometryArena;
+		m_pThreadPool = &threadPool;
+		m_vFrames.resize(context.maxFramesInFlight);
+		const std::vector<DescriptorSet> vCullDS = context.descriptorPool->AllocateSets(context, m_CullDSL, context.maxFramesInFlight, "GPU Cull DS");
+		const std::vector<DescriptorSet> vInstanceDS = context.descriptorPool->AllocateSets(context, m_InstanceDSL, context.maxFramesInFlight, "Instance DS");
+		for (uint32_t frameIdx{}; frameIdx < context.maxFramesInFlight; ++frameIdx)
+		{
+			FrameResources& frame = m_vFrames[frameIdx];
+			frame.cullDS = vCullDS[frameIdx];
+			frame.instanceDS = vInstanceDS[frameIdx];
+
+			// Buffers always exist, so the descriptors are valid before the first cull
+			Reserve(context, frame, 1, 1, 1, 1, 1, 1);
+
+			// The arena never moves, its vertices are written once
+			DescriptorSetWriter writer{};
+			writer
+				.AddBufferInfo(m_pGeometryArena->GetVertexBuffer(), 0, static_cast<uint32_t>(m_pGeometryArena->GetVertexBuffer().Size()))
+				.WriteBuffers(frame.instanceDS, 1)
+				.Execute(context);
+		}
+		m_DeletionQueue.Push([&]
+			{
+				for (FrameResources& frame : m_vFrames)
+				{
+					frame.clusterWorkBuffer.Destroy(context);
+					frame.drawSlotBuffer.Destroy(context);
+					frame.orderBuffer.Destroy(context);
+					frame.statsBuffer.Destroy(context);
+					frame.countBuffer.Destroy(context);
+					frame.drawBuffer.Destroy(context);
+					frame.visibleBuffer.Destroy(context);
+					frame.instanceCountBuffer.Destroy(context);
+					frame.viewBuffer.Destroy(context);
+					frame.subMeshBuffer.Destroy(context);
+					frame.instanceBuffer.Destroy(context);
+				}
+			});
+	}
+}
+void pompeii::GPUCuller::Destroy()
+{
+	m_DeletionQueue.Flush();
+}
+
+//--------------------------------------------------
+//    Culling
+//--------------------------------------------------
+void pompeii::GPUCuller::SetInstances(const std::vector<RenderItem>& renderItems)
+{
+	m_vBatches.clear();
+	m_vSubMeshes.clear();
+	m_vDrawSlots.clear();
+	m_VisibleStride = 0;
+	m_vInstances.clear();
+	m_vViews.clear();
+	m_vViewInfos.clear();
+	m_vSubMeshGroups.clear();
+	m_vMeshGroups.clear();
+	m_MeshGroupLookup.clear();
+
+	// -- Group the Render Items by Mesh --
+	for (const RenderItem& item : renderItems)
+	{
+		const auto [it, inserted] = m_MeshGroupLookup.try_emplace(item.mesh, static_cast<uint32_t>(m_vMeshGroups.size()));
+		if (inserted)
+			m_vMeshGroups.push_back({ item.mesh, 0, 0, 0 });
+		++m_vMeshGroups[it->second].itemCount;
+	}
+
+	// -- Sub Meshes, each owns a contiguous run of instances, one per Render Item of its Mesh --
+	uint32_t instanceCount{};
+	for (uint32_t groupIdx{}; groupIdx < m_vMeshGroups.size(); ++groupIdx)
+	{
+		MeshGroup& group = m_vMeshGroups[groupIdx];
+		group.firstSubMesh = static_cast<uint32_t>(m_vSubMeshes.size());
+		for (const SubMesh& subMesh : group.mesh->vSubMeshes)
+		{
+			SubMeshData& data = m_vSubMeshes.emplace_back();
+			m_vSubMeshGroups.push_back(groupIdx);
+
+			// -- Bounds --
+			data.aabbMin = glm::vec4(subMesh.aabb.min, glm::length(subMesh.aabb.max - subMesh.aabb.min) * 0.5f);
+			data.aabbMax = glm::vec4(subMesh.aabb.max, 0.f);
+			data.positionOffset = subMesh.GetPositionOffset();
+			data.positionScale = subMesh.GetPositionScale();
+
+			// -- Instances --
+			data.firstInstance = instanceCount;
+			data.instanceCount = group.itemCount;
+			instanceCount += group.itemCount;
+
+			// -- Draw Slots, every one has room for all instances of the Sub Mesh in every view --
+			const uint32_t subMeshIdx = static_cast<uint32_t>(m_vSubMeshes.size() - 1);
+			const glm::vec4 sphere{ (subMesh.aabb.min + subMesh.aabb.max) * 0.5f, data.aabbMin.w };
+			const auto AddDrawSlot = [&](const glm::vec4& slotSphere, const glm::vec4& slotCone, uint32_t firstIndex, uint32_t indexCount)
+				{
+					m_vDrawSlots.push_back({ slotSphere, slotCone, subMeshIdx, firstIndex, indexCount, m_VisibleStride });
+					m_VisibleStride += data.instanceCount;
+				};
+			data.firstDrawSlot = static_cast<uint32_t>(m_vDrawSlots.size());
+			data.vertexOffset = subMesh.baseVertex;
+
+			// Full detail is drawn per meshlet so each cluster is culled on its own
+			const std::span<const Meshlet> meshlets = group.mesh->GetMeshlets(subMesh);
+			data.meshletCount = static_cast<uint32_t>(meshlets.size());
+			for (const Meshlet& meshlet : meshlets)
+				AddDrawSlot(glm::vec4(meshlet.center, meshlet.radius), glm::vec4(meshlet.coneAxis, meshlet.coneCutoff), subMesh.firstIndex + meshlet.indexOffset, meshlet.indexCount);
+			if (meshlets.empty())
+				AddDrawSlot(sphere, glm::vec4(0.f, 0.f, 0.f, 1.f), subMesh.firstIndex, subMesh.indexCount);
+
+			// Coarser LODs are only picked far away, they draw whole
+			const std::span<const SubMeshLod> lods = group.mesh->GetLods(subMesh);
+			data.lodCount = std::min(static_cast<uint32_t>(lods.size()), MAX_INSTANCE_LODS);
+			for (uint32_t lodIdx{}; lodIdx < data.lodCount; ++lodIdx)
+			{
+				data.lodError[lodIdx] = lods[lodIdx].error;
+				AddDrawSlot(sphere, glm::vec4(0.f, 0.f, 0.f, 1.f), subMesh.firstIndex + lods[lodIdx].indexOffset, lods[lodIdx].indexCount);
+			}
+
+			// -- Batch, one per index width as every Mesh lives in the same arena --
+			auto batchIt = std::ranges::find(m_vBatches, subMesh.indexType, &Batch::indexType);
+			if (batchIt == m_vBatches.end())
+				batchIt = m_vBatches.insert(m_vBatches.end(), Batch{ subMesh.indexType, 0, 0 });
+			batchIt->drawCount += static_cast<uint32_t>(m_vDrawSlots.size()) - data.firstDrawSlot;
+			data.batchIdx = static_cast<uint32_t>(std::distance(m_vBatches.begin(), batchIt));
+
+			// -- Material indices are registry slots, the same ones the streamer binds --
+			data.albedoIdx = subMesh.material.albedoIdx;
+			data.opacityIdx = subMesh.material.opacityIdx;
+			data.normalIdx = subMesh.material.normalIdx;
+			data.roughnessIdx = subMesh.material.roughnessIdx;
+			data.metallicIdx = subMesh.material.metalnessIdx;
+		}
+	}
+	uint32_t drawCount{};
+	for (Batch& batch : m_vBatches)
+	{
+		batch.firstDraw = drawCount;
+		drawCount += batch.drawCount;
+	}
+	for (SubMeshData& data : m_vSubMeshes)
+		data.batchFirstDraw = m_vBatches[data.batchIdx].firstDraw;
+
+	// -- Instances, only the transform differs between the Render Items of a Mesh --
+	m_vInstances.resize(instanceCount);
+	m_vInstanceCenters.resize(instanceCount);
+	for (const RenderItem& item : renderItems)
+	{
+		MeshGroup& group = m_vMeshGroups[m_MeshGroupLookup.at(item.mesh)];
+		const uint32_t itemSlot = group.cursor++;
+		for (uint32_t subMeshIdx{}; subMeshIdx < item.mesh->vSubMeshes.size(); ++subMeshIdx)
+		{
+			const uint32_t dataIdx = group.firstSubMesh + subMeshIdx;
+			InstanceData& instance = m_vInstances[m_vSubMeshes[dataIdx].firstInstance + itemSlot];
+			instance.model = item.transform * item.mesh->vSubMeshes[subMeshIdx].matrix;
+			instance.subMeshIdx = dataIdx;
+
+			// -- World center, the depth every view sorts this instance by --
+			const AABB& aabb = item.mesh->vSubMeshes[subMeshIdx].aabb;
+			m_vInstanceCenters[m_vSubMeshes[dataIdx].firstInstance + itemSlot] = glm::vec3(instance.model * glm::vec4((aabb.min + aabb.max) * 0.5f, 1.f));
+		}
+	}
+}
+uint32_t pompeii::GPUCuller::AddView(const glm::mat4& viewProj, const LodSelector& lodSelector, DrawPass pass)
+{
+	const Frustum frustum = Frustum::FromMatrix(viewProj);
+	CullView view{};
+	std::copy(std::begin(frustum.planes), std::end(frustum.planes), std::begin(view.planes));
+	view.viewPosition = glm::vec4(lodSelector.viewPosition, lodSelector.pixelScale);
+	view.pixelError = lodSelector.pixelError;
+	view.orthographic = lodSelector.orthographic ? 1 : 0;
+	// Shadows cull front faces, and the cone test needs a view position to look from
+	view.coneCulling = pass != DrawPass::Shadow && !lodSelector.orthographic ? 1 : 0;
+
+	m_vViews.push_back(view);
+	m_vViewInfos.push_back({ viewProj, pass, lodSelector.orthographic });
+	return static_cast<uint32_t>(m_vViews.size() - 1);
+}
+void pompeii::GPUCuller::Record(const Context& context, CommandBuffer& commandBuffer)
+{
+	FrameResources& frame = m_vFrames[context.currentFrame];
+
+	// -- This slot's fence was waited on, so its stats from maxFramesInFlight frames ago can be read --
+	ReadBackStats(context, frame);
+
+	const uint32_t instanceCount = static_cast<uint32_t>(m_vInstances.size());
+	const uint32_t subMeshCount = static_cast<uint32_t>(m_vSubMeshes.size());
+	const uint32_t viewCount = static_cast<uint32_t>(m_vViews.size());
+	const uint32_t batchCount = static_cast<uint32_t>(m_vBatches.size());
+	const uint32_t drawSlotCount = static_cast<uint32_t>(m_vDrawSlots.size());
+	frame.instanceCount = instanceCount;
+	frame.drawSlotCount = drawSlotCount;
+	frame.viewCount = viewCount;
+	frame.batchCount = batchCount;
+	frame.vViewPasses.clear();
+	for (const ViewInfo& info : m_vViewInfos)
+		frame.vViewPasses.push_back(info.pass);
+	frame.drawStateHash = HashDrawState(frame);
+	if (instanceCount == 0 || viewCount == 0)
+		return;
+
+	// -- Every view sorts its own draws, they only share read-only data --
+	if (m_vViewOrders.size() < viewCount)
+		m_vViewOrders.resize(viewCount);
+	m_pThreadPool->ParallelFor(viewCount, [this](uint32_t viewIdx) { SortDraws(viewIdx); });
+
+	// -- Upload, growing a buffer swaps its handle and rewrites the descriptor sets --
+	Reserve(context, frame, instanceCount, subMeshCount, drawSlotCount, m_VisibleStride, viewCount, batchCount);
+	frame.drawStateHash = HashDrawState(frame);
+	vmaCopyMemoryToAllocation(context.allocator, m_vInstances.data(), frame.instanceBuffer.GetMemoryHandle(), 0, instanceCount * sizeof(InstanceData));
+	vmaCopyMemoryToAllocation(context.allocator, m_vSubMeshes.data(), frame.subMeshBuffer.GetMemoryHandle(), 0, subMeshCount * sizeof(SubMeshData));
+	vmaCopyMemoryToAllocation(context.allocator, m_vViews.data(), frame.viewBuffer.GetMemoryHandle(), 0, viewCount * sizeof(CullView));
+	vmaCopyMemoryToAllocation(context.allocator, m_vDrawSlots.data(), frame.drawSlotBuffer.GetMemoryHandle(), 0, drawSlotCount * sizeof(DrawSlotData));
+	for (uint32_t viewIdx{}; viewIdx < viewCount; ++viewIdx)
+	{
+		vmaCopyMemoryToAllocation(context.allocator, m_vViewOrders[viewIdx].vSlots.data(), frame.orderBuffer.GetMemoryHandle(),
+			viewIdx * drawSlotCount * sizeof(uint32_t), drawSlotCount * sizeof(uint32_t));
+	}
+
+	const VkCommandBuffer& vCmd = commandBuffer.GetHandle();
+	const PushConstants pc{ .instanceCount = instanceCount, .drawSlotCount = drawSlotCount, .batchCount = batchCount, .visibleStride = m_VisibleStride };
+	POMPEII_GPU_BEGIN(commandBuffer, "GPU Culling", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	{
+		// -- Clear Counters, the cluster work starts as an empty dispatch --
+		const uint32_t clusterWorkHeader[4]{ 0, 1, 1, 0 };
+		vkCmdFillBuffer(vCmd, frame.instanceCountBuffer.GetHandle(), 0, viewCount * drawSlotCount * sizeof(uint32_t), 0);
+		vkCmdFillBuffer(vCmd, frame.statsBuffer.GetHandle(), 0, viewCount * sizeof(uint32_t), 0);
+		vkCmdUpdateBuffer(vCmd, frame.clusterWorkBuffer.GetHandle(), 0, sizeof(clusterWorkHeader), clusterWorkHeader);
+		for (Buffer* pBuffer : { &frame.instanceCountBuffer, &frame.statsBuffer, &frame.clusterWorkBuffer })
+		{
+			pBuffer->InsertBarrier(commandBuffer,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+				VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+		}
+
+		// -- Cull every Instance against every View --
+		vkCmdBindDescriptorSets(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout.GetHandle(), 0, 1, &frame.cullDS.GetHandle(), 0, nullptr);
+		vkCmdPushConstants(vCmd, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pc);
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_CullPipeline.GetHandle());
+		vkCmdDispatch(vCmd, (instanceCount + 63) / 64, viewCount, 1);
+
+		// -- Cull the Meshlets of every Instance that kept full detail, as many groups as the cull pass queued --
+		frame.clusterWorkBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT);
+		frame.instanceCountBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_CullClustersPipeline.GetHandle());
+		vkCmdDispatchIndirect(vCmd, frame.clusterWorkBuffer.GetHandle(), 0);
+
+		frame.instanceCountBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+		// -- One instanced Draw per meshlet and LOD that kept any Instance, in draw key order --
+		vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_BuildDrawsPipeline.GetHandle());
+		vkCmdDispatch(vCmd, 1, viewCount, 1);
+		POMPEII_COUNT(Counter::Dispatches, 3);
+
+		// -- Hand the Draws to the Passes --
+		frame.drawBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT);
+		frame.countBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT);
+		frame.visibleBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
+		// Stats are read back on the host once this slot comes around again
+		frame.statsBuffer.InsertBarrier(commandBuffer,
+			VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+			VK_ACCESS_2_HOST_READ_BIT, VK_PIPELINE_STAGE_2_HOST_BIT);
+	}
+	POMPEII_GPU_END(commandBuffer);
+}
+void pompeii::GPUCuller::Draw(CommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t viewIdx) const
+{
+	const FrameResources& frame = m_vFrames[frameIndex];
+	if (viewIdx >= frame.viewCount)
+		return;
+
+	// -- Vertices are pulled from the arena SSBO, there is no vertex buffer to bind --
+	const VkCommandBuffer& vCmd = commandBuffer.GetHandle();
+	for (uint32_t batchIdx{}; batchIdx < frame.batchCount; ++batchIdx)
+	{
+		const Batch& batch = m_vBatches[batchIdx];
+		m_pGeometryArena->BindIndexBuffer(commandBuffer, batch.indexType);
+
+		// -- The cull pass decides how many of this batch's draws survive --
+		const VkDeviceSize drawOffset = (static_cast<VkDeviceSize>(viewIdx) * frame.drawSlotCount + batch.firstDraw) * sizeof(VkDrawIndexedIndirectCommand);
+		const VkDeviceSize countOffset = (static_cast<VkDeviceSize>(viewIdx) * frame.batchCount + batchIdx) * sizeof(uint32_t);
+		vkCmdDrawIndexedIndirectCount(vCmd, frame.drawBuffer.GetHandle(), drawOffset, frame.countBuffer.GetHandle(), countOffset,
+			batch.drawCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+}
+
+//--------------------------------------------------
+//    Accessors
+//--------------------------------------------------
+const pompeii::DescriptorSetLayout& pompeii::GPUCuller::GetInstanceDescriptorSetLayout()			const { return m_InstanceDSL; }
+const pompeii::DescriptorSet& pompeii::GPUCuller::GetInstanceDescriptorSet(uint32_t frameIndex)	const { return m_vFrames.at(frameIndex).instanceDS; }
+pompeii::PassCullStats pompeii::GPUCuller::GetPassStats()											const { return m_PassStats; }
+uint64_t pompeii::GPUCuller::GetDrawStateHash(uint32_t frameIndex)								const { return m_vFrames.at(frameIndex).drawStateHash; }
+uint32_t pompeii::GPUCuller::GetDrawCallCount(uint32_t frameIndex, uint32_t viewIdx) const
+{
+	const FrameResources& frame = m_vFrames.at(frameIndex);
+	return viewIdx < frame.viewCount ? frame.batchCount : 0;
+}
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::GPUCuller::Reserve(const Context& context, FrameResources& frame, uint32_t instanceCount, uint32_t subMeshCount, uint32_t drawSlotCount,
+	uint32_t visibleStride, uint32_t viewCount, uint32_t batchCount) const
+{
+	// -- Only ever grows, this slot's previous frame is done with the old buffers --
+	bool reallocated{ false };
+	auto grow = [&](Buffer& buffer, uint32_t& capacity, uint32_t required, uint32_t stride, VkBufferUsageFlags usage, bool hostAccess, const char* name)
+		{
+			if (required <= capacity)
+				return;
+			if (capacity > 0)
+				buffer.Destroy(context);
+			capacity = std::bit_ceil(required);
+
+			BufferAllocator bufferAlloc{};
+			bufferAlloc
+				.SetDebugName(name)
+				.SetUsage(usage)
+				.SetSize(capacity * stride)
+				.HostAccess(hostAccess)
+				.Allocate(context, buffer);
+			reallocated = true;
+		};
+	grow(frame.instanceBuffer, frame.instanceCapacity, instanceCount, sizeof(InstanceData),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true, "SSBO (Cull Instances)");
+	grow(frame.subMeshBuffer, frame.subMeshCapacity, subMeshCount, sizeof(SubMeshData),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true, "SSBO (Cull Sub Meshes)");
+	grow(frame.viewBuffer, frame.viewCapacity, viewCount, sizeof(CullView),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true, "SSBO (Cull Views)");
+	grow(frame.instanceCountBuffer, frame.instanceCountCapacity, drawSlotCount * viewCount, sizeof(uint32_t),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, false, "SSBO (Draw Slot Instance Counts)");
+	// Every draw slot of every view has room for all instances of its Sub Mesh
+	grow(frame.visibleBuffer, frame.visibleCapacity, visibleStride * viewCount, sizeof(uint32_t),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false, "SSBO (Visible Instances)");
+	grow(frame.drawBuffer, frame.drawCapacity, drawSlotCount * viewCount, sizeof(VkDrawIndexedIndirectCommand),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false, "SSBO (Indirect Draws)");
+	grow(frame.countBuffer, frame.countCapacity, batchCount * viewCount, sizeof(uint32_t),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false, "SSBO (Indirect Draw Counts)");
+	// Host visible, read back as the cull stats
+	grow(frame.statsBuffer, frame.statsCapacity, viewCount, sizeof(uint32_t),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, true, "SSBO (Cull Stats)");
+	grow(frame.orderBuffer, frame.orderCapacity, drawSlotCount * viewCount, sizeof(uint32_t),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true, "SSBO (Draw Orders)");
+	grow(frame.drawSlotBuffer, frame.drawSlotCapacity, drawSlotCount, sizeof(DrawSlotData),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true, "SSBO (Draw Slots)");
+	// Indirect dispatch arguments and the queued count, followed by one instance and view pair per entry
+	grow(frame.clusterWorkBuffer, frame.clusterWorkCapacity, instanceCount * viewCount + 2, sizeof(glm::uvec2),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, false, "SSBO (Cluster Work)");
+	if (!reallocated)
+		return;
+
+	// -- Point the Descriptors at the new Buffers --
+	++frame.descriptorGeneration;
+	DescriptorSetWriter writer{};
+	const Buffer* pCullBuffers[] = { &frame.instanceBuffer, &frame.subMeshBuffer, &frame.viewBuffer, &frame.instanceCountBuffer,
+									 &frame.visibleBuffer, &frame.drawBuffer, &frame.countBuffer, &frame.statsBuffer, &frame.orderBuffer,
+									 &frame.drawSlotBuffer, &frame.clusterWorkBuffer };
+	for (uint32_t binding{}; binding < std::size(pCullBuffers); ++binding)
+	{
+		writer
+			.AddBufferInfo(*pCullBuffers[binding], 0, static_cast<uint32_t>(pCullBuffers[binding]->Size()))
+			.WriteBuffers(frame.cullDS, binding)
+			.Execute(context);
+	}
+	// Binding 1 holds the arena vertices and never changes
+	const std::pair<const Buffer*, uint32_t> instanceBindings[] = { { &frame.instanceBuffer, 0 }, { &frame.subMeshBuffer, 2 }, { &frame.visibleBuffer, 3 } };
+	for (const auto& [pBuffer, binding] : instanceBindings)
+	{
+		writer
+			.AddBufferInfo(*pBuffer, 0, static_cast<uint32_t>(pBuffer->Size()))
+			.WriteBuffers(frame.instanceDS, binding)
+			.Execute(context);
+	}
+}
+uint64_t pompeii::GPUCuller::HashDrawState(const FrameResources& frame) const
+{
+	// -- Everything Draw records: the layout of the draws and the buffers it and the instance set point at --
+	// The instance set is rewritten in place when Reserve grows a buffer, its generation stands in for the handles
+	StateHash hash{};
+	hash.Add(frame.instanceCount).Add(frame.drawSlotCount).Add(frame.batchCount).Add(frame.viewCount);
+	for (const Batch& batch : m_vBatches)
+		hash.Add(batch.indexType).Add(batch.firstDraw).Add(batch.drawCount);
+	hash.Add(frame.descriptorGeneration);
+	return hash.Get();
+}
+void pompeii::GPUCuller::ReadBackStats(const Context& context, const FrameResources& frame)
+{
+	m_PassStats = {};
+	if (frame.viewCount == 0 || frame.instanceCount == 0)
+		return;
+
+	m_vReadBackCounts.resize(frame.viewCount);
+	vmaCopyAllocationToMemory(context.allocator, frame.statsBuffer.GetMemoryHandle(), 0, m_vReadBackCounts.data(), frame.viewCount * sizeof(uint32_t));
+
+	// -- Every view counts towards the pass it was added for --
+	for (uint32_t viewIdx{}; viewIdx < frame.viewCount; ++viewIdx)
+	{
+		CullStats stats{};
+		stats.visible = m_vReadBackCounts[viewIdx];
+		stats.culled = frame.instanceCount - stats.visible;
+
+		switch (frame.vViewPasses[viewIdx])
+		{
+		case DrawPass::DepthPrePass:	m_PassStats.depthPrePass += stats;	break;
+		case DrawPass::Geometry:		m_PassStats.geometry += stats;		break;
+		case DrawPass::Shadow:			m_PassStats.shadow += stats;		break;
+		}
+	}
+}
+
+//--------------------------------------------------
+//    Draw Order
+//--------------------------------------------------
+void pompeii::GPUCuller::SortDraws(uint32_t viewIdx)
+{
+	const ViewInfo& info = m_vViewInfos[viewIdx];
+	ViewOrder& order = m_vViewOrders[viewIdx];
+	const uint32_t subMeshCount = static_cast<uint32_t>(m_vSubMeshes.size());
+
+	// -- A Sub Mesh is as close as its nearest instance --
+	order.vDepths.assign(subMeshCount, std::numeric_limits<float>::max());
+	for (uint32_t instanceIdx{}; instanceIdx < m_vInstances.size(); ++instanceIdx)
+	{
+		const glm::vec4 clip = info.viewProj * glm::vec4(m_vInstanceCenters[instanceIdx], 1.f);
+		float& depth = order.vDepths[m_vInstances[instanceIdx].subMeshIdx];
+		depth = std::min(depth, info.orthographic ? clip.z : clip.w);
+	}
+
+	// -- Keys, the batch is the pipeline variant so every batch stays one contiguous run --
+	order.vKeys.resize(subMeshCount);
+	order.vOrder.resize(subMeshCount);
+	for (uint32_t subMeshIdx{}; subMeshIdx < subMeshCount; ++subMeshIdx)
+	{
+		const SubMeshData& data = m_vSubMeshes[subMeshIdx];
+		order.vKeys[subMeshIdx] = DrawKey::Make(info.pass, data.batchIdx, m_vSubMeshGroups[subMeshIdx], data.albedoIdx, order.vDepths[subMeshIdx]);
+		order.vOrder[subMeshIdx] = subMeshIdx;
+	}
+	order.sorter.Sort(order.vKeys, order.vOrder);
+
+	// -- Every Sub Mesh's draw slots are consecutive, they follow it into its place in the order --
+	order.vSlots.clear();
+	for (const uint32_t subMeshIdx : order.vOrder)
+	{
+		const uint32_t firstSlot = m_vSubMeshes[subMeshIdx].firstDrawSlot;
+		const uint32_t endSlot = subMeshIdx + 1 < subMeshCount ? m_vSubMeshes[subMeshIdx + 1].firstDrawSlot : static_cast<uint32_t>(m_vDrawSlots.size());
+		for (uint32_t slotIdx{ firstSlot }; slotIdx < endSlot; ++slotIdx)
+			order.vSlots.push_back(slotIdx);
+	}
+}
@@ -0,0 +1,274 @@
+#ifndef GPU_CULLER_H
+#define GPU_CULLER_H
+
+// -- Standard Library --
+#include <unordered_map>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Buffer.h"
+#include "DeletionQueue.h"
+#include "DescriptorSet.h"
+#include "DrawSort.h"
+#include "FrustumCuller.h"
+#include "Pipeline.h"
+#include "RenderingItems.h"
+
+// -- Math Includes --
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_LEFT_HANDED
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class CommandBuffer;
+	class GeometryArena;
+	class ThreadPool;
+	struct Context;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  GPU Culler
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Culls every instance against every view, instances at full detail then cull the sphere and normal cone of every
+	// meshlet. One instanced indirect draw is built per visible meshlet and coarser LOD in the order of the view's
+	// sorted draw keys. Passes then draw all geometry in the arena with one vkCmdDrawIndexedIndirectCount per index width
+	class GPUCuller final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit GPUCuller() = default;
+		~GPUCuller() = default;
+		GPUCuller(const GPUCuller& other) = delete;
+		GPUCuller(GPUCuller&& other) noexcept = delete;
+		GPUCuller& operator=(const GPUCuller& other) = delete;
+		GPUCuller& operator=(GPUCuller&& other) noexcept = delete;
+
+		// Draw keys of different views are sorted in parallel on threadPool
+		void Initialize(const Context& context, ThreadPool& threadPool);
+		void Destroy();
+
+		//--------------------------------------------------
+		//    Culling
+		//--------------------------------------------------
+		// Replaces the instances and views of the previous frame, Render Items sharing a Mesh become instances of its Sub Meshes
+		void SetInstances(const std::vector<RenderItem>& renderItems);
+		// Returns the index passes hand to Draw, pass decides the draw order, whether meshlets are cone culled and which stats the view counts towards
+		uint32_t AddView(const glm::mat4& viewProj, const LodSelector& lodSelector, DrawPass pass);
+		// Uploads this frame's instances and views and records the cull and draw building dispatches, has to come before any pass draws
+		void Record(const Context& context, CommandBuffer& commandBuffer);
+		// Binds the arena's index buffer once per index width and draws what survived for this view
+		void Draw(CommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t viewIdx) const;
+
+		//--------------------------------------------------
+		//    Accessors
+		//--------------------------------------------------
+		// Instances and Sub Meshes the vertex shaders reach through gl_InstanceIndex, and the arena vertices they index with gl_VertexIndex
+		const DescriptorSetLayout& GetInstanceDescriptorSetLayout() const;
+		const DescriptorSet& GetInstanceDescriptorSet(uint32_t frameIndex) const;
+		// Changes whenever Draw would record different commands for this frame, secondaries caching a Draw compare it
+		uint64_t GetDrawStateHash(uint32_t frameIndex) const;
+		// Indirect draws Draw records for this view, passes count them where the secondary holding them is executed
+		uint32_t GetDrawCallCount(uint32_t frameIndex, uint32_t viewIdx) const;
+		// Read back when a frame slot comes around again, so these lag maxFramesInFlight frames behind
+		PassCullStats GetPassStats() const;
+
+		//--------------------------------------------------
+		//    Shader Infos
+		//--------------------------------------------------
+		// One per Sub Mesh of a Render Item
+		struct alignas(16) InstanceData
+		{
+			glm::mat4 model;
+			uint32_t subMeshIdx;
+			uint32_t _pad[3];
+		};
+		// One per unique Sub Mesh, every Render Item of the same Mesh is an instance of it
+		struct alignas(16) SubMeshData
+		{
+			glm::vec4 aabbMin;			// w is the local radius of the AABB
+			glm::vec4 aabbMax;
+			glm::vec4 positionOffset;
+			glm::vec4 positionScale;
+			glm::vec4 lodError;
+
+			int32_t vertexOffset;
+			uint32_t lodCount;
+			uint32_t meshletCount;		// 0 draws the full detail as a single slot without cluster culling
+			uint32_t firstDrawSlot;		// full detail first, one slot per meshlet, then one per LOD
+
+			uint32_t firstInstance;
+			uint32_t instanceCount;
+			uint32_t batchIdx;
+			uint32_t batchFirstDraw;
+
+			// -- Texture registry slots --
+			uint32_t albedoIdx;
+			uint32_t opacityIdx;
+			uint32_t normalIdx;
+			uint32_t roughnessIdx;
+			uint32_t metallicIdx;
+			uint32_t _pad[3];
+		};
+		// One per draw slot, a meshlet of a Sub Mesh's full detail or one of its LODs
+		struct alignas(16) DrawSlotData
+		{
+			glm::vec4 sphere;			// center and radius in Sub Mesh space
+			glm::vec4 cone;				// axis, w is the sine of the cone angle and 1 when it can't be back face culled
+			uint32_t subMeshIdx;
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			uint32_t firstVisible;		// start of the slot's run inside every view's visible instances
+		};
+		struct alignas(16) CullView
+		{
+			glm::vec4 planes[6];
+			glm::vec4 viewPosition;		// w is the pixel scale of the LOD selector
+			float pixelError;
+			uint32_t orthographic;
+			uint32_t coneCulling;		// off for passes that don't cull back faces
+			uint32_t _pad;
+		};
+		struct PushConstants
+		{
+			uint32_t instanceCount;
+			uint32_t drawSlotCount;
+			uint32_t batchCount;
+			uint32_t visibleStride;
+		};
+
+		static constexpr uint32_t MAX_INSTANCE_LODS{ 4 };
+		// Groups the cluster cull dispatches at most, they loop when more instances need their meshlets culled
+		static constexpr uint32_t MAX_CLUSTER_GROUPS{ 65535 };
+
+	private:
+		//--------------------------------------------------
+		//    Batches & Groups
+		//--------------------------------------------------
+		// Every draw pulls from the same arena, only the index width splits them into separate indirect calls,
+		// drawCount is the most draws the batch can build, one for each draw slot of its Sub Meshes
+		struct Batch
+		{
+			VkIndexType indexType;
+			uint32_t firstDraw;
+			uint32_t drawCount;
+		};
+		// Render Items sharing a Mesh, their Sub Meshes are consecutive in m_vSubMeshes
+		struct MeshGroup
+		{
+			const Mesh* mesh;
+			uint32_t firstSubMesh;
+			uint32_t itemCount;
+			uint32_t cursor;
+		};
+
+		//--------------------------------------------------
+		//    Frame Resources
+		//--------------------------------------------------
+		struct FrameResources
+		{
+			Buffer instanceBuffer{};
+			Buffer subMeshBuffer{};
+			Buffer viewBuffer{};
+			Buffer instanceCountBuffer{};
+			Buffer visibleBuffer{};
+			Buffer drawBuffer{};
+			Buffer countBuffer{};
+			Buffer statsBuffer{};
+			Buffer orderBuffer{};
+			Buffer drawSlotBuffer{};
+			Buffer clusterWorkBuffer{};
+
+			uint32_t instanceCapacity{};
+			uint32_t subMeshCapacity{};
+			uint32_t viewCapacity{};
+			uint32_t instanceCountCapacity{};
+			uint32_t visibleCapacity{};
+			uint32_t drawCapacity{};
+			uint32_t countCapacity{};
+			uint32_t statsCapacity{};
+			uint32_t orderCapacity{};
+			uint32_t drawSlotCapacity{};
+			uint32_t clusterWorkCapacity{};
+
+			DescriptorSet cullDS{};
+			DescriptorSet instanceDS{};
+			// Bumped whenever Reserve reallocates and rewrites the sets, a freed buffer's handle may come back for the new one
+			uint64_t descriptorGeneration{};
+
+			// -- Layout the draws were built with, needed to draw and read them back --
+			uint32_t instanceCount{};
+			uint32_t drawSlotCount{};
+			uint32_t batchCount{};
+			uint32_t viewCount{};
+			std::vector<DrawPass> vViewPasses{};
+			uint64_t drawStateHash{};
+		};
+		void Reserve(const Context& context, FrameResources& frame, uint32_t instanceCount, uint32_t subMeshCount, uint32_t drawSlotCount,
+			uint32_t visibleStride, uint32_t viewCount, uint32_t batchCount) const;
+		void ReadBackStats(const Context& context, const FrameResources& frame);
+		uint64_t HashDrawState(const FrameResources& frame) const;
+
+		//--------------------------------------------------
+		//    Draw Order
+		//--------------------------------------------------
+		struct ViewInfo
+		{
+			glm::mat4 viewProj;
+			DrawPass pass;
+			bool orthographic;
+		};
+		// Sorted Sub Mesh indices of one view expanded into their draw slots, with the scratch memory that produced them
+		struct ViewOrder
+		{
+			std::vector<float> vDepths{};
+			std::vector<uint64_t> vKeys{};
+			std::vector<uint32_t> vOrder{};
+			std::vector<uint32_t> vSlots{};
+			RadixSorter sorter{};
+		};
+		void SortDraws(uint32_t viewIdx);
+
+		// -- Pipelines --
+		PipelineLayout					m_PipelineLayout	{ };
+		Pipeline						m_CullPipeline		{ };
+		Pipeline						m_CullClustersPipeline{ };
+		Pipeline						m_BuildDrawsPipeline{ };
+
+		// -- Descriptors --
+		DescriptorSetLayout				m_CullDSL			{ };
+		DescriptorSetLayout				m_InstanceDSL		{ };
+
+		// -- Data --
+		std::vector<FrameResources>		m_vFrames			{ };
+		const GeometryArena*			m_pGeometryArena	{ };
+		std::vector<Batch>				m_vBatches			{ };
+		std::vector<SubMeshData>		m_vSubMeshes		{ };
+		std::vector<DrawSlotData>		m_vDrawSlots		{ };
+		uint32_t						m_VisibleStride		{ };
+		std::vector<InstanceData>		m_vInstances		{ };
+		std::vector<CullView>			m_vViews			{ };
+		std::vector<ViewInfo>			m_vViewInfos		{ };
+		std::vector<ViewOrder>			m_vViewOrders		{ };
+		std::vector<glm::vec3>			m_vInstanceCenters	{ };
+		std::vector<uint32_t>			m_vSubMeshGroups	{ };
+		ThreadPool*						m_pThreadPool		{ };
+		std::vector<uint32_t>			m_vReadBackCounts	{ };
+		PassCullStats					m_PassStats			{ };
+
+		// -- Grouping --
+		std::vector<MeshGroup>						m_vMeshGroups		{ };
+		std::unordered_map<const Mesh*, uint32_t>	m_MeshGroupLookup	{ };
+
+		// -- DQ --
+		DeletionQueue					m_DeletionQueue		{ };
+	};
+}
+
+#endif // GPU_CULLER_H
@@ -0,0 +1,318 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "AsyncUploader.h"
+#include "Context.h"
+#include "Image.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Async Uploader
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::AsyncUploader::Initialize(Context& context)
+{
+	const QueueFamilyIndices queueFamilyIndices = context.physicalDevice.GetQueueFamilies();
+	m_GraphicsFamily = queueFamilyIndices.graphicsFamily.value();
+	m_TransferFamily = queueFamilyIndices.transferFamily.value_or(m_GraphicsFamily);
+	m_CommandPool.Create(context, m_TransferFamily);
+
+	// -- Timeline Semaphore, one value per upload --
+	VkSemaphoreTypeCreateInfo typeInfo{};
+	typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	typeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &typeInfo;
+
+	if (vkCreateSemaphore(context.device.GetHandle(), &semaphoreInfo, nullptr, &m_Semaphore) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create Upload Timeline Semaphore!");
+
+	m_SubmittedValue = 0;
+	m_AcquiredValue = 0;
+}
+void pompeii::AsyncUploader::Destroy(const Context& context)
+{
+	std::scoped_lock lock{ m_Mutex };
+	m_vSubmissions.push_back(std::move(m_Recording));
+	m_Recording = {};
+	for (Submission& submission : m_vSubmissions)
+	{
+		if (submission.commandBuffer.GetHandle() != VK_NULL_HANDLE)
+			submission.commandBuffer.Free(context.device);
+		for (const Buffer& buffer : submission.vStaging)
+			buffer.Destroy(context);
+	}
+	m_vSubmissions.clear();
+	m_vPendingUploads.clear();
+
+	vkDestroySemaphore(context.device.GetHandle(), m_Semaphore, nullptr);
+	m_Semaphore = VK_NULL_HANDLE;
+	m_CommandPool.Destroy();
+}
+
+//--------------------------------------------------
+//    Uploads
+//--------------------------------------------------
+uint64_t pompeii::AsyncUploader::UploadBuffer(const Context& context, const Buffer& dst, const std::vector<UploadRegion>& vRegions,
+											  VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage)
+{
+	PendingUpload upload{};
+	upload.buffer = dst.GetHandle();
+	upload.dstAccess = dstAccess;
+	upload.dstStage = dstStage;
+
+	VkDeviceSize regionEnd{};
+	upload.offset = vRegions.empty() ? 0 : vRegions.front().dstOffset;
+	for (const UploadRegion& region : vRegions)
+	{
+		upload.offset = std::min(upload.offset, region.dstOffset);
+		regionEnd = std::max(regionEnd, region.dstOffset + region.size);
+	}
+	// Only the written range changes owner, shared buffers stay readable by the graphics queue everywhere else
+	upload.size = regionEnd - upload.offset;
+
+	// -- Stage and Copy every Region, then Release --
+	std::scoped_lock lock{ m_Mutex };
+	const CommandBuffer& cmd = Record();
+	{
+		for (const UploadRegion& region : vRegions)
+		{
+			if (region.size == 0)
+				continue;
+			VkBufferCopy copy{ .dstOffset = region.dstOffset, .size = region.size };
+			const VkBuffer src = Stage(context, region.pData, region.size, copy.srcOffset);
+			vkCmdCopyBuffer(cmd.GetHandle(), src, upload.buffer, 1, &copy);
+		}
+
+		VkBufferMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+		barrier.buffer = upload.buffer;
+		barrier.offset = upload.offset;
+		barrier.size = upload.size;
+		barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		barrier.dstAccessMask = VK_ACCESS_2_NONE;
+		barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+		barrier.srcQueueFamilyIndex = HasDedicatedQueue() ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = HasDedicatedQueue() ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+		VkDependencyInfo dependencyInfo{};
+		dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependencyInfo.bufferMemoryBarrierCount = 1;
+		dependencyInfo.pBufferMemoryBarriers = &barrier;
+		vkCmdPipelineBarrier2(cmd.GetHandle(), &dependencyInfo);
+	}
+
+	upload.value = m_Recording.value;
+	m_vPendingUploads.push_back(upload);
+	return upload.value;
+}
+uint64_t pompeii::AsyncUploader::UploadImage(const Context& context, Image& dst, const void* pData, VkDeviceSize size,
+											 const std::vector<VkBufferImageCopy>& vRegions, VkImageLayout finalLayout,
+											 VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage)
+{
+	PendingUpload upload{};
+	upload.image = dst.GetHandle();
+	upload.range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, dst.GetMipLevels(), 0, dst.GetLayerCount() };
+	upload.layout = finalLayout;
+	upload.dstAccess = dstAccess;
+	upload.dstStage = dstStage;
+
+	// -- Copy and Release, the layout change happens as part of the ownership transfer --
+	std::scoped_lock lock{ m_Mutex };
+	const CommandBuffer& cmd = Record();
+	{
+		VkDeviceSize stagingOffset{};
+		const VkBuffer src = Stage(context, pData, size, stagingOffset);
+		std::vector<VkBufferImageCopy> vStagedRegions = vRegions;
+		for (VkBufferImageCopy& region : vStagedRegions)
+			region.bufferOffset += stagingOffset;
+
+		dst.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_NONE,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT,
+			0, dst.GetMipLevels(), 0, dst.GetLayerCount());
+		vkCmdCopyBufferToImage(cmd.GetHandle(), src, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(vStagedRegions.size()), vStagedRegions.data());
+
+		VkImageMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+		barrier.image = upload.image;
+		barrier.subresourceRange = upload.range;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = finalLayout;
+		barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		barrier.dstAccessMask = VK_ACCESS_2_NONE;
+		barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+		barrier.srcQueueFamilyIndex = HasDedicatedQueue() ? m_TransferFamily : VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = HasDedicatedQueue() ? m_GraphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+		VkDependencyInfo dependencyInfo{};
+		dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependencyInfo.imageMemoryBarrierCount = 1;
+		dependencyInfo.pImageMemoryBarriers = &barrier;
+		vkCmdPipelineBarrier2(cmd.GetHandle(), &dependencyInfo);
+	}
+	dst.m_CurrentLayout = finalLayout;
+
+	upload.value = m_Recording.value;
+	m_vPendingUploads.push_back(upload);
+	return upload.value;
+}
+
+void pompeii::AsyncUploader::Acquire(const Context& context, const CommandBuffer& commandBuffer)
+{
+	// -- Everything recorded since last frame goes out in one submit --
+	std::scoped_lock lock{ m_Mutex };
+	Flush(context);
+	if (m_vPendingUploads.empty())
+		return;
+
+	uint64_t completedValue{};
+	vkGetSemaphoreCounterValue(context.device.GetHandle(), m_Semaphore, &completedValue);
+
+	// -- Acquire Barriers for every finished Upload, only needed when the copy ran on another family --
+	std::vector<VkBufferMemoryBarrier2> vBufferBarriers{};
+	std::vector<VkImageMemoryBarrier2> vImageBarriers{};
+	for (const PendingUpload& upload : m_vPendingUploads)
+	{
+		if (upload.value > completedValue || !HasDedicatedQueue())
+			continue;
+
+		if (upload.buffer != VK_NULL_HANDLE)
+		{
+			VkBufferMemoryBarrier2& barrier = vBufferBarriers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			barrier.buffer = upload.buffer;
+			barrier.offset = upload.offset;
+			barrier.size = upload.size;
+			barrier.srcAccessMask = VK_ACCESS_2_NONE;
+			barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.dstAccessMask = upload.dstAccess;
+			barrier.dstStageMask = upload.dstStage;
+			barrier.srcQueueFamilyIndex = m_TransferFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+		}
+		else
+		{
+			VkImageMemoryBarrier2& barrier = vImageBarriers.emplace_back();
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+			barrier.image = upload.image;
+			barrier.subresourceRange = upload.range;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = upload.layout;
+			barrier.srcAccessMask = VK_ACCESS_2_NONE;
+			barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+			barrier.dstAccessMask = upload.dstAccess;
+			barrier.dstStageMask = upload.dstStage;
+			barrier.srcQueueFamilyIndex = m_TransferFamily;
+			barrier.dstQueueFamilyIndex = m_GraphicsFamily;
+		}
+	}
+	if (!vBufferBarriers.empty() || !vImageBarriers.empty())
+	{
+		VkDependencyInfo dependencyInfo{};
+		dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(vBufferBarriers.size());
+		dependencyInfo.pBufferMemoryBarriers = vBufferBarriers.data();
+		dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(vImageBarriers.size());
+		dependencyInfo.pImageMemoryBarriers = vImageBarriers.data();
+		vkCmdPipelineBarrier2(commandBuffer.GetHandle(), &dependencyInfo);
+	}
+
+	// -- The copies are done, their staging memory is free to go, the ring reclaims its regions on its own --
+	std::erase_if(m_vPendingUploads, [&](const PendingUpload& upload)
+		{
+			if (upload.value > completedValue)
+				return false;
+			m_AcquiredValue = std::max(m_AcquiredValue, upload.value);
+			return true;
+		});
+	std::erase_if(m_vSubmissions, [&](Submission& submission)
+		{
+			if (submission.value > completedValue)
+				return false;
+			submission.commandBuffer.Free(context.device);
+			for (const Buffer& buffer : submission.vStaging)
+				buffer.Destroy(context);
+			return true;
+		});
+}
+bool pompeii::AsyncUploader::IsComplete(uint64_t ticket) const
+{
+	std::scoped_lock lock{ m_Mutex };
+	return ticket <= m_AcquiredValue;
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+const VkSemaphore& pompeii::AsyncUploader::GetSemaphore() const { return m_Semaphore; }
+uint64_t pompeii::AsyncUploader::GetAcquiredValue() const { std::scoped_lock lock{ m_Mutex }; return m_AcquiredValue; }
+bool pompeii::AsyncUploader::HasDedicatedQueue() const { return m_TransferFamily != m_GraphicsFamily; }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+const pompeii::CommandBuffer& pompeii::AsyncUploader::Record()
+{
+	if (m_Recording.commandBuffer.GetHandle() != VK_NULL_HANDLE)
+		return m_Recording.commandBuffer;
+
+	// -- Moved out of the pool so it stays valid while the pool hands out more buffers --
+	m_Recording.value = m_SubmittedValue + 1;
+	m_Recording.commandBuffer = std::move(m_CommandPool.AllocateCmdBuffers(1));
+	m_Recording.commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	return m_Recording.commandBuffer;
+}
+VkBuffer pompeii::AsyncUploader::Stage(const Context& context, const void* pData, VkDeviceSize size, VkDeviceSize& offset)
+{
+	StagingRing* pRing = context.stagingRing;
+	if (pRing && pRing->Allocate(size, STAGING_ALIGNMENT, offset))
+	{
+		m_Recording.vRingOffsets.push_back(offset);
+		std::memcpy(pRing->GetMappedData() + offset, pData, size);
+		return pRing->GetBuffer().GetHandle();
+	}
+
+	// -- Too big for the ring, or the GPU still reads the rest of it --
+	Buffer& stagingBuffer = m_Recording.vStaging.emplace_back();
+	BufferAllocator stagingAllocator{};
+	stagingAllocator
+		.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+		.HostAccess(true)
+		.SetSize(static_cast<uint32_t>(size))
+		.Allocate(context, stagingBuffer);
+	vmaCopyMemoryToAllocation(context.allocator, pData, stagingBuffer.GetMemoryHandle(), 0, size);
+	offset = 0;
+	return stagingBuffer.GetHandle();
+}
+void pompeii::AsyncUploader::Flush(const Context& context)
+{
+	if (m_Recording.commandBuffer.GetHandle() == VK_NULL_HANDLE)
+		return;
+
+	m_Recording.commandBuffer.End();
+	m_SubmittedValue = m_Recording.value;
+	const SemaphoreInfo semaphoreInfo
+	{
+		.vSignalSemaphores = { m_Semaphore },
+		.vSignalValues = { m_Recording.value }
+	};
+	m_Recording.commandBuffer.Submit(context.device.GetTransferQueue(), false, semaphoreInfo);
+	if (context.stagingRing)
+		context.stagingRing->Retire(m_Recording.vRingOffsets, m_Semaphore, m_Recording.value);
+
+	m_vSubmissions.push_back(std::move(m_Recording));
+	m_Recording = {};
+}
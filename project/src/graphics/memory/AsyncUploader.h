@@ -0,0 +1,130 @@
+#ifndef ASYNC_UPLOADER_H
+#define ASYNC_UPLOADER_H
+
+// -- Vulkan Includes --
+#include <vma/vk_mem_alloc.h>
+
+// -- Standard Library --
+#include <mutex>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "CommandPool.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class Image;
+	struct Context;
+}
+
+namespace pompeii
+{
+	// -- Helper Structs --
+	struct UploadRegion
+	{
+		const void* pData;
+		VkDeviceSize size;
+		VkDeviceSize dstOffset;
+	};
+
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Async Uploader
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Uploads may come from any thread, they are recorded into one command buffer that Acquire submits once per frame
+	class AsyncUploader final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit AsyncUploader() = default;
+		~AsyncUploader() = default;
+		AsyncUploader(const AsyncUploader& other) = delete;
+		AsyncUploader(AsyncUploader&& other) noexcept = delete;
+		AsyncUploader& operator=(const AsyncUploader& other) = delete;
+		AsyncUploader& operator=(AsyncUploader&& other) noexcept = delete;
+
+		void Initialize(Context& context);
+		// The device must be idle
+		void Destroy(const Context& context);
+
+		//--------------------------------------------------
+		//    Uploads
+		//--------------------------------------------------
+		// Staged in the context's StagingRing when it has room, the returned ticket is the timeline value the submit holding it signals
+		uint64_t UploadBuffer(const Context& context, const Buffer& dst, const std::vector<UploadRegion>& vRegions,
+							  VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage);
+		// Every region reads from pData, the image ends up in finalLayout with all of its mips and layers written
+		uint64_t UploadImage(const Context& context, Image& dst, const void* pData, VkDeviceSize size,
+							 const std::vector<VkBufferImageCopy>& vRegions, VkImageLayout finalLayout,
+							 VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage);
+
+		// Submits the uploads recorded since the last call and records the graphics side of finished ones,
+		// the submit of commandBuffer has to wait on GetSemaphore at GetAcquiredValue
+		void Acquire(const Context& context, const CommandBuffer& commandBuffer);
+		// Whether the resource behind the ticket may be used in the frame that called Acquire last
+		bool IsComplete(uint64_t ticket) const;
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		const VkSemaphore& GetSemaphore() const;
+		uint64_t GetAcquiredValue() const;
+		bool HasDedicatedQueue() const;
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		struct PendingUpload
+		{
+			uint64_t value{};
+
+			// -- Acquire Barrier, the handles are kept instead of the objects as those may move until then --
+			VkBuffer buffer{ VK_NULL_HANDLE };
+			VkDeviceSize offset{};
+			VkDeviceSize size{ VK_WHOLE_SIZE };
+			VkImage image{ VK_NULL_HANDLE };
+			VkImageSubresourceRange range{};
+			VkImageLayout layout{};
+			VkAccessFlags2 dstAccess{};
+			VkPipelineStageFlags2 dstStage{};
+		};
+
+		// Every upload between two Acquires, with the staging it reads from
+		struct Submission
+		{
+			uint64_t value{};
+			CommandBuffer commandBuffer{ VK_NULL_HANDLE, VK_NULL_HANDLE };
+			std::vector<Buffer> vStaging{};
+			std::vector<VkDeviceSize> vRingOffsets{};
+		};
+
+		// -- All of these expect m_Mutex to be held --
+		// Begins the command buffer of the next submit on first use
+		const CommandBuffer& Record();
+		// Returns the buffer holding the data, a buffer of its own when the ring has no room
+		VkBuffer Stage(const Context& context, const void* pData, VkDeviceSize size, VkDeviceSize& offset);
+		void Flush(const Context& context);
+
+		static constexpr VkDeviceSize STAGING_ALIGNMENT{ 16 };
+
+		CommandPool					m_CommandPool		{ };
+		VkSemaphore					m_Semaphore			{ VK_NULL_HANDLE };
+		std::vector<PendingUpload>	m_vPendingUploads	{ };
+		Submission					m_Recording			{ };
+		std::vector<Submission>		m_vSubmissions		{ };
+		mutable std::mutex			m_Mutex				{ };
+
+		uint64_t					m_SubmittedValue	{ };
+		uint64_t					m_AcquiredValue		{ };
+		uint32_t					m_TransferFamily	{ };
+		uint32_t					m_GraphicsFamily	{ };
+	};
+}
+
+#endif // ASYNC_UPLOADER_H
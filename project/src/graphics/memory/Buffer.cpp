@@ -4,6 +4,7 @@
 #include "Context.h"
 #include "Image.h"
 #include "RenderDebugger.h"
+#include "UploadBatch.h"
 
 
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -88,10 +89,10 @@ void pompeii::Buffer::CopyToBuffer(const CommandBuffer& cmd, const Buffer& dst,
 	copyRegion.size = size;
 	vkCmdCopyBuffer(cmd.GetHandle(), m_Buffer, dst.GetHandle(), 1, &copyRegion);
 }
-void pompeii::Buffer::CopyToImage(const CommandBuffer& cmd, const Image& dst, VkExtent3D extent, uint32_t mip, uint32_t baseLayer, uint32_t layerCount) const
+void pompeii::Buffer::CopyToImage(const CommandBuffer& cmd, const Image& dst, VkExtent3D extent, uint32_t mip, uint32_t baseLayer, uint32_t layerCount, VkDeviceSize bufferOffset) const
 {
 	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
+	region.bufferOffset = bufferOffset;
 	region.bufferRowLength = 0;
 	region.bufferImageHeight = 0;
 	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -183,6 +184,12 @@ pompeii::BufferAllocator& pompeii::BufferAllocator::AddInitialData(const void* d
 }
 
 void pompeii::BufferAllocator::Allocate(const Context& context, Buffer& buffer) const
+{
+	UploadBatch batch{};
+	Allocate(context, buffer, batch);
+	batch.Submit(context);
+}
+void pompeii::BufferAllocator::Allocate(const Context& context, Buffer& buffer, UploadBatch& batch) const
 {
 	vmaCreateBuffer(context.allocator, &m_CreateInfo, &m_AllocCreateInfo, &buffer.m_Buffer, &buffer.m_Memory, nullptr);
 	buffer.m_Size = m_CreateInfo.size;
@@ -190,33 +197,35 @@ void pompeii::BufferAllocator::Allocate(const Context& context, Buffer& buffer)
 	if (m_UseInitialData)
 	{
 		for (const InitData& data : m_vInitialData)
-		{
-			if (data.initDataSize <= 0)
-				continue;
-
-			Buffer stagingBuffer;
-			BufferAllocator stagingAllocator{};
-			stagingAllocator
-				.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-				.HostAccess(true)
-				.SetSize(data.initDataSize)
-				.Allocate(context, stagingBuffer);
-			vmaCopyMemoryToAllocation(context.allocator, data.pData, stagingBuffer.m_Memory, 0, data.initDataSize);
-
-
-			CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
-			cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-			{
-				stagingBuffer.CopyToBuffer(cmd, buffer, data.initDataSize, 0, data.dstOffset);
-			}
-			cmd.End();
-			cmd.Submit(context.device.GetGraphicQueue(), true);
-			cmd.Free(context.device);
-			stagingBuffer.Destroy(context);
-		}
+			batch.AddBufferCopy(context, buffer, data.pData, data.initDataSize, data.dstOffset);
 	}
 	if (m_pName)
 	{
 		RenderDebugger::SetDebugObjectName(reinterpret_cast<uint64_t>(buffer.GetHandle()), VK_OBJECT_TYPE_BUFFER, m_pName);
 	}
 }
+uint64_t pompeii::BufferAllocator::AllocateAsync(const Context& context, Buffer& buffer, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage) const
+{
+	if (!context.uploader || !m_UseInitialData)
+	{
+		Allocate(context, buffer);
+		return 0;
+	}
+
+	vmaCreateBuffer(context.allocator, &m_CreateInfo, &m_AllocCreateInfo, &buffer.m_Buffer, &buffer.m_Memory, nullptr);
+	buffer.m_Size = m_CreateInfo.size;
+
+	std::vector<UploadRegion> vRegions{};
+	for (const InitData& data : m_vInitialData)
+	{
+		if (data.initDataSize > 0)
+			vRegions.emplace_back(data.pData, data.initDataSize, data.dstOffset);
+	}
+	const uint64_t ticket = context.uploader->UploadBuffer(context, buffer, vRegions, dstAccess, dstStage);
+
+	if (m_pName)
+	{
+		RenderDebugger::SetDebugObjectName(reinterpret_cast<uint64_t>(buffer.GetHandle()), VK_OBJECT_TYPE_BUFFER, m_pName);
+	}
+	return ticket;
+}
\ No newline at end of file
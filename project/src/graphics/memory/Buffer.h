@@ -11,6 +11,7 @@ namespace pompeii
 	class CommandBuffer;
 	class Image;
 	class CommandPool;
+	class UploadBatch;
 	struct Context;
 }
 
@@ -45,7 +46,7 @@ namespace pompeii
 		//--------------------------------------------------
 		void InsertBarrier(const CommandBuffer& cmd, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 srcStage, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage) const;
 		void CopyToBuffer(const CommandBuffer& cmd, const Buffer& dst, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset) const;
-		void CopyToImage(const CommandBuffer& cmd, const Image& dst, VkExtent3D extent, uint32_t mip, uint32_t baseLayer, uint32_t layerCount) const;
+		void CopyToImage(const CommandBuffer& cmd, const Image& dst, VkExtent3D extent, uint32_t mip, uint32_t baseLayer, uint32_t layerCount, VkDeviceSize bufferOffset = 0) const;
 
 	private:
 		VmaAllocation m_Memory;
@@ -78,6 +79,10 @@ namespace pompeii
 		BufferAllocator& AddInitialData(const void* data, VkDeviceSize dstOffset, uint32_t size);
 
 		void Allocate(const Context& context, Buffer& buffer) const;
+		// Records the initial data into batch instead of submitting it, buffer has to stay alive until the batch is submitted
+		void Allocate(const Context& context, Buffer& buffer, UploadBatch& batch) const;
+		// Initial data goes through the context's uploader, the returned ticket tells when the buffer may be used as dstAccess in dstStage
+		uint64_t AllocateAsync(const Context& context, Buffer& buffer, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage) const;
 
 	private:
 		bool m_UseInitialData;
@@ -0,0 +1,180 @@
+// -- Standard Library --
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "GeometryArena.h"
+#include "Context.h"
+#include "CommandBuffer.h"
+#include "Mesh.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Geometry Arena
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::GeometryArena::Initialize(const Context& context, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity)
+{
+	// -- Vertices are pulled in the vertex shader, so they live in a storage buffer --
+	BufferAllocator allocator{};
+	allocator
+		.SetDebugName("SSBO (Geometry Arena Vertices)")
+		.SetUsage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+		.HostAccess(false)
+		.SetSize(static_cast<uint32_t>(vertexCapacity))
+		.Allocate(context, m_VertexBuffer);
+
+	allocator = {};
+	allocator
+		.SetDebugName("Index Buffer (Geometry Arena)")
+		.SetUsage(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+		.HostAccess(false)
+		.SetSize(static_cast<uint32_t>(indexCapacity))
+		.Allocate(context, m_IndexBuffer);
+
+	m_VertexBlocks.Reset(vertexCapacity, sizeof(PackedVertex));
+	m_IndexBlocks.Reset(indexCapacity, sizeof(uint32_t));
+}
+void pompeii::GeometryArena::Destroy(const Context& context)
+{
+	m_IndexBuffer.Destroy(context);
+	m_VertexBuffer.Destroy(context);
+	std::scoped_lock lock{ m_Mutex };
+	m_VertexBlocks.vFreeBlocks.clear();
+	m_IndexBlocks.vFreeBlocks.clear();
+	m_vPendingFrees.clear();
+}
+
+//--------------------------------------------------
+//    Allocation
+//--------------------------------------------------
+pompeii::GeometryRange pompeii::GeometryArena::AllocateVertices(uint32_t vertexCount)
+{
+	GeometryRange range{};
+	std::scoped_lock lock{ m_Mutex };
+	if (!m_VertexBlocks.Allocate(vertexCount * sizeof(PackedVertex), range))
+		throw std::runtime_error("Geometry Arena is out of vertex memory!");
+	return range;
+}
+pompeii::GeometryRange pompeii::GeometryArena::AllocateIndices(VkDeviceSize size)
+{
+	GeometryRange range{};
+	std::scoped_lock lock{ m_Mutex };
+	if (!m_IndexBlocks.Allocate(size, range))
+		throw std::runtime_error("Geometry Arena is out of index memory!");
+	return range;
+}
+void pompeii::GeometryArena::FreeVertices(const GeometryRange& range, uint64_t uploadTicket)
+{
+	DeferFree(m_VertexBlocks, range, uploadTicket);
+}
+void pompeii::GeometryArena::FreeIndices(const GeometryRange& range, uint64_t uploadTicket)
+{
+	DeferFree(m_IndexBlocks, range, uploadTicket);
+}
+void pompeii::GeometryArena::CollectFreed(const Context& context)
+{
+	// -- This frame's fence was waited on, so every frame up to maxFramesInFlight ago is done on the GPU --
+	std::scoped_lock lock{ m_Mutex };
+	++m_FrameCount;
+	std::erase_if(m_vPendingFrees, [&](const PendingFree& pending)
+		{
+			if (pending.frame + context.maxFramesInFlight > m_FrameCount || !context.uploader->IsComplete(pending.uploadTicket))
+				return false;
+			pending.pList->Free(pending.range);
+			return true;
+		});
+}
+
+uint64_t pompeii::GeometryArena::UploadVertices(const Context& context, const GeometryRange& range, const void* pData) const
+{
+	if (range.size == 0)
+		return 0;
+	return context.uploader->UploadBuffer(context, m_VertexBuffer, { { pData, range.size, range.offset } },
+		VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
+}
+uint64_t pompeii::GeometryArena::UploadIndices(const Context& context, const GeometryRange& range, const void* pData) const
+{
+	if (range.size == 0)
+		return 0;
+	return context.uploader->UploadBuffer(context, m_IndexBuffer, { { pData, range.size, range.offset } },
+		VK_ACCESS_2_INDEX_READ_BIT, VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT);
+}
+
+//--------------------------------------------------
+//    Binding
+//--------------------------------------------------
+void pompeii::GeometryArena::BindIndexBuffer(const CommandBuffer& commandBuffer, VkIndexType indexType) const
+{
+	vkCmdBindIndexBuffer(commandBuffer.GetHandle(), m_IndexBuffer.GetHandle(), 0, indexType);
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+const pompeii::Buffer& pompeii::GeometryArena::GetVertexBuffer()	const { return m_VertexBuffer; }
+const pompeii::Buffer& pompeii::GeometryArena::GetIndexBuffer()		const { return m_IndexBuffer; }
+
+void pompeii::GeometryArena::DeferFree(FreeList& list, const GeometryRange& range, uint64_t uploadTicket)
+{
+	if (range.size == 0)
+		return;
+	std::scoped_lock lock{ m_Mutex };
+	m_vPendingFrees.push_back({ &list, range, m_FrameCount, uploadTicket });
+}
+
+//--------------------------------------------------
+//    Free List
+//--------------------------------------------------
+void pompeii::GeometryArena::FreeList::Reset(VkDeviceSize capacity, VkDeviceSize unit)
+{
+	unitSize = unit;
+	vFreeBlocks.clear();
+	vFreeBlocks.push_back({ 0, capacity / unit * unit });
+}
+bool pompeii::GeometryArena::FreeList::Allocate(VkDeviceSize size, GeometryRange& range)
+{
+	if (size == 0)
+	{
+		range = {};
+		return true;
+	}
+	size = (size + unitSize - 1) / unitSize * unitSize;
+	const auto it = std::ranges::find_if(vFreeBlocks, [size](const GeometryRange& block) { return block.size >= size; });
+	if (it == vFreeBlocks.end())
+		return false;
+
+	range = { it->offset, size };
+	it->offset += size;
+	it->size -= size;
+	if (it->size == 0)
+		vFreeBlocks.erase(it);
+	return true;
+}
+void pompeii::GeometryArena::FreeList::Free(const GeometryRange& range)
+{
+	if (range.size == 0)
+		return;
+
+	// -- Keep the blocks sorted and merge with the neighbours on either side --
+	auto it = std::ranges::lower_bound(vFreeBlocks, range.offset, {}, &GeometryRange::offset);
+	it = vFreeBlocks.insert(it, range);
+	if (const auto next = std::next(it); next != vFreeBlocks.end() && it->offset + it->size == next->offset)
+	{
+		it->size += next->size;
+		vFreeBlocks.erase(next);
+	}
+	if (it != vFreeBlocks.begin())
+	{
+		const auto prev = std::prev(it);
+		if (prev->offset + prev->size == it->offset)
+		{
+			prev->size += it->size;
+			vFreeBlocks.erase(it);
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+// -- Vulkan Includes --
+#include <vma/vk_mem_alloc.h>
+
+// -- Standard Library --
+#include <mutex>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Buffer.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class CommandBuffer;
+	struct Context;
+}
+
+namespace pompeii
+{
+	// -- Helper Structs --
+	// Byte range inside one of the arena's buffers
+	struct GeometryRange
+	{
+		VkDeviceSize offset{};
+		VkDeviceSize size{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Geometry Arena
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Every Mesh suballocates its packed vertices and indices from the same two device local buffers,
+	// so all static geometry draws with one index buffer binding and pulls vertices from one SSBO.
+	// Meshes load and unload from any thread, the free lists are guarded by one mutex
+	class GeometryArena final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit GeometryArena() = default;
+		~GeometryArena() = default;
+		GeometryArena(const GeometryArena& other) = delete;
+		GeometryArena(GeometryArena&& other) noexcept = delete;
+		GeometryArena& operator=(const GeometryArena& other) = delete;
+		GeometryArena& operator=(GeometryArena&& other) noexcept = delete;
+
+		void Initialize(const Context& context, VkDeviceSize vertexCapacity = DEFAULT_VERTEX_CAPACITY, VkDeviceSize indexCapacity = DEFAULT_INDEX_CAPACITY);
+		// The device must be idle
+		void Destroy(const Context& context);
+
+		//--------------------------------------------------
+		//    Allocation
+		//--------------------------------------------------
+		// Offsets are multiples of the vertex stride, throws when the arena is full
+		GeometryRange AllocateVertices(uint32_t vertexCount);
+		// Offsets are 4-byte aligned so the range can hold either index width, throws when the arena is full
+		GeometryRange AllocateIndices(VkDeviceSize size);
+		// The range returns to the arena once every frame in flight that may draw it is done and the upload with uploadTicket completed
+		void FreeVertices(const GeometryRange& range, uint64_t uploadTicket = 0);
+		void FreeIndices(const GeometryRange& range, uint64_t uploadTicket = 0);
+		// Once per frame after its fence was waited on, hands back the ranges the GPU is done with
+		void CollectFreed(const Context& context);
+
+		// pData has to hold range.size bytes, the returned ticket tells when the vertex shader or input assembler may read the range
+		uint64_t UploadVertices(const Context& context, const GeometryRange& range, const void* pData) const;
+		uint64_t UploadIndices(const Context& context, const GeometryRange& range, const void* pData) const;
+
+		//--------------------------------------------------
+		//    Binding
+		//--------------------------------------------------
+		// Bound at offset 0, SubMesh::firstIndex already includes the range offset
+		void BindIndexBuffer(const CommandBuffer& commandBuffer, VkIndexType indexType) const;
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		const Buffer& GetVertexBuffer() const;
+		const Buffer& GetIndexBuffer() const;
+
+		static constexpr VkDeviceSize DEFAULT_VERTEX_CAPACITY{ 128 * 1024 * 1024 };
+		static constexpr VkDeviceSize DEFAULT_INDEX_CAPACITY{ 64 * 1024 * 1024 };
+
+	private:
+		//--------------------------------------------------
+		//    Free List
+		//--------------------------------------------------
+		// First fit over sorted free blocks, sizes are kept in whole units so offsets never need padding
+		struct FreeList
+		{
+			VkDeviceSize unitSize{};
+			std::vector<GeometryRange> vFreeBlocks{};
+
+			void Reset(VkDeviceSize capacity, VkDeviceSize unit);
+			bool Allocate(VkDeviceSize size, GeometryRange& range);
+			void Free(const GeometryRange& range);
+		};
+		// Freed by a Mesh, but possibly still read by a frame in flight or written by its upload
+		struct PendingFree
+		{
+			FreeList* pList;
+			GeometryRange range;
+			uint64_t frame;
+			uint64_t uploadTicket;
+		};
+		void DeferFree(FreeList& list, const GeometryRange& range, uint64_t uploadTicket);
+
+		Buffer						m_VertexBuffer		{ };
+		Buffer						m_IndexBuffer		{ };
+		FreeList					m_VertexBlocks		{ };
+		FreeList					m_IndexBlocks		{ };
+		std::vector<PendingFree>	m_vPendingFrees		{ };
+		uint64_t					m_FrameCount		{ };
+		mutable std::mutex			m_Mutex				{ };
+	};
+}
+
+#endif // GEOMETRY_ARENA_H
@@ -8,6 +8,7 @@
 #include "CommandPool.h"
 #include "Buffer.h"
 #include "RenderDebugger.h"
+#include "UploadBatch.h"
 
 
 //? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -213,6 +214,35 @@ void pompeii::Image::BlitImage(const CommandBuffer& cmd, const Image& destinatio
 	vkCmdBlitImage2(cmd.GetHandle(), &blitInfo);
 }
 
+void pompeii::Image::CopyMip(const CommandBuffer& cmd, const Image& destination, uint32_t srcMip, uint32_t dstMip) const
+{
+	// -- Setup Copy, both mips must have the same extent --
+	VkImageCopy2 region{};
+	region.sType = VK_STRUCTURE_TYPE_IMAGE_COPY_2;
+	region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.srcSubresource.mipLevel = srcMip;
+	region.srcSubresource.baseArrayLayer = 0;
+	region.srcSubresource.layerCount = GetLayerCount();
+	region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.dstSubresource.mipLevel = dstMip;
+	region.dstSubresource.baseArrayLayer = 0;
+	region.dstSubresource.layerCount = destination.GetLayerCount();
+	region.extent.width = std::max(GetExtent3D().width >> srcMip, 1u);
+	region.extent.height = std::max(GetExtent3D().height >> srcMip, 1u);
+	region.extent.depth = 1;
+
+	VkCopyImageInfo2 copyInfo{};
+	copyInfo.sType = VK_STRUCTURE_TYPE_COPY_IMAGE_INFO_2;
+	copyInfo.srcImage = GetHandle();
+	copyInfo.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	copyInfo.dstImage = destination.GetHandle();
+	copyInfo.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	copyInfo.regionCount = 1;
+	copyInfo.pRegions = &region;
+
+	vkCmdCopyImage2(cmd.GetHandle(), &copyInfo);
+}
+
 void pompeii::Image::TransitionLayout(const CommandBuffer& cmd, VkImageLayout newLayout,
 								  VkAccessFlags2 srcAccess, VkPipelineStageFlags2 srcStage,
 								  VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage,
@@ -535,6 +565,11 @@ pompeii::ImageBuilder& pompeii::ImageBuilder::InitialData(void* data, uint32_t o
 	m_FinalLayout = finalLayout;
 	return *this;
 }
+pompeii::ImageBuilder& pompeii::ImageBuilder::AddPrecomputedMip(uint32_t dataOffset, uint32_t width, uint32_t height)
+{
+	m_vPrecomputedMips.emplace_back(dataOffset, width, height);
+	return *this;
+}
 pompeii::ImageBuilder& pompeii::ImageBuilder::SetPreMadeImage(VkImage image)
 {
 	m_PreMadeImage = image;
@@ -542,6 +577,12 @@ pompeii::ImageBuilder& pompeii::ImageBuilder::SetPreMadeImage(VkImage image)
 }
 
 void pompeii::ImageBuilder::Build(const Context& context, Image& image) const
+{
+	UploadBatch batch{};
+	Build(context, image, batch);
+	batch.Submit(context);
+}
+void pompeii::ImageBuilder::Build(const Context& context, Image& image, UploadBatch& batch) const
 {
 	image.m_ImageInfo = m_ImageInfo;
 	image.m_CurrentLayout = m_ImageInfo.initialLayout;
@@ -554,33 +595,59 @@ void pompeii::ImageBuilder::Build(const Context& context, Image& image) const
 
 	if (m_UseInitialData)
 	{
-		Buffer stagingBuffer;
-		BufferAllocator stagingAllocator{};
-		stagingAllocator
-			.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
-			.HostAccess(true)
-			.SetSize(m_InitDataSize)
-			.Allocate(context, stagingBuffer);
-		vmaCopyMemoryToAllocation(context.allocator, m_pData, stagingBuffer.GetMemoryHandle(), m_InitDataOffset, m_InitDataSize);
-
-		CommandBuffer& cmd = context.commandPool->AllocateCmdBuffers(1);
-		cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-		{
-			image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-								   0, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
-								   VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-								   0, m_ImageInfo.mipLevels, 0, m_ImageInfo.arrayLayers);
-			stagingBuffer.CopyToImage(cmd, image, VkExtent3D{ m_InitDataWidth, m_InitDataHeight, 1 }, 0, 0, 1);
-			image.GenerateMipMaps(context, cmd, m_InitDataWidth, m_InitDataHeight, m_ImageInfo.mipLevels, m_ImageInfo.arrayLayers, m_FinalLayout);
-		}
-		cmd.End();
-		cmd.Submit(context.device.GetGraphicQueue(), true);
-		cmd.Free(context.device);
-		stagingBuffer.Destroy(context);
+		// Block compressed formats can't be blitted, so those come with every mip precomputed
+		batch.AddImageCopy(context, image, m_pData, m_InitDataOffset + m_InitDataSize, GetInitialRegions(), m_FinalLayout, m_vPrecomputedMips.empty());
+	}
+
+	if (m_pName)
+	{
+		RenderDebugger::SetDebugObjectName(reinterpret_cast<uint64_t>(image.GetHandle()), VK_OBJECT_TYPE_IMAGE, m_pName);
 	}
+}
+
+uint64_t pompeii::ImageBuilder::BuildAsync(const Context& context, Image& image, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage) const
+{
+	const bool hasAllMips = !m_vPrecomputedMips.empty() || m_ImageInfo.mipLevels == 1;
+	if (!context.uploader || !m_UseInitialData || !hasAllMips || m_PreMadeImage != VK_NULL_HANDLE)
+	{
+		Build(context, image);
+		return 0;
+	}
+
+	image.m_ImageInfo = m_ImageInfo;
+	image.m_CurrentLayout = m_ImageInfo.initialLayout;
+	if (vmaCreateImage(context.allocator, &m_ImageInfo, &m_AllocInfo, &image.m_Image, &image.m_ImageMemory, nullptr) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create Image!");
+
+	const uint64_t ticket = context.uploader->UploadImage(context, image, m_pData, m_InitDataOffset + m_InitDataSize, GetInitialRegions(), m_FinalLayout, dstAccess, dstStage);
 
 	if (m_pName)
 	{
 		RenderDebugger::SetDebugObjectName(reinterpret_cast<uint64_t>(image.GetHandle()), VK_OBJECT_TYPE_IMAGE, m_pName);
 	}
+	return ticket;
 }
+
+std::vector<VkBufferImageCopy> pompeii::ImageBuilder::GetInitialRegions() const
+{
+	// -- Mip 0 only when the rest gets blitted, otherwise one region per precomputed mip --
+	std::vector<VkBufferImageCopy> vRegions{};
+	auto addRegion = [&](uint32_t mip, uint32_t width, uint32_t height, VkDeviceSize bufferOffset)
+		{
+			VkBufferImageCopy& region = vRegions.emplace_back();
+			region.bufferOffset = bufferOffset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = mip;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageExtent = VkExtent3D{ width, height, 1 };
+		};
+	if (m_vPrecomputedMips.empty())
+		addRegion(0, m_InitDataWidth, m_InitDataHeight, m_InitDataOffset);
+	for (uint32_t mip{}; mip < static_cast<uint32_t>(m_vPrecomputedMips.size()); ++mip)
+	{
+		const PrecomputedMip& data = m_vPrecomputedMips[mip];
+		addRegion(mip, data.width, data.height, m_InitDataOffset + data.dataOffset);
+	}
+	return vRegions;
+}
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace pompeii
 	class PhysicalDevice;
 	class CommandPool;
 	class CommandBuffer;
+	class UploadBatch;
 	struct Context;
 }
 
@@ -96,6 +97,7 @@ namespace pompeii
 		//    Commands
 		//--------------------------------------------------
 		void BlitImage(const CommandBuffer& cmd, const Image& destination) const;
+		void CopyMip(const CommandBuffer& cmd, const Image& destination, uint32_t srcMip, uint32_t dstMip) const;
 		void TransitionLayout(const CommandBuffer& cmd, VkImageLayout newLayout,
 							  VkAccessFlags2 srcAccess, VkPipelineStageFlags2 srcStage,
 							  VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage,
@@ -116,6 +118,8 @@ namespace pompeii
 
 		friend class ImageBuilder;
 		friend class SwapChainBuilder;
+		friend class AsyncUploader;
+		friend class UploadBatch;
 	};
 
 
@@ -152,11 +156,18 @@ namespace pompeii
 		ImageBuilder& SetSharingMode(VkSharingMode sharingMode);
 		ImageBuilder& SetImageType(VkImageType type);
 		ImageBuilder& InitialData(void* data, uint32_t offset, uint32_t width, uint32_t height, uint32_t dataSize, VkImageLayout finalLayout);
+		ImageBuilder& AddPrecomputedMip(uint32_t dataOffset, uint32_t width, uint32_t height);
 		ImageBuilder& SetPreMadeImage(VkImage image);
 
 		void Build(const Context& context, Image& image) const;
+		// Records the initial data into batch instead of submitting it, image has to stay alive until the batch is submitted
+		void Build(const Context& context, Image& image, UploadBatch& batch) const;
+		// Initial data goes through the context's uploader when every mip is in it, mips that need blitting fall back to Build
+		uint64_t BuildAsync(const Context& context, Image& image, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage) const;
 
 	private:
+		std::vector<VkBufferImageCopy> GetInitialRegions() const;
+
 		bool m_UseInitialData;
 		void* m_pData;
 		uint32_t m_InitDataSize;
@@ -165,6 +176,14 @@ namespace pompeii
 		uint32_t m_InitDataOffset;
 		VkImageLayout m_FinalLayout;
 
+		struct PrecomputedMip
+		{
+			uint32_t dataOffset;
+			uint32_t width;
+			uint32_t height;
+		};
+		std::vector<PrecomputedMip> m_vPrecomputedMips{};
+
 		const char* m_pName{};
 
 		VkImage m_PreMadeImage;
@@ -25,7 +25,9 @@ namespace pompeii
 	{
 		std::vector<VkSemaphore>			vWaitSemaphores;
 		std::vector<VkPipelineStageFlags>	vWaitStages;
+		std::vector<uint64_t>				vWaitValues;		// timeline semaphores only, binary ones may leave it short
 		std::vector<VkSemaphore>			vSignalSemaphores;
+		std::vector<uint64_t>				vSignalValues;		// timeline semaphores only, binary ones may leave it short
 	};
 
 
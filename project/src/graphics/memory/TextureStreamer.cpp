@@ -0,0 +1,399 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cmath>
+
+// -- Pompeii Includes --
+#include "TextureStreamer.h"
+#include "Context.h"
+#include "CommandBuffer.h"
+#include "Material.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Texture Streamer
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::TextureStreamer::Initialize(const Context& context, const TextureStreamerCreateInfo& createInfo)
+{
+	m_MaxFramesInFlight = context.maxFramesInFlight;
+	m_vDirtySlots.resize(m_MaxFramesInFlight);
+
+	m_Budget = createInfo.budget;
+	if (m_Budget == 0)
+	{
+		VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+		vmaGetHeapBudgets(context.allocator, budgets);
+		const VkPhysicalDeviceMemoryProperties* pProperties{};
+		vmaGetMemoryProperties(context.allocator, &pProperties);
+		for (uint32_t heapIdx{}; heapIdx < pProperties->memoryHeapCount; ++heapIdx)
+		{
+			if (pProperties->memoryHeaps[heapIdx].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+				m_Budget = std::max(m_Budget, budgets[heapIdx].budget / 2);
+		}
+	}
+}
+void pompeii::TextureStreamer::Destroy(const Context& context)
+{
+	ReleaseRetired(context, true);
+	for (StreamedTexture& texture : m_vTextures)
+		texture.image.Destroy(context);
+	m_vTextures.clear();
+	m_vPendingTextures.clear();
+	m_HasPendingTextures = false;
+	m_ResidentSize = 0;
+}
+
+//--------------------------------------------------
+//    Streaming
+//--------------------------------------------------
+void pompeii::TextureStreamer::SetTextures(const std::vector<Texture*>& vTextures)
+{
+	// -- Picked up by the next Update, so the slots never change in the middle of recording --
+	m_vPendingTextures = vTextures;
+	m_HasPendingTextures = true;
+}
+void pompeii::TextureStreamer::Request(uint32_t slot, float texCoordsPerPixel)
+{
+	if (slot >= m_vTextures.size())
+		return;
+
+	StreamedTexture& texture = m_vTextures[slot];
+	texture.lastUsedFrame = m_FrameCount;
+	if (!texture.streamable)
+		return;
+
+	// -- Mip whose texels are about the size of a pixel --
+	const glm::ivec2 extent = texture.pTexture->GetExtent();
+	const float texelsPerPixel = texCoordsPerPixel * static_cast<float>(std::max(extent.x, extent.y));
+	uint32_t mip = 0;
+	if (texelsPerPixel > 1.f)
+		mip = static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+	texture.requestedMip = std::min({ texture.requestedMip, mip, texture.tailMip });
+}
+void pompeii::TextureStreamer::Update(const Context& context, const CommandBuffer& commandBuffer)
+{
+	++m_FrameCount;
+	ReleaseRetired(context, false);
+	if (m_HasPendingTextures)
+		ApplyPendingTextures();
+
+	// -- New Textures, the tail goes in regardless of the budget so every slot can be sampled --
+	VkDeviceSize uploadSize{};
+	std::vector<uint32_t> vCandidates{};
+	for (uint32_t slot{}; slot < m_vTextures.size(); ++slot)
+	{
+		StreamedTexture& texture = m_vTextures[slot];
+		texture.wantedMip = texture.requestedMip;
+		texture.requestedMip = texture.tailMip;
+		if (texture.residentMip == texture.mipCount && texture.targetMip == texture.mipCount)
+		{
+			texture.targetMip = texture.tailMip;
+			m_ResidentSize += GetRangeSize(texture, texture.targetMip, texture.mipCount);
+			uploadSize += GetRangeSize(texture, texture.targetMip, texture.mipCount);
+		}
+		if (texture.streamable && texture.wantedMip < texture.targetMip)
+			vCandidates.push_back(slot);
+	}
+
+	// -- Stream In, most recently used first, then the ones missing the most detail --
+	std::ranges::sort(vCandidates, [&](uint32_t a, uint32_t b)
+		{
+			const StreamedTexture& textureA = m_vTextures[a];
+			const StreamedTexture& textureB = m_vTextures[b];
+			if (textureA.lastUsedFrame != textureB.lastUsedFrame)
+				return textureA.lastUsedFrame > textureB.lastUsedFrame;
+			return textureA.targetMip - textureA.wantedMip > textureB.targetMip - textureB.wantedMip;
+		});
+	for (uint32_t slot : vCandidates)
+	{
+		StreamedTexture& texture = m_vTextures[slot];
+		const VkDeviceSize cost = GetRangeSize(texture, texture.wantedMip, texture.targetMip);
+		if (uploadSize > 0 && uploadSize + cost > MAX_UPLOAD_SIZE)
+			continue;
+		while (m_ResidentSize + cost > m_Budget && EvictOne(texture.lastUsedFrame))
+			;
+		if (m_ResidentSize + cost > m_Budget)
+			continue;
+
+		texture.targetMip = texture.wantedMip;
+		m_ResidentSize += cost;
+		uploadSize += cost;
+	}
+
+	// -- Over Budget, what was drawn last frame stays --
+	while (m_ResidentSize > m_Budget && EvictOne(m_FrameCount - 1))
+		;
+
+	// -- Rebuild Changed Textures --
+	std::vector<uint32_t> vRebuilds{};
+	VkDeviceSize stagingSize{};
+	for (uint32_t slot{}; slot < m_vTextures.size(); ++slot)
+	{
+		const StreamedTexture& texture = m_vTextures[slot];
+		if (texture.targetMip == texture.residentMip)
+			continue;
+
+		vRebuilds.push_back(slot);
+		if (!texture.streamable)
+		{
+			// Only the top mip is staged, the rest is generated from it
+			stagingSize += (texture.pTexture->GetMemorySize() + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+			continue;
+		}
+		// Mips that are already resident get copied on the GPU, only the new ones need staging
+		for (uint32_t mip{ texture.targetMip }; mip < std::min(texture.residentMip, texture.mipCount); ++mip)
+			stagingSize += (GetMipSize(texture, mip) + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+	}
+	if (vRebuilds.empty())
+		return;
+
+	Buffer stagingBuffer{};
+	BufferAllocator stagingAllocator{};
+	stagingAllocator
+		.SetDebugName("Staging Buffer (Texture Streaming)")
+		.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+		.HostAccess(true)
+		.SetSize(static_cast<uint32_t>(std::max(stagingSize, STAGING_ALIGNMENT)))
+		.Allocate(context, stagingBuffer);
+
+	VkDeviceSize stagingOffset{};
+	for (uint32_t slot : vRebuilds)
+		Rebuild(context, commandBuffer, slot, stagingBuffer, stagingOffset);
+	m_vRetiredBuffers.push_back({ std::move(stagingBuffer), m_FrameCount });
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+void pompeii::TextureStreamer::SetBudget(VkDeviceSize budget)	{ m_Budget = budget; }
+VkDeviceSize pompeii::TextureStreamer::GetBudget() const		{ return m_Budget; }
+VkDeviceSize pompeii::TextureStreamer::GetResidentSize() const	{ return m_ResidentSize; }
+
+uint32_t pompeii::TextureStreamer::GetTextureCount() const							{ return static_cast<uint32_t>(m_vTextures.size()); }
+const pompeii::ImageView& pompeii::TextureStreamer::GetView(uint32_t slot) const	{ return m_vTextures.at(slot).image.GetView(); }
+const std::vector<uint32_t>& pompeii::TextureStreamer::GetDirtySlots(uint32_t frameIndex) const { return m_vDirtySlots.at(frameIndex); }
+void pompeii::TextureStreamer::ClearDirtySlots(uint32_t frameIndex)					{ m_vDirtySlots.at(frameIndex).clear(); }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::TextureStreamer::ApplyPendingTextures()
+{
+	std::vector<StreamedTexture> vTextures(m_vPendingTextures.size());
+	for (uint32_t slot{}; slot < m_vPendingTextures.size(); ++slot)
+	{
+		const Texture* pTexture = m_vPendingTextures[slot];
+		StreamedTexture& texture = vTextures[slot];
+		if (!pTexture)
+			continue;
+
+		// -- Keep what is already resident --
+		const auto it = std::ranges::find(m_vTextures, pTexture, &StreamedTexture::pTexture);
+		if (it != m_vTextures.end())
+		{
+			texture = std::move(*it);
+			it->pTexture = nullptr;
+			continue;
+		}
+
+		// -- New Texture, nothing resident yet --
+		const glm::ivec2 extent = pTexture->GetExtent();
+		texture.pTexture = pTexture;
+		texture.streamable = pTexture->HasPrecomputedMips();
+		if (texture.streamable)
+		{
+			texture.mipCount = pTexture->GetMipCount();
+			texture.tailMip = texture.mipCount - 1;
+			for (uint32_t mip{}; mip < texture.mipCount; ++mip)
+			{
+				if (std::max(pTexture->GetMip(mip).width, pTexture->GetMip(mip).height) <= TAIL_SIZE)
+				{
+					texture.tailMip = mip;
+					break;
+				}
+			}
+		}
+		else
+		{
+			// Same rule the images were built with before, only big enough textures get mipmaps
+			texture.mipCount = 1;
+			if (extent.x >= 256 || extent.y >= 256)
+				texture.mipCount = static_cast<uint32_t>(std::floor(std::log2(std::max(extent.x, extent.y)))) + 1;
+			texture.tailMip = 0;
+		}
+		texture.residentMip = texture.mipCount;
+		texture.targetMip = texture.mipCount;
+		texture.requestedMip = texture.tailMip;
+		texture.wantedMip = texture.tailMip;
+		texture.lastUsedFrame = m_FrameCount;
+	}
+
+	// -- Textures that were not carried over --
+	for (StreamedTexture& texture : m_vTextures)
+	{
+		if (!texture.pTexture)
+			continue;
+		if (texture.targetMip < texture.mipCount)
+			m_ResidentSize -= GetRangeSize(texture, texture.targetMip, texture.mipCount);
+		RetireImage(texture.image);
+	}
+	m_vTextures = std::move(vTextures);
+	m_vPendingTextures.clear();
+	m_HasPendingTextures = false;
+
+	// -- Slots may have moved, rewrite every resident one --
+	for (uint32_t slot{}; slot < m_vTextures.size(); ++slot)
+	{
+		if (m_vTextures[slot].residentMip < m_vTextures[slot].mipCount)
+			MarkDirty(slot);
+	}
+}
+bool pompeii::TextureStreamer::EvictOne(uint64_t protectedFrame)
+{
+	// -- Detail nobody asked for last frame goes first, then the least recently used textures --
+	StreamedTexture* pVictim{};
+	for (StreamedTexture& texture : m_vTextures)
+	{
+		if (!texture.streamable || texture.targetMip >= std::min(texture.tailMip, texture.wantedMip))
+			continue;
+		if (!pVictim || texture.lastUsedFrame < pVictim->lastUsedFrame)
+			pVictim = &texture;
+	}
+	for (StreamedTexture& texture : m_vTextures)
+	{
+		if (pVictim)
+			break;
+		if (!texture.streamable || texture.targetMip >= texture.tailMip || texture.lastUsedFrame >= protectedFrame)
+			continue;
+		if (!pVictim || texture.lastUsedFrame < pVictim->lastUsedFrame)
+			pVictim = &texture;
+	}
+	if (!pVictim)
+		return false;
+
+	m_ResidentSize -= GetMipSize(*pVictim, pVictim->targetMip);
+	++pVictim->targetMip;
+	return true;
+}
+void pompeii::TextureStreamer::Rebuild(const Context& context, const CommandBuffer& commandBuffer, uint32_t slot, const Buffer& stagingBuffer, VkDeviceSize& stagingOffset)
+{
+	StreamedTexture& texture = m_vTextures[slot];
+	const Texture& source = *texture.pTexture;
+	const uint32_t levels = texture.mipCount - texture.targetMip;
+	const uint32_t width = texture.streamable ? source.GetMip(texture.targetMip).width : static_cast<uint32_t>(source.GetExtent().x);
+	const uint32_t height = texture.streamable ? source.GetMip(texture.targetMip).height : static_cast<uint32_t>(source.GetExtent().y);
+
+	// -- New Image holding the target mips --
+	Image image{};
+	ImageBuilder builder{};
+	builder
+		.SetDebugName(source.GetPath().c_str())
+		.SetWidth(width)
+		.SetHeight(height)
+		.SetFormat(source.GetFormat())
+		.SetTiling(VK_IMAGE_TILING_OPTIMAL)
+		.SetMipLevels(levels)
+		.SetUsageFlags(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+		.SetMemoryProperties(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+		.Build(context, image);
+	image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_NONE,
+		VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+		0, levels, 0, 1);
+
+	if (!texture.streamable)
+	{
+		vmaCopyMemoryToAllocation(context.allocator, source.GetPixels(), stagingBuffer.GetMemoryHandle(), stagingOffset, source.GetMemorySize());
+		stagingBuffer.CopyToImage(commandBuffer, image, VkExtent3D{ width, height, 1 }, 0, 0, 1, stagingOffset);
+		stagingOffset += (source.GetMemorySize() + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+		image.GenerateMipMaps(context, commandBuffer, width, height, levels, 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	}
+	else
+	{
+		// -- Resident mips move over on the GPU, the rest comes from the Texture's CPU data --
+		const bool hasResident = texture.residentMip < texture.mipCount;
+		if (hasResident)
+		{
+			texture.image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+				VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+				0, texture.image.GetMipLevels(), 0, 1);
+		}
+		for (uint32_t mip{ texture.targetMip }; mip < texture.mipCount; ++mip)
+		{
+			if (hasResident && mip >= texture.residentMip)
+			{
+				texture.image.CopyMip(commandBuffer, image, mip - texture.residentMip, mip - texture.targetMip);
+				continue;
+			}
+
+			const TextureMip& data = source.GetMip(mip);
+			vmaCopyMemoryToAllocation(context.allocator, static_cast<const uint8_t*>(source.GetPixels()) + data.offset,
+				stagingBuffer.GetMemoryHandle(), stagingOffset, data.size);
+			stagingBuffer.CopyToImage(commandBuffer, image, VkExtent3D{ data.width, data.height, 1 }, mip - texture.targetMip, 0, 1, stagingOffset);
+			stagingOffset += (data.size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+		}
+		image.TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+			0, levels, 0, 1);
+	}
+
+	// -- Swap, the old Image lives on until no frame in flight can sample it --
+	RetireImage(texture.image);
+	texture.image = std::move(image);
+	texture.image.CreateView(context, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 0, levels, 0, 1);
+	texture.residentMip = texture.targetMip;
+	MarkDirty(slot);
+}
+void pompeii::TextureStreamer::RetireImage(Image& image)
+{
+	if (image.GetHandle() == VK_NULL_HANDLE)
+		return;
+	m_vRetiredImages.push_back({ std::move(image), m_FrameCount });
+}
+void pompeii::TextureStreamer::ReleaseRetired(const Context& context, bool all)
+{
+	// -- Every frame slot's descriptors are rewritten and its fence waited on within maxFramesInFlight frames --
+	const auto isReleasable = [&](uint64_t frame) { return all || frame + m_MaxFramesInFlight <= m_FrameCount; };
+	std::erase_if(m_vRetiredImages, [&](RetiredImage& retired)
+		{
+			if (!isReleasable(retired.frame))
+				return false;
+			retired.image.Destroy(context);
+			return true;
+		});
+	std::erase_if(m_vRetiredBuffers, [&](RetiredBuffer& retired)
+		{
+			if (!isReleasable(retired.frame))
+				return false;
+			retired.buffer.Destroy(context);
+			return true;
+		});
+}
+void pompeii::TextureStreamer::MarkDirty(uint32_t slot)
+{
+	for (std::vector<uint32_t>& vDirtySlots : m_vDirtySlots)
+	{
+		if (std::ranges::find(vDirtySlots, slot) == vDirtySlots.end())
+			vDirtySlots.push_back(slot);
+	}
+}
+
+VkDeviceSize pompeii::TextureStreamer::GetMipSize(const StreamedTexture& texture, uint32_t mip)
+{
+	if (texture.streamable)
+		return texture.pTexture->GetMip(mip).size;
+	// Generated mips, each a quarter of the one above
+	return std::max(VkDeviceSize{ texture.pTexture->GetMemorySize() } >> (2 * mip), VkDeviceSize{ 1 });
+}
+VkDeviceSize pompeii::TextureStreamer::GetRangeSize(const StreamedTexture& texture, uint32_t firstMip, uint32_t lastMip)
+{
+	VkDeviceSize size{};
+	for (uint32_t mip{ firstMip }; mip < lastMip; ++mip)
+		size += GetMipSize(texture, mip);
+	return size;
+}
@@ -0,0 +1,137 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+// -- Vulkan Includes --
+#include <vma/vk_mem_alloc.h>
+
+// -- Standard Library --
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Buffer.h"
+#include "Image.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class CommandBuffer;
+	class Texture;
+	struct Context;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Create Info
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	struct TextureStreamerCreateInfo
+	{
+		// -- 0 takes half of what VMA reports as available in the device local heap --
+		VkDeviceSize budget{};
+	};
+
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Texture Streamer
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class TextureStreamer final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit TextureStreamer() = default;
+		~TextureStreamer() = default;
+		TextureStreamer(const TextureStreamer& other) = delete;
+		TextureStreamer(TextureStreamer&& other) noexcept = delete;
+		TextureStreamer& operator=(const TextureStreamer& other) = delete;
+		TextureStreamer& operator=(TextureStreamer&& other) noexcept = delete;
+
+		void Initialize(const Context& context, const TextureStreamerCreateInfo& createInfo);
+		void Destroy(const Context& context);
+
+		//--------------------------------------------------
+		//    Streaming
+		//--------------------------------------------------
+		// Slots follow the order of vTextures, nullptr leaves a slot empty, the textures must stay alive until they are replaced
+		void SetTextures(const std::vector<Texture*>& vTextures);
+		// How many texture coordinates one screen pixel covers, mips are picked from it on the next Update
+		void Request(uint32_t slot, float texCoordsPerPixel);
+		// Records uploads and evictions, the frame's fence must have been waited on
+		void Update(const Context& context, const CommandBuffer& commandBuffer);
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		void SetBudget(VkDeviceSize budget);
+		VkDeviceSize GetBudget() const;
+		VkDeviceSize GetResidentSize() const;
+
+		uint32_t GetTextureCount() const;
+		const ImageView& GetView(uint32_t slot) const;
+		// Slots whose view changed since the frame's descriptors were last written
+		const std::vector<uint32_t>& GetDirtySlots(uint32_t frameIndex) const;
+		void ClearDirtySlots(uint32_t frameIndex);
+
+		// -- Mips this size and smaller stay resident from the first frame on --
+		static constexpr uint32_t TAIL_SIZE{ 64 };
+		static constexpr VkDeviceSize MAX_UPLOAD_SIZE{ 32 * 1024 * 1024 };
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		struct StreamedTexture
+		{
+			const Texture* pTexture{};
+			Image image{};
+
+			uint32_t mipCount{};
+			uint32_t tailMip{};				// first mip that is never evicted
+			uint32_t residentMip{};			// first mip in image, mipCount while nothing is resident
+			uint32_t targetMip{};
+			uint32_t requestedMip{};		// finest mip asked for while recording the current frame
+			uint32_t wantedMip{};			// requestedMip of the last recorded frame
+			uint64_t lastUsedFrame{};
+
+			// -- Textures without stored mips generate them on the GPU, so they can only be fully resident --
+			bool streamable{};
+		};
+		struct RetiredImage
+		{
+			Image image;
+			uint64_t frame;
+		};
+		struct RetiredBuffer
+		{
+			Buffer buffer;
+			uint64_t frame;
+		};
+
+		void ApplyPendingTextures();
+		bool EvictOne(uint64_t protectedFrame);
+		void Rebuild(const Context& context, const CommandBuffer& commandBuffer, uint32_t slot, const Buffer& stagingBuffer, VkDeviceSize& stagingOffset);
+		void RetireImage(Image& image);
+		void ReleaseRetired(const Context& context, bool all);
+		void MarkDirty(uint32_t slot);
+
+		static constexpr VkDeviceSize STAGING_ALIGNMENT{ 16 };
+		static VkDeviceSize GetMipSize(const StreamedTexture& texture, uint32_t mip);
+		static VkDeviceSize GetRangeSize(const StreamedTexture& texture, uint32_t firstMip, uint32_t lastMip);
+
+		std::vector<StreamedTexture>	m_vTextures			{ };
+		std::vector<Texture*>			m_vPendingTextures	{ };
+		bool							m_HasPendingTextures{ false };
+
+		std::vector<RetiredImage>		m_vRetiredImages	{ };
+		std::vector<RetiredBuffer>		m_vRetiredBuffers	{ };
+		std::vector<std::vector<uint32_t>> m_vDirtySlots	{ };
+
+		VkDeviceSize					m_Budget			{ };
+		VkDeviceSize					m_ResidentSize		{ };
+		uint64_t						m_FrameCount		{ };
+		uint32_t						m_MaxFramesInFlight	{ };
+	};
+}
+
+#endif // TEXTURE_STREAMER_H
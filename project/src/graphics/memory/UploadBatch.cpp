@@ -0,0 +1,410 @@
+// -- Standard Library --
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "UploadBatch.h"
+#include "Context.h"
+#include "CommandPool.h"
+#include "Image.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Staging Ring
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::StagingRing::Initialize(Context& context, VkDeviceSize size)
+{
+	BufferAllocator allocator{};
+	allocator
+		.SetDebugName("Staging Ring")
+		.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+		.HostAccess(true)
+		.SetSize(static_cast<uint32_t>(size))
+		.Allocate(context, m_Buffer);
+
+	// -- Mapped once for its whole life --
+	void* pData{};
+	if (vmaMapMemory(context.allocator, m_Buffer.GetMemoryHandle(), &pData) != VK_SUCCESS)
+		throw std::runtime_error("Failed to map Staging Ring!");
+	m_pMappedData = static_cast<std::byte*>(pData);
+	m_Size = size;
+	m_Head = 0;
+
+	// -- Timeline Semaphore, one value per submit --
+	VkSemaphoreTypeCreateInfo typeInfo{};
+	typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	typeInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &typeInfo;
+
+	if (vkCreateSemaphore(context.device.GetHandle(), &semaphoreInfo, nullptr, &m_Semaphore) != VK_SUCCESS)
+		throw std::runtime_error("Failed to create Staging Ring Timeline Semaphore!");
+	m_SubmittedValue = 0;
+
+	m_CommandPool.Create(context);
+	m_pContext = &context;
+}
+void pompeii::StagingRing::Destroy(const Context& context)
+{
+	std::scoped_lock lock{ m_Mutex };
+	for (InFlightSubmit& submit : m_vInFlight)
+	{
+		submit.commandBuffer.Free(context.device);
+		for (const Buffer& buffer : submit.vStaging)
+			buffer.Destroy(context);
+	}
+	m_vInFlight.clear();
+	m_Regions.clear();
+	m_CommandPool.Destroy();
+	vkDestroySemaphore(context.device.GetHandle(), m_Semaphore, nullptr);
+	m_Semaphore = VK_NULL_HANDLE;
+
+	vmaUnmapMemory(context.allocator, m_Buffer.GetMemoryHandle());
+	m_Buffer.Destroy(context);
+	m_pMappedData = nullptr;
+	m_Size = 0;
+}
+
+//--------------------------------------------------
+//    Allocation
+//--------------------------------------------------
+bool pompeii::StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+	std::scoped_lock lock{ m_Mutex };
+	Reclaim();
+
+	// -- Free space is [head, end) and [0, oldest) while the regions in use don't wrap, [head, oldest) once they do --
+	// Regions are never empty, so a head on the oldest region means the ring is full
+	size = std::max(size, VkDeviceSize{ 1 });
+	const bool wrapped = !m_Regions.empty() && m_Head <= m_Regions.front().begin;
+	const VkDeviceSize limit = wrapped ? m_Regions.front().begin : m_Size;
+	VkDeviceSize begin = (m_Head + alignment - 1) / alignment * alignment;
+	if (begin + size > limit)
+	{
+		if (wrapped || m_Regions.empty() || size > m_Regions.front().begin)
+			return false;
+		begin = 0;
+	}
+
+	m_Regions.push_back({ begin, begin + size, VK_NULL_HANDLE, 0 });
+	m_Head = begin + size;
+	offset = begin;
+	return true;
+}
+void pompeii::StagingRing::Retire(const std::vector<VkDeviceSize>& vOffsets, VkSemaphore semaphore, uint64_t value)
+{
+	std::scoped_lock lock{ m_Mutex };
+	for (VkDeviceSize offset : vOffsets)
+	{
+		const auto it = std::ranges::find_if(m_Regions, [offset](const Region& region)
+			{
+				return region.begin == offset && region.semaphore == VK_NULL_HANDLE;
+			});
+		if (it == m_Regions.end())
+			continue;
+		it->semaphore = semaphore;
+		it->value = value;
+	}
+}
+
+//--------------------------------------------------
+//    Submits
+//--------------------------------------------------
+pompeii::CommandBuffer pompeii::StagingRing::AllocateCommandBuffer()
+{
+	// -- Moved out of the pool so it stays valid while the pool hands out more buffers --
+	std::scoped_lock lock{ m_Mutex };
+	return std::move(m_CommandPool.AllocateCmdBuffers(1));
+}
+uint64_t pompeii::StagingRing::Submit(const Context& context, CommandBuffer&& commandBuffer, std::vector<Buffer>&& vStaging)
+{
+	// -- Values have to be signaled in order, picking one and submitting happen under the same lock --
+	std::scoped_lock lock{ m_Mutex };
+	const uint64_t value = ++m_SubmittedValue;
+	const SemaphoreInfo semaphoreInfo
+	{
+		.vSignalSemaphores = { m_Semaphore },
+		.vSignalValues = { value }
+	};
+	commandBuffer.Submit(context.device.GetGraphicQueue(), false, semaphoreInfo);
+	m_vInFlight.emplace_back(std::move(commandBuffer), std::move(vStaging), value);
+	return value;
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+const pompeii::Buffer& pompeii::StagingRing::GetBuffer() const { return m_Buffer; }
+std::byte* pompeii::StagingRing::GetMappedData() const { return m_pMappedData; }
+VkDeviceSize pompeii::StagingRing::GetSize() const { return m_Size; }
+const VkSemaphore& pompeii::StagingRing::GetSemaphore() const { return m_Semaphore; }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::StagingRing::Reclaim()
+{
+	// -- Regions come back in the order they were handed out --
+	const VkDevice device = m_pContext->device.GetHandle();
+	while (!m_Regions.empty())
+	{
+		const Region& region = m_Regions.front();
+		uint64_t completedValue{};
+		if (region.semaphore == VK_NULL_HANDLE)
+			break;
+		vkGetSemaphoreCounterValue(device, region.semaphore, &completedValue);
+		if (completedValue < region.value)
+			break;
+		m_Regions.pop_front();
+	}
+	if (m_Regions.empty())
+		m_Head = 0;
+
+	// -- Command Buffers and oversized Staging of finished submits --
+	uint64_t completedValue{};
+	vkGetSemaphoreCounterValue(device, m_Semaphore, &completedValue);
+	std::erase_if(m_vInFlight, [&](InFlightSubmit& submit)
+		{
+			if (submit.value > completedValue)
+				return false;
+			submit.commandBuffer.Free(m_pContext->device);
+			for (const Buffer& buffer : submit.vStaging)
+				buffer.Destroy(*m_pContext);
+			return true;
+		});
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Upload Batch
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Recording
+//--------------------------------------------------
+void pompeii::UploadBatch::AddBufferCopy(const Context& context, const Buffer& dst, const void* pData, VkDeviceSize size, VkDeviceSize dstOffset)
+{
+	if (size == 0)
+		return;
+
+	VkDeviceSize stagingOffset{};
+	const VkBuffer src = Stage(context, pData, size, stagingOffset);
+	m_vBufferCopies.emplace_back(src, dst.GetHandle(), VkBufferCopy{ stagingOffset, dstOffset, size });
+}
+void pompeii::UploadBatch::AddImageCopy(const Context& context, Image& dst, const void* pData, VkDeviceSize size,
+										const std::vector<VkBufferImageCopy>& vRegions, VkImageLayout finalLayout, bool generateMips)
+{
+	if (generateMips && dst.GetMipLevels() > 1)
+	{
+		const VkFormatProperties formatProperties = context.physicalDevice.GetFormatProperties(dst.GetFormat());
+		if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+			throw std::runtime_error("texture image format does not support linear blitting!");
+	}
+
+	VkDeviceSize stagingOffset{};
+	const VkBuffer src = Stage(context, pData, size, stagingOffset);
+	ImageCopy& copy = m_vImageCopies.emplace_back(&dst, src, vRegions, finalLayout, generateMips && dst.GetMipLevels() > 1);
+	for (VkBufferImageCopy& region : copy.vRegions)
+		region.bufferOffset += stagingOffset;
+}
+
+void pompeii::UploadBatch::Submit(const Context& context)
+{
+	if (IsEmpty())
+		return;
+
+	StagingRing* pRing = context.stagingRing;
+	CommandBuffer cmd = pRing ? pRing->AllocateCommandBuffer() : std::move(context.commandPool->AllocateCmdBuffers(1));
+	cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	{
+		auto pipelineBarrier = [&](const std::vector<VkImageMemoryBarrier2>& vImageBarriers, const VkMemoryBarrier2* pMemoryBarrier)
+			{
+				if (vImageBarriers.empty() && !pMemoryBarrier)
+					return;
+				VkDependencyInfo dependencyInfo{};
+				dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+				dependencyInfo.memoryBarrierCount = pMemoryBarrier ? 1 : 0;
+				dependencyInfo.pMemoryBarriers = pMemoryBarrier;
+				dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(vImageBarriers.size());
+				dependencyInfo.pImageMemoryBarriers = vImageBarriers.data();
+				vkCmdPipelineBarrier2(cmd.GetHandle(), &dependencyInfo);
+			};
+		auto imageBarrier = [](const Image& image, uint32_t baseMip, uint32_t mipCount, VkImageLayout oldLayout, VkImageLayout newLayout,
+							   VkAccessFlags2 srcAccess, VkPipelineStageFlags2 srcStage, VkAccessFlags2 dstAccess, VkPipelineStageFlags2 dstStage)
+			{
+				VkImageMemoryBarrier2 barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+				barrier.image = image.GetHandle();
+				barrier.oldLayout = oldLayout;
+				barrier.newLayout = newLayout;
+				barrier.srcAccessMask = srcAccess;
+				barrier.srcStageMask = srcStage;
+				barrier.dstAccessMask = dstAccess;
+				barrier.dstStageMask = dstStage;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseMip, mipCount, 0, image.GetLayerCount() };
+				return barrier;
+			};
+		std::vector<VkImageMemoryBarrier2> vBarriers{};
+
+		// -- Every Image ready for Copies in one Barrier --
+		for (const ImageCopy& copy : m_vImageCopies)
+		{
+			vBarriers.push_back(imageBarrier(*copy.pImage, 0, copy.pImage->GetMipLevels(),
+				copy.pImage->GetCurrentLayout(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_NONE,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT));
+		}
+		pipelineBarrier(vBarriers, nullptr);
+
+		// -- Copies, runs with the same source and destination go in one call --
+		for (size_t begin{}; begin < m_vBufferCopies.size();)
+		{
+			std::vector<VkBufferCopy> vRegions{};
+			size_t end = begin;
+			while (end < m_vBufferCopies.size() && m_vBufferCopies[end].src == m_vBufferCopies[begin].src && m_vBufferCopies[end].dst == m_vBufferCopies[begin].dst)
+				vRegions.push_back(m_vBufferCopies[end++].region);
+			vkCmdCopyBuffer(cmd.GetHandle(), m_vBufferCopies[begin].src, m_vBufferCopies[begin].dst, static_cast<uint32_t>(vRegions.size()), vRegions.data());
+			begin = end;
+		}
+		for (const ImageCopy& copy : m_vImageCopies)
+		{
+			vkCmdCopyBufferToImage(cmd.GetHandle(), copy.src, copy.pImage->GetHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				static_cast<uint32_t>(copy.vRegions.size()), copy.vRegions.data());
+		}
+
+		// -- Mips, one level of every Image per Barrier --
+		uint32_t maxMips{ 1 };
+		for (const ImageCopy& copy : m_vImageCopies)
+		{
+			if (copy.generateMips)
+				maxMips = std::max(maxMips, copy.pImage->GetMipLevels());
+		}
+		for (uint32_t mip{ 1 }; mip < maxMips; ++mip)
+		{
+			vBarriers.clear();
+			for (const ImageCopy& copy : m_vImageCopies)
+			{
+				if (!copy.generateMips || mip >= copy.pImage->GetMipLevels())
+					continue;
+				vBarriers.push_back(imageBarrier(*copy.pImage, mip - 1, 1,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT,
+					VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_BLIT_BIT));
+			}
+			pipelineBarrier(vBarriers, nullptr);
+
+			for (const ImageCopy& copy : m_vImageCopies)
+			{
+				if (!copy.generateMips || mip >= copy.pImage->GetMipLevels())
+					continue;
+				const VkExtent3D extent = copy.pImage->GetExtent3D();
+				const int32_t srcWidth = static_cast<int32_t>(std::max(extent.width >> (mip - 1), 1u));
+				const int32_t srcHeight = static_cast<int32_t>(std::max(extent.height >> (mip - 1), 1u));
+
+				VkImageBlit2 blit{};
+				blit.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2;
+				blit.srcOffsets[1] = { .x = srcWidth, .y = srcHeight, .z = 1 };
+				blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip - 1, 0, copy.pImage->GetLayerCount() };
+				blit.dstOffsets[1] = { .x = std::max(srcWidth / 2, 1), .y = std::max(srcHeight / 2, 1), .z = 1 };
+				blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, copy.pImage->GetLayerCount() };
+
+				VkBlitImageInfo2 blitInfo{};
+				blitInfo.sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2;
+				blitInfo.srcImage = copy.pImage->GetHandle();
+				blitInfo.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+				blitInfo.dstImage = copy.pImage->GetHandle();
+				blitInfo.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				blitInfo.regionCount = 1;
+				blitInfo.pRegions = &blit;
+				blitInfo.filter = VK_FILTER_LINEAR;
+				vkCmdBlitImage2(cmd.GetHandle(), &blitInfo);
+			}
+		}
+
+		// -- Final Layouts and Buffer visibility in one Barrier --
+		vBarriers.clear();
+		for (const ImageCopy& copy : m_vImageCopies)
+		{
+			const uint32_t mips = copy.pImage->GetMipLevels();
+			if (copy.generateMips)
+			{
+				vBarriers.push_back(imageBarrier(*copy.pImage, 0, mips - 1,
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, copy.finalLayout,
+					VK_ACCESS_2_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_2_BLIT_BIT,
+					VK_ACCESS_2_MEMORY_READ_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+			}
+			const uint32_t firstDstMip = copy.generateMips ? mips - 1 : 0;
+			vBarriers.push_back(imageBarrier(*copy.pImage, firstDstMip, mips - firstDstMip,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copy.finalLayout,
+				VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT,
+				VK_ACCESS_2_MEMORY_READ_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+			copy.pImage->m_CurrentLayout = copy.finalLayout;
+		}
+		VkMemoryBarrier2 memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+		memoryBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		memoryBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+		memoryBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+		pipelineBarrier(vBarriers, m_vBufferCopies.empty() ? nullptr : &memoryBarrier);
+	}
+	cmd.End();
+
+	// -- The ring frees the staging once the GPU is done with it, without a ring there is nothing to hand it to --
+	if (pRing)
+	{
+		const uint64_t value = pRing->Submit(context, std::move(cmd), std::move(m_vOversizedStaging));
+		pRing->Retire(m_vRingOffsets, pRing->GetSemaphore(), value);
+	}
+	else
+	{
+		cmd.Submit(context.device.GetGraphicQueue(), true);
+		cmd.Free(context.device);
+		for (const Buffer& buffer : m_vOversizedStaging)
+			buffer.Destroy(context);
+	}
+	m_vOversizedStaging.clear();
+	m_vRingOffsets.clear();
+	m_vBufferCopies.clear();
+	m_vImageCopies.clear();
+}
+bool pompeii::UploadBatch::IsEmpty() const
+{
+	return m_vBufferCopies.empty() && m_vImageCopies.empty();
+}
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+VkBuffer pompeii::UploadBatch::Stage(const Context& context, const void* pData, VkDeviceSize size, VkDeviceSize& offset)
+{
+	StagingRing* pRing = context.stagingRing;
+	if (pRing && pRing->Allocate(size, STAGING_ALIGNMENT, offset))
+	{
+		m_vRingOffsets.push_back(offset);
+		std::memcpy(pRing->GetMappedData() + offset, pData, size);
+		return pRing->GetBuffer().GetHandle();
+	}
+
+	// -- Too big for the ring, or the GPU still reads the rest of it --
+	Buffer& stagingBuffer = m_vOversizedStaging.emplace_back();
+	BufferAllocator stagingAllocator{};
+	stagingAllocator
+		.SetUsage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+		.HostAccess(true)
+		.SetSize(static_cast<uint32_t>(size))
+		.Allocate(context, stagingBuffer);
+	vmaCopyMemoryToAllocation(context.allocator, pData, stagingBuffer.GetMemoryHandle(), 0, size);
+	offset = 0;
+	return stagingBuffer.GetHandle();
+}
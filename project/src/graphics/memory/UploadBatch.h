@@ -0,0 +1,174 @@
+#ifndef UPLOAD_BATCH_H
+#define UPLOAD_BATCH_H
+
+// -- Vulkan Includes --
+#include <vma/vk_mem_alloc.h>
+
+// -- Standard Library --
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Buffer.h"
+#include "CommandPool.h"
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	class Image;
+	struct Context;
+}
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Staging Ring
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Regions are handed out and reused in order, each one once the timeline value of the submit reading it is reached.
+	// Shared by every thread that uploads, all of it is guarded by one mutex
+	class StagingRing final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit StagingRing() = default;
+		~StagingRing() = default;
+		StagingRing(const StagingRing& other) = delete;
+		StagingRing(StagingRing&& other) noexcept = delete;
+		StagingRing& operator=(const StagingRing& other) = delete;
+		StagingRing& operator=(StagingRing&& other) noexcept = delete;
+
+		void Initialize(Context& context, VkDeviceSize size = DEFAULT_SIZE);
+		// The device must be idle
+		void Destroy(const Context& context);
+
+		//--------------------------------------------------
+		//    Allocation
+		//--------------------------------------------------
+		// False when size does not fit in the part of the ring the GPU is done with
+		bool Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+		// The regions starting at vOffsets are reused once semaphore reaches value, a region never retired holds up the ring
+		void Retire(const std::vector<VkDeviceSize>& vOffsets, VkSemaphore semaphore, uint64_t value);
+
+		//--------------------------------------------------
+		//    Submits
+		//--------------------------------------------------
+		// From the ring's own graphics pool, so recording never touches the frames' pool
+		CommandBuffer AllocateCommandBuffer();
+		// Submits on the graphics queue and signals the returned value on GetSemaphore,
+		// commandBuffer and vStaging are freed once the GPU is done with them
+		uint64_t Submit(const Context& context, CommandBuffer&& commandBuffer, std::vector<Buffer>&& vStaging);
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		const Buffer& GetBuffer() const;
+		std::byte* GetMappedData() const;
+		VkDeviceSize GetSize() const;
+		const VkSemaphore& GetSemaphore() const;
+
+		static constexpr VkDeviceSize DEFAULT_SIZE{ 64 * 1024 * 1024 };
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		// Handed out, semaphore stays VK_NULL_HANDLE until the region is retired
+		struct Region
+		{
+			VkDeviceSize begin;
+			VkDeviceSize end;
+			VkSemaphore semaphore;
+			uint64_t value;
+		};
+		// What a submit of the ring needs until its value is reached
+		struct InFlightSubmit
+		{
+			CommandBuffer commandBuffer;
+			std::vector<Buffer> vStaging;
+			uint64_t value;
+		};
+		// Expects m_Mutex to be held
+		void Reclaim();
+
+		Buffer						m_Buffer			{ };
+		std::byte*					m_pMappedData		{ };
+		VkDeviceSize				m_Size				{ };
+		VkDeviceSize				m_Head				{ };
+		std::deque<Region>			m_Regions			{ };
+
+		CommandPool					m_CommandPool		{ };
+		VkSemaphore					m_Semaphore			{ VK_NULL_HANDLE };
+		uint64_t					m_SubmittedValue	{ };
+		std::vector<InFlightSubmit>	m_vInFlight			{ };
+
+		const Context*				m_pContext			{ };
+		std::mutex					m_Mutex				{ };
+	};
+
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Upload Batch
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class UploadBatch final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit UploadBatch() = default;
+		~UploadBatch() = default;
+		UploadBatch(const UploadBatch& other) = delete;
+		UploadBatch(UploadBatch&& other) noexcept = delete;
+		UploadBatch& operator=(const UploadBatch& other) = delete;
+		UploadBatch& operator=(UploadBatch&& other) noexcept = delete;
+
+		//--------------------------------------------------
+		//    Recording
+		//--------------------------------------------------
+		// Data is staged right away, the destinations have to stay alive until Submit
+		void AddBufferCopy(const Context& context, const Buffer& dst, const void* pData, VkDeviceSize size, VkDeviceSize dstOffset);
+		// Region offsets are relative to pData, with generateMips only mip 0 is given and the rest is blitted from it
+		void AddImageCopy(const Context& context, Image& dst, const void* pData, VkDeviceSize size,
+						  const std::vector<VkBufferImageCopy>& vRegions, VkImageLayout finalLayout, bool generateMips);
+
+		// Records every copy into one command buffer and submits it once without waiting,
+		// later graphics submits see the data and the staging memory is reused once the GPU is done with it
+		void Submit(const Context& context);
+		bool IsEmpty() const;
+
+	private:
+		//--------------------------------------------------
+		//    Helpers
+		//--------------------------------------------------
+		struct BufferCopy
+		{
+			VkBuffer src;
+			VkBuffer dst;
+			VkBufferCopy region;
+		};
+		struct ImageCopy
+		{
+			Image* pImage;
+			VkBuffer src;
+			std::vector<VkBufferImageCopy> vRegions;
+			VkImageLayout finalLayout;
+			bool generateMips;
+		};
+
+		// Returns the buffer holding the data, a buffer of its own when the ring has no room
+		VkBuffer Stage(const Context& context, const void* pData, VkDeviceSize size, VkDeviceSize& offset);
+
+		static constexpr VkDeviceSize STAGING_ALIGNMENT{ 16 };
+
+		std::vector<BufferCopy>		m_vBufferCopies		{ };
+		std::vector<ImageCopy>		m_vImageCopies		{ };
+		std::vector<Buffer>			m_vOversizedStaging	{ };
+		std::vector<VkDeviceSize>	m_vRingOffsets		{ };
+	};
+}
+
+#endif // UPLOAD_BATCH_H
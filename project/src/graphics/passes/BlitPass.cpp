@@ -2,7 +2,7 @@
 #include "BlitPass.h"
 #include "Buffer.h"
 #include "Context.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "DescriptorPool.h"
 #include "GeometryPass.h"
 #include "GPUCamera.h"
@@ -300,7 +300,7 @@ void pompeii::BlitPass::RecordGraphic(const Context& context, CommandBuffer& com
 	const VkCommandBuffer& vCmdBuffer = commandBuffer.GetHandle();
 
 	// -- Render --
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Tone Mapping | Exposure Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	POMPEII_GPU_BEGIN(commandBuffer, "Tone Mapping | Exposure Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
 	vkCmdBeginRendering(vCmdBuffer, &renderingInfo);
 	{
 		// -- Set Dynamic Viewport --
@@ -311,38 +311,38 @@ void pompeii::BlitPass::RecordGraphic(const Context& context, CommandBuffer& com
 		viewport.height = static_cast<float>(renderImage.GetExtent2D().height);
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
 		vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
 
 		// -- Set Dynamic Scissors --
 		VkRect2D scissor;
 		scissor.offset = { .x = 0, .y = 0 };
 		scissor.extent = renderImage.GetExtent2D();
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
 		vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
 
 		// -- Bind Descriptor Sets --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Rendered Image | Camera Settings", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Rendered Image | Camera Settings", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vFragmentDS[imageIndex].GetHandle(), 0, nullptr);
 
 		// -- Draw Triangle --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (Blitting)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (Blitting)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
 		vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Draw Full Screen Triangle", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Draw Full Screen Triangle", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
 		vkCmdDraw(commandBuffer.GetHandle(), 3, 1, 0, 0);
 	}
 	vkCmdEndRendering(vCmdBuffer);
-	RenderDebugger::EndDebugLabel(commandBuffer);
+	POMPEII_GPU_END(commandBuffer);
 }
 void pompeii::BlitPass::RecordCompute(CommandBuffer& commandBuffer, uint32_t imageIndex, const Image& renderImage, const CameraData& camera)
 {
 	// -- Compute --
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Compute Luminance | Exposure Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	POMPEII_GPU_BEGIN(commandBuffer, "Compute Luminance | Exposure Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
 	{
 		// -- Bind First Pipeline --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (Compute | Luminance Histogram)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (Compute | Luminance Histogram)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
 		vkCmdBindPipeline(commandBuffer.GetHandle(), VK_PIPELINE_BIND_POINT_COMPUTE, m_CompPipeHistogram.GetHandle());
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Luminance Histogram Descriptor", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Luminance Histogram Descriptor", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(commandBuffer.GetHandle(), VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipelineLayout.GetHandle(), 0, 1, &m_vComputeLumDS[imageIndex].GetHandle(), 0, nullptr);
 
 		// -- Bind Push Constants --
@@ -376,13 +376,13 @@ void pompeii::BlitPass::RecordCompute(CommandBuffer& commandBuffer, uint32_t ima
 			VK_ACCESS_2_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
 
 		// -- Bind Second Pipeline --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (Compute | Average Luminance)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (Compute | Average Luminance)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
 		vkCmdBindPipeline(commandBuffer.GetHandle(), VK_PIPELINE_BIND_POINT_COMPUTE, m_CompPipeAverageLuminance.GetHandle());
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Average Luminance Histogram Descriptor", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Average Luminance Histogram Descriptor", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(commandBuffer.GetHandle(), VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipelineLayout.GetHandle(), 0, 1, &m_vComputeAveDS[imageIndex].GetHandle(), 0, nullptr);
 
 		// -- Compute 2 --
 		vkCmdDispatch(commandBuffer.GetHandle(), 1, 1, 1);
 	}
-	RenderDebugger::EndDebugLabel(commandBuffer);
+	POMPEII_GPU_END(commandBuffer);
 }
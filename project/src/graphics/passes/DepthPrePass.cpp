@@ -1,11 +1,12 @@
 // -- Pompeii Includes --
 #include "DepthPrePass.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "Shader.h"
 #include "DescriptorPool.h"
 #include "Context.h"
 #include "GeometryPass.h"
 #include "RenderingItems.h"
+#include "GPUCuller.h"
 #include "GPUCamera.h"
 
 void pompeii::DepthPrePass::Initialize(const Context& context, const DepthPrePassCreateInfo& createInfo)
@@ -30,14 +31,11 @@ void pompeii::DepthPrePass::Initialize(const Context& context, const DepthPrePas
 		builder
 			.NewPushConstantRange()
 				.SetPCOffset(0)
-				.SetPCSize(sizeof(PCModelDataVS))
-				.SetPCStageFlags(VK_SHADER_STAGE_VERTEX_BIT)
-			.NewPushConstantRange()
-				.SetPCOffset(sizeof(PCModelDataVS))
-				.SetPCSize(sizeof(glm::uvec3))
+				.SetPCSize(sizeof(PCMaterialDataFS))
 				.SetPCStageFlags(VK_SHADER_STAGE_FRAGMENT_BIT)
 			.AddLayout(m_UniformDSL)
 			.AddLayout(createInfo.pGeometryPass->GetTexturesDescriptorSetLayout())
+			.AddLayout(createInfo.pGPUCuller->GetInstanceDescriptorSetLayout())
 			.Build(context, m_PipelineLayout);
 		m_DeletionQueue.Push([&] {m_PipelineLayout.Destroy(context); });
 	}
@@ -55,6 +53,7 @@ void pompeii::DepthPrePass::Initialize(const Context& context, const DepthPrePas
 		VkPipelineRenderingCreateInfo renderingCreateInfo{};
 		renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
 		renderingCreateInfo.depthAttachmentFormat = createInfo.depthFormat;
+		m_RenderingFormats.depthFormat = createInfo.depthFormat;
 
 		// Create pipeline
 		GraphicsPipelineBuilder builder{};
@@ -72,8 +71,6 @@ void pompeii::DepthPrePass::Initialize(const Context& context, const DepthPrePas
 			.SetPolygonMode(VK_POLYGON_MODE_FILL)
 			.SetDepthTest(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS)
 			//.SetSampleCount(context.physicalDevice.GetMaxSampleCount())
-			.SetVertexBindingDesc(Vertex::GetBindingDescription())
-			.SetVertexAttributeDesc(Vertex::GetAttributeDescriptions())
 			.Build(context, m_Pipeline);
 		m_DeletionQueue.Push([&] { m_Pipeline.Destroy(context); });
 
@@ -125,7 +122,20 @@ void pompeii::DepthPrePass::UpdateCamera(const Context& context, uint32_t imageI
 	ubo.proj = camera.proj;
 	vmaCopyMemoryToAllocation(context.allocator, &ubo, m_vUniformBuffers[imageIndex].GetMemoryHandle(), 0, sizeof(ubo));
 }
-void pompeii::DepthPrePass::Record(CommandBuffer& commandBuffer, const GeometryPass& gPass, uint32_t imageIndex, const Image& depthImage, const std::vector<RenderItem>& renderItems) const
+void pompeii::DepthPrePass::AddDraws(SecondaryRecorder& recorder, const GeometryPass& gPass, const GPUCuller& gpuCuller, uint32_t imageIndex, VkExtent2D extent, uint32_t viewIdx)
+{
+	// -- Camera and instances live in buffers, the secondary only changes with what it records --
+	StateHash state{};
+	state.Add(gpuCuller.GetDrawStateHash(imageIndex)).Add(gPass.GetBoundTextureCount()).Add(extent).Add(viewIdx);
+
+	m_DrawJob = recorder.AddCached(m_RenderingFormats, this, 0, state.Get(), [this, &gPass, &gpuCuller, imageIndex, extent, viewIdx](CommandBuffer& commandBuffer)
+		{
+			RecordDraws(commandBuffer, gPass, gpuCuller, imageIndex, extent, viewIdx);
+		});
+	// Counted on execution, a reused secondary still draws
+	m_DrawCallCount = gpuCuller.GetDrawCallCount(imageIndex, viewIdx);
+}
+void pompeii::DepthPrePass::Record(CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, const Image& depthImage) const
 {
 	// -- Set Up Attachments --
 	VkRenderingAttachmentInfo depthAttachment{};
@@ -136,87 +146,71 @@ void pompeii::DepthPrePass::Record(CommandBuffer& commandBuffer, const GeometryP
 	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 	depthAttachment.clearValue.depthStencil = { .depth = 1.0f, .stencil = 0 };
 
-	// -- Render Info --
+	// -- Render Info, the draws were recorded into a secondary by AddDraws --
 	VkRenderingInfo renderingInfo{};
 	renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+	renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
 	renderingInfo.renderArea = VkRect2D{ VkOffset2D{0, 0}, depthImage.GetExtent2D() };
 	renderingInfo.layerCount = 1;
 	renderingInfo.pDepthAttachment = &depthAttachment;
 
 	// -- Render --
+	POMPEII_GPU_BEGIN(commandBuffer, "Depth Pre-Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	vkCmdBeginRendering(commandBuffer.GetHandle(), &renderingInfo);
+	recorder.Execute(commandBuffer, m_DrawJob);
+	POMPEII_COUNT(Counter::DrawCalls, m_DrawCallCount);
+	vkCmdEndRendering(commandBuffer.GetHandle());
+	POMPEII_GPU_END(commandBuffer);
+}
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::DepthPrePass::RecordDraws(CommandBuffer& commandBuffer, const GeometryPass& gPass, const GPUCuller& gpuCuller, uint32_t imageIndex, VkExtent2D extent, uint32_t viewIdx) const
+{
 	const VkCommandBuffer& vCmdBuffer = commandBuffer.GetHandle();
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Depth Pre-Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
-	vkCmdBeginRendering(vCmdBuffer, &renderingInfo);
-	{
-		// -- Set Dynamic Viewport --
-		VkViewport viewport;
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(depthImage.GetExtent2D().width);
-		viewport.height = static_cast<float>(depthImage.GetExtent2D().height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
-		vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
-
-		// -- Set Dynamic Scissors --
-		VkRect2D scissor;
-		scissor.offset = { .x = 0, .y = 0 };
-		scissor.extent = depthImage.GetExtent2D();
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
-		vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
-
-		// -- Bind Descriptor Sets --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Uniform Buffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
-		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vUniformDS[imageIndex].GetHandle(), 0, nullptr);
-
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Textures", glm::vec4(0.f, 1.f, 1.f, 1.f));
-		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 1, 1, &gPass.GetTexturesDescriptorSet().GetHandle(), 0, nullptr);
-
-		// -- Bind Pipeline --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (Depth PrePass)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
-		vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
-
-		// -- Draw Models --
-		for (uint32_t itemIdx{}; itemIdx < renderItems.size(); ++itemIdx)
-		{
-			const RenderItem& item = renderItems[itemIdx];
-			Mesh* pMesh = item.mesh;
-
-			// -- Bind Model Data --
-			pMesh->Bind(commandBuffer);
-
-			// -- Draw Opaque --
-			for (const SubMesh& subMesh : pMesh->vSubMeshes)
-			{
-				// -- Bind Push Constants --
-				RenderDebugger::InsertDebugLabel(commandBuffer, "Push Constants", glm::vec4(1.f, 0.6f, 0.f, 1.f));
-				PCModelDataVS pcvs
-				{
-					.model = item.transform * subMesh.matrix
-				};
-				vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_VERTEX_BIT, 0,
-					sizeof(PCModelDataVS), &pcvs);
-
-				uint32_t offset = itemIdx > 0 ? static_cast<uint32_t>(renderItems[itemIdx - 1].mesh->images.size()) : 0;
-				auto applyOffset = [offset](uint32_t idx) {
-					return idx == 0xFFFFFFFF ? idx : idx + offset;
-					};
-				glm::uvec3 pcfs
-				{
-					applyOffset(subMesh.material.albedoIdx),
-					applyOffset(subMesh.material.opacityIdx),
-					gPass.GetBoundTextureCount(),
-				};
-				vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(PCModelDataVS),
-					sizeof(pcfs), &pcfs);
-
-				// -- Drawing Time! --
-				vkCmdDrawIndexed(vCmdBuffer, subMesh.indexCount, 1, subMesh.indexOffset, subMesh.vertexOffset, 0);
-				RenderDebugger::InsertDebugLabel(commandBuffer, "Draw Opaque Mesh - " + subMesh.name, glm::vec4(0.4f, 0.8f, 1.f, 1.f));
-			}
-		}
-	}
-	vkCmdEndRendering(vCmdBuffer);
-	RenderDebugger::EndDebugLabel(commandBuffer);
+
+	// -- Set Dynamic Viewport --
+	VkViewport viewport;
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
+	vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
+
+	// -- Set Dynamic Scissors --
+	VkRect2D scissor;
+	scissor.offset = { .x = 0, .y = 0 };
+	scissor.extent = extent;
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
+	vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
+
+	// -- Bind Descriptor Sets --
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Uniform Buffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vUniformDS[imageIndex].GetHandle(), 0, nullptr);
+
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Textures", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 1, 1, &gPass.GetTexturesDescriptorSet(imageIndex).GetHandle(), 0, nullptr);
+
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Instances", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 2, 1, &gpuCuller.GetInstanceDescriptorSet(imageIndex).GetHandle(), 0, nullptr);
+
+	// -- Bind Pipeline --
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (Depth PrePass)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+	vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
+
+	// -- Bind Push Constants --
+	POMPEII_GPU_LABEL(commandBuffer, "Push Constants", glm::vec4(1.f, 0.6f, 0.f, 1.f));
+	PCMaterialDataFS pcfs{ .textureCount = gPass.GetBoundTextureCount() };
+	vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+		sizeof(PCMaterialDataFS), &pcfs);
+
+	// -- Drawing Time! --
+	// Reads the same view as the geometry pass, so both draw identical LODs and the depth test stays invariant
+	POMPEII_GPU_LABEL(commandBuffer, "Draw Culled Instances", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
+	gpuCuller.Draw(commandBuffer, imageIndex, viewIdx);
 }
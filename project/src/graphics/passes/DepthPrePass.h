@@ -9,13 +9,14 @@
 #include "DescriptorSet.h"
 #include "Pipeline.h"
 #include "Image.h"
+#include "SecondaryRecorder.h"
 
 // -- Forward Declarations --
 namespace pompeii
 {
-	struct RenderItem;
 	struct CameraData;
 	class GeometryPass;
+	class GPUCuller;
 	class DescriptorPool;
 	class CommandBuffer;
 	struct RenderDrawContext;
@@ -31,6 +32,7 @@ namespace pompeii
 	{
 		VkFormat depthFormat{};
 		GeometryPass* pGeometryPass{};
+		GPUCuller* pGPUCuller{};
 	};
 
 
@@ -53,7 +55,10 @@ namespace pompeii
 		void Initialize(const Context& context, const DepthPrePassCreateInfo& createInfo);
 		void Destroy();
 		void UpdateCamera(const Context& context, uint32_t imageIndex, const CameraData& camera) const;
-		void Record(CommandBuffer& commandBuffer, const GeometryPass& gPass, uint32_t imageIndex, const Image& depthImage, const std::vector<RenderItem>& renderItems) const;
+		// Queues the draws of what the GPUCuller kept for the camera's view, recorded into a secondary by the recorder
+		void AddDraws(SecondaryRecorder& recorder, const GeometryPass& gPass, const GPUCuller& gpuCuller, uint32_t imageIndex, VkExtent2D extent, uint32_t viewIdx);
+		// Executes the secondary AddDraws queued, once the recorder recorded it
+		void Record(CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, const Image& depthImage) const;
 
 		//--------------------------------------------------
 		//    Shader Infos
@@ -63,16 +68,23 @@ namespace pompeii
 			glm::mat4 view;
 			glm::mat4 proj;
 		};
-		struct PCModelDataVS
+		struct PCMaterialDataFS
 		{
-			glm::mat4 model;
+			uint32_t textureCount;
 		};
 
 	private:
+		void RecordDraws(CommandBuffer& commandBuffer, const GeometryPass& gPass, const GPUCuller& gpuCuller, uint32_t imageIndex, VkExtent2D extent, uint32_t viewIdx) const;
+
 		// -- Pipeline --
 		PipelineLayout		m_PipelineLayout{ };
 		Pipeline			m_Pipeline{ };
 
+		// -- Secondary --
+		RenderingFormats	m_RenderingFormats{ };
+		uint32_t			m_DrawJob{ };
+		uint32_t			m_DrawCallCount{ };
+
 		// -- Descriptors --
 		DescriptorSetLayout			m_UniformDSL{ };
 		std::vector<DescriptorSet>	m_vUniformDS{ };
@@ -1,14 +1,22 @@
+// -- Standard Library --
+#include <algorithm>
+
 // -- Pompeii Includes --
 #include "GeometryPass.h"
 #include "Shader.h"
 #include "Context.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "DescriptorPool.h"
 #include "RenderingItems.h"
+#include "FrustumCuller.h"
+#include "GPUCuller.h"
 #include "GPUCamera.h"
+#include "TextureStreamer.h"
 
 void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPassCreateInfo& createInfo)
 {
+	m_pTextureStreamer = createInfo.pTextureStreamer;
+
 	// -- GBuffers --
 	{
 		m_vGBuffers.resize(context.maxFramesInFlight);
@@ -31,14 +39,13 @@ void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPas
 		m_DeletionQueue.Push([&] { m_UniformDSL.Destroy(context); });
 
 		// -- Texture Array Descriptor --
-		constexpr uint32_t textureCount = 256;
-		assert(textureCount <= context.physicalDevice.GetProperties().limits.maxDescriptorSetSampledImages && "GPU can't support this many sampled images!");
+		assert(MAX_TEXTURES <= context.physicalDevice.GetProperties().limits.maxDescriptorSetSampledImages && "GPU can't support this many sampled images!");
 		builder
 			.SetDebugName("Texture Array DS Layout")
 			.NewLayoutBinding()
 				.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
 				.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
-				.SetCount(textureCount)
+				.SetCount(MAX_TEXTURES)
 				.AddLayoutFlag(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
 				.AddBindingFlags(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT)
 				.AddBindingFlags(VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)
@@ -54,14 +61,11 @@ void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPas
 		builder
 			.NewPushConstantRange()
 				.SetPCOffset(0)
-				.SetPCSize(sizeof(PCModelDataVS))
-				.SetPCStageFlags(VK_SHADER_STAGE_VERTEX_BIT)
-			.NewPushConstantRange()
-				.SetPCOffset(sizeof(PCModelDataVS))
 				.SetPCSize(sizeof(PCMaterialDataFS))
 				.SetPCStageFlags(VK_SHADER_STAGE_FRAGMENT_BIT)
 			.AddLayout(m_UniformDSL)
 			.AddLayout(m_TextureDSL)
+			.AddLayout(createInfo.pGPUCuller->GetInstanceDescriptorSetLayout())
 			.Build(context, m_PipelineLayout);
 		m_DeletionQueue.Push([&] {m_PipelineLayout.Destroy(context); });
 	}
@@ -82,6 +86,8 @@ void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPas
 		renderingCreateInfo.colorAttachmentCount = static_cast<uint32_t>(formats.size());
 		renderingCreateInfo.pColorAttachmentFormats = formats.data();
 		renderingCreateInfo.depthAttachmentFormat = createInfo.depthFormat;
+		m_RenderingFormats.vColorFormats = formats;
+		m_RenderingFormats.depthFormat = createInfo.depthFormat;
 
 		// Create pipeline
 		GraphicsPipelineBuilder builder{};
@@ -99,8 +105,6 @@ void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPas
 			.SetFrontFace(VK_FRONT_FACE_CLOCKWISE)
 			.SetPolygonMode(VK_POLYGON_MODE_FILL)
 			.SetDepthTest(VK_TRUE, VK_FALSE, VK_COMPARE_OP_LESS_OR_EQUAL)
-			.SetVertexBindingDesc(Vertex::GetBindingDescription())
-			.SetVertexAttributeDesc(Vertex::GetAttributeDescriptions())
 			.Build(context, m_Pipeline);
 		m_DeletionQueue.Push([&] { m_Pipeline.Destroy(context); });
 
@@ -151,6 +155,15 @@ void pompeii::GeometryPass::Initialize(const Context& context, const GeometryPas
 				.WriteBuffers(m_vUniformDS[i], 0)
 				.Execute(context);
 		}
+
+		// -- Texture Arrays, one per frame so streamed views can be swapped once that frame is done --
+		const uint32_t variableCount = MAX_TEXTURES;
+		VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+		variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+		variableCountInfo.descriptorSetCount = 1;
+		variableCountInfo.pDescriptorCounts = &variableCount;
+		for (size_t i{}; i < context.maxFramesInFlight; ++i)
+			m_vTextureDS.push_back(context.descriptorPool->AllocateSets(context, m_TextureDSL, 1, "Texture Array DS", &variableCountInfo).front());
 	}
 }
 
@@ -164,28 +177,21 @@ void pompeii::GeometryPass::Resize(const Context& context, VkExtent2D extent)
 	for (GBuffer& gBuffer : m_vGBuffers)
 		gBuffer.Resize(context, extent);
 }
-void pompeii::GeometryPass::UpdateTextureDescriptor(const Context& context, const std::vector<Image*>& vTextures)
+void pompeii::GeometryPass::UpdateTextureDescriptors(const Context& context, uint32_t imageIndex)
 {
-	if (m_TextureDS.GetHandle())
-		vkFreeDescriptorSets(context.device.GetHandle(), context.descriptorPool->GetHandle(), 1, &m_TextureDS.GetHandle());
-
-	auto imageCount = static_cast<uint32_t>(vTextures.size());
-	const uint32_t variableCount = imageCount;
-	VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
-	variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
-	variableCountInfo.descriptorSetCount = 1;
-	variableCountInfo.pDescriptorCounts = &variableCount;
-	m_TextureDS = context.descriptorPool->AllocateSets(context, m_TextureDSL, 1, "Texture Array DS", &variableCountInfo).front();
-
-	// -- Write Textures --
-	if (imageCount <= 0)
-		return;
-
+	// -- Write Changed Textures --
 	DescriptorSetWriter writer{};
-	for (const Image* image : vTextures)
-		writer.AddImageInfo(image->GetView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_TextureSampler);
-	writer.WriteImages(m_TextureDS, 0, imageCount).Execute(context);
-	m_TextureCount = imageCount;
+	for (uint32_t slot : m_pTextureStreamer->GetDirtySlots(imageIndex))
+	{
+		if (slot >= MAX_TEXTURES || slot >= m_pTextureStreamer->GetTextureCount())
+			continue;
+		writer
+			.AddImageInfo(m_pTextureStreamer->GetView(slot), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_TextureSampler)
+			.WriteImages(m_vTextureDS[imageIndex], 0, 1, slot)
+			.Execute(context);
+	}
+	m_pTextureStreamer->ClearDirtySlots(imageIndex);
+	m_TextureCount = std::min(m_pTextureStreamer->GetTextureCount(), MAX_TEXTURES);
 }
 
 void pompeii::GeometryPass::UpdateCamera(const Context& context, uint32_t imageIndex, const CameraData& camera) const
@@ -195,7 +201,32 @@ void pompeii::GeometryPass::UpdateCamera(const Context& context, uint32_t imageI
 	ubo.proj = camera.proj;
 	vmaCopyMemoryToAllocation(context.allocator, &ubo, m_vUniformBuffers[imageIndex].GetMemoryHandle(), 0, sizeof(ubo));
 }
-void pompeii::GeometryPass::Record(CommandBuffer& commandBuffer, uint32_t imageIndex, const Image& depthImage, const std::vector<RenderItem>& renderItems)
+void pompeii::GeometryPass::RequestTextures(const VisibleList& visibleList, const CameraData& camera, float viewportHeight) const
+{
+	// -- Same sizing as the LOD selection of the camera passes --
+	const LodSelector lodSelector = LodSelector::FromCamera(camera.view, camera.proj, viewportHeight);
+	for (const DrawItem& drawItem : visibleList.vDrawItems)
+	{
+		const SubMesh& subMesh = *drawItem.subMesh;
+		const float texCoordsPerPixel = lodSelector.GetTexCoordsPerPixel(subMesh, drawItem.model);
+		for (uint32_t textureIdx : { subMesh.material.albedoIdx, subMesh.material.opacityIdx, subMesh.material.normalIdx, subMesh.material.roughnessIdx, subMesh.material.metalnessIdx })
+			m_pTextureStreamer->Request(textureIdx, texCoordsPerPixel);
+	}
+}
+void pompeii::GeometryPass::AddDraws(SecondaryRecorder& recorder, const GPUCuller& gpuCuller, uint32_t imageIndex, uint32_t viewIdx)
+{
+	// -- Camera and instances live in buffers and the texture array is update after bind, the secondary only changes with what it records --
+	StateHash state{};
+	state.Add(gpuCuller.GetDrawStateHash(imageIndex)).Add(m_TextureCount).Add(m_vGBuffers[imageIndex].GetExtent()).Add(viewIdx);
+
+	m_DrawJob = recorder.AddCached(m_RenderingFormats, this, 0, state.Get(), [this, &gpuCuller, imageIndex, viewIdx](CommandBuffer& commandBuffer)
+		{
+			RecordDraws(commandBuffer, gpuCuller, imageIndex, viewIdx);
+		});
+	// Counted on execution, a reused secondary still draws
+	m_DrawCallCount = gpuCuller.GetDrawCallCount(imageIndex, viewIdx);
+}
+void pompeii::GeometryPass::Record(CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, uint32_t imageIndex, const Image& depthImage)
 {
 	// Transition GBuffer Images
 	m_vGBuffers[imageIndex].TransitionBufferWriting(commandBuffer);
@@ -210,10 +241,11 @@ void pompeii::GeometryPass::Record(CommandBuffer& commandBuffer, uint32_t imageI
 	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
-	// Render Info
+	// Render Info, the draws were recorded into a secondary by AddDraws
 	VkExtent2D extent = m_vGBuffers[imageIndex].GetExtent();
 	VkRenderingInfo renderingInfo{};
 	renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+	renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
 	renderingInfo.renderArea = VkRect2D{ VkOffset2D{0, 0}, extent };
 	renderingInfo.layerCount = 1;
 	renderingInfo.colorAttachmentCount = gBufferAttachmentCount;
@@ -222,83 +254,12 @@ void pompeii::GeometryPass::Record(CommandBuffer& commandBuffer, uint32_t imageI
 	renderingInfo.pStencilAttachment = nullptr;
 
 	// Render
-	const VkCommandBuffer& vCmdBuffer = commandBuffer.GetHandle();
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Geometry Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
-	vkCmdBeginRendering(vCmdBuffer, &renderingInfo);
-	{
-		// -- Set Dynamic Viewport --
-		VkViewport viewport;
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(extent.width);
-		viewport.height = static_cast<float>(extent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
-		vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
-
-		// -- Set Dynamic Scissors --
-		VkRect2D scissor;
-		scissor.offset = { .x = 0, .y = 0 };
-		scissor.extent = extent;
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
-		vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
-
-		// -- Bind Descriptor Sets --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Uniform Buffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
-		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vUniformDS[imageIndex].GetHandle(), 0, nullptr);
-
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Textures", glm::vec4(0.f, 1.f, 1.f, 1.f));
-		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 1, 1, &m_TextureDS.GetHandle(), 0, nullptr);
-
-		// -- Bind Pipeline --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (GBuffer)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
-		vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
-
-		// -- Draw Models --
-		for (uint32_t itemIdx{}; itemIdx < renderItems.size(); ++itemIdx)
-		{
-			const RenderItem& item = renderItems[itemIdx];
-			Mesh* pMesh = item.mesh;
-
-			// -- Bind Model Data --
-			pMesh->Bind(commandBuffer);
-
-			// -- Draw Opaque --
-			for (const SubMesh& subMesh : pMesh->vSubMeshes)
-			{
-				// -- Bind Push Constants --
-				RenderDebugger::InsertDebugLabel(commandBuffer, "Push Constants", glm::vec4(1.f, 0.6f, 0.f, 1.f));
-				PCModelDataVS pcvs
-				{
-					.model = item.transform * subMesh.matrix
-				};
-				vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_VERTEX_BIT, 0,
-					sizeof(PCModelDataVS), &pcvs);
-
-				uint32_t offset = itemIdx > 0 ? static_cast<uint32_t>(renderItems[itemIdx - 1].mesh->images.size()) : 0;
-				auto applyOffset = [offset](uint32_t idx) {
-					return idx == 0xFFFFFFFF ? idx : idx + offset;
-					};
-				PCMaterialDataFS pcfs{
-					.diffuseIdx = applyOffset(subMesh.material.albedoIdx),
-					.opacityIdx = applyOffset(subMesh.material.opacityIdx),
-					.normalIdx = applyOffset(subMesh.material.normalIdx),
-					.roughnessIdx = applyOffset(subMesh.material.roughnessIdx),
-					.metallicIdx = applyOffset(subMesh.material.metalnessIdx),
-					.textureCount = m_TextureCount,
-				};
-				vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(PCModelDataVS),
-					sizeof(PCMaterialDataFS), &pcfs);
-
-				// -- Drawing Time! --
-				vkCmdDrawIndexed(vCmdBuffer, subMesh.indexCount, 1, subMesh.indexOffset, subMesh.vertexOffset, 0);
-				RenderDebugger::InsertDebugLabel(commandBuffer, "Draw Mesh - " + subMesh.name, glm::vec4(0.4f, 0.8f, 1.f, 1.f));
-			}
-		}
-	}
-	vkCmdEndRendering(vCmdBuffer);
-	RenderDebugger::EndDebugLabel(commandBuffer);
+	POMPEII_GPU_BEGIN(commandBuffer, "Geometry Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	vkCmdBeginRendering(commandBuffer.GetHandle(), &renderingInfo);
+	recorder.Execute(commandBuffer, m_DrawJob);
+	POMPEII_COUNT(Counter::DrawCalls, m_DrawCallCount);
+	vkCmdEndRendering(commandBuffer.GetHandle());
+	POMPEII_GPU_END(commandBuffer);
 
 	m_vGBuffers[imageIndex].TransitionBufferSampling(commandBuffer);
 }
@@ -310,5 +271,57 @@ void pompeii::GeometryPass::Record(CommandBuffer& commandBuffer, uint32_t imageI
 const std::vector<pompeii::GBuffer>& pompeii::GeometryPass::GetGBuffers() const						{ return m_vGBuffers; }
 const pompeii::GBuffer& pompeii::GeometryPass::GetGBuffer(uint32_t index) const						{ return m_vGBuffers.at(index); }
 uint32_t pompeii::GeometryPass::GetBoundTextureCount() const										{ return m_TextureCount; }
-const pompeii::DescriptorSet& pompeii::GeometryPass::GetTexturesDescriptorSet() const				{ return m_TextureDS; }
+const pompeii::DescriptorSet& pompeii::GeometryPass::GetTexturesDescriptorSet(uint32_t imageIndex) const	{ return m_vTextureDS.at(imageIndex); }
 const pompeii::DescriptorSetLayout& pompeii::GeometryPass::GetTexturesDescriptorSetLayout() const	{ return m_TextureDSL; }
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::GeometryPass::RecordDraws(CommandBuffer& commandBuffer, const GPUCuller& gpuCuller, uint32_t imageIndex, uint32_t viewIdx) const
+{
+	const VkCommandBuffer& vCmdBuffer = commandBuffer.GetHandle();
+	const VkExtent2D extent = m_vGBuffers[imageIndex].GetExtent();
+
+	// -- Set Dynamic Viewport --
+	VkViewport viewport;
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
+	vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
+
+	// -- Set Dynamic Scissors --
+	VkRect2D scissor;
+	scissor.offset = { .x = 0, .y = 0 };
+	scissor.extent = extent;
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
+	vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
+
+	// -- Bind Descriptor Sets --
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Uniform Buffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vUniformDS[imageIndex].GetHandle(), 0, nullptr);
+
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Textures", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 1, 1, &m_vTextureDS[imageIndex].GetHandle(), 0, nullptr);
+
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Instances", glm::vec4(0.f, 1.f, 1.f, 1.f));
+	vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 2, 1, &gpuCuller.GetInstanceDescriptorSet(imageIndex).GetHandle(), 0, nullptr);
+
+	// -- Bind Pipeline --
+	POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (GBuffer)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+	vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
+
+	// -- Bind Push Constants --
+	POMPEII_GPU_LABEL(commandBuffer, "Push Constants", glm::vec4(1.f, 0.6f, 0.f, 1.f));
+	PCMaterialDataFS pcfs{ .textureCount = m_TextureCount };
+	vkCmdPushConstants(vCmdBuffer, m_PipelineLayout.GetHandle(), VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+		sizeof(PCMaterialDataFS), &pcfs);
+
+	// -- Drawing Time! --
+	POMPEII_GPU_LABEL(commandBuffer, "Draw Culled Instances", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
+	gpuCuller.Draw(commandBuffer, imageIndex, viewIdx);
+}
@@ -11,16 +11,19 @@
 #include "Pipeline.h"
 #include "Sampler.h"
 #include "Image.h"
+#include "SecondaryRecorder.h"
 
 // -- Forward Declarations --
 namespace pompeii
 {
-	struct RenderItem;
+	struct VisibleList;
 	class DescriptorPool;
 	struct CameraData;
 	class CommandBuffer;
 	struct RenderDrawContext;
 	struct RenderInstance;
+	class TextureStreamer;
+	class GPUCuller;
 }
 
 namespace pompeii
@@ -32,6 +35,8 @@ namespace pompeii
 	{
 		VkExtent2D extent{};
 		VkFormat depthFormat{};
+		TextureStreamer* pTextureStreamer{};
+		GPUCuller* pGPUCuller{};
 	};
 
 
@@ -54,9 +59,15 @@ namespace pompeii
 		void Initialize(const Context& context, const GeometryPassCreateInfo& createInfo);
 		void Destroy();
 		void Resize(const Context& context, VkExtent2D extent);
-		void UpdateTextureDescriptor(const Context& context, const std::vector<Image*>& vTextures);
+		// Writes the streamed views that changed into this frame's texture array
+		void UpdateTextureDescriptors(const Context& context, uint32_t imageIndex);
 		void UpdateCamera(const Context& context, uint32_t imageIndex, const CameraData& camera) const;
-		void Record(CommandBuffer& commandBuffer, uint32_t imageIndex, const Image& depthImage, const std::vector<RenderItem>& renderItems);
+		// Asks the streamer for the mips the camera's visible Sub Meshes sample
+		void RequestTextures(const VisibleList& visibleList, const CameraData& camera, float viewportHeight) const;
+		// Queues the draws of what the GPUCuller kept for the camera's view, recorded into a secondary by the recorder
+		void AddDraws(SecondaryRecorder& recorder, const GPUCuller& gpuCuller, uint32_t imageIndex, uint32_t viewIdx);
+		// Executes the secondary AddDraws queued, once the recorder recorded it
+		void Record(CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, uint32_t imageIndex, const Image& depthImage);
 
 		//--------------------------------------------------
 		//    Accessors & Mutators
@@ -64,7 +75,7 @@ namespace pompeii
 		const std::vector<GBuffer>& GetGBuffers() const;
 		const GBuffer& GetGBuffer(uint32_t index) const;
 		uint32_t GetBoundTextureCount() const;
-		const DescriptorSet& GetTexturesDescriptorSet() const;
+		const DescriptorSet& GetTexturesDescriptorSet(uint32_t imageIndex) const;
 		const DescriptorSetLayout& GetTexturesDescriptorSetLayout() const;
 
 		//--------------------------------------------------
@@ -75,33 +86,30 @@ namespace pompeii
 			glm::mat4 view;
 			glm::mat4 proj;
 		};
-		struct PCModelDataVS
-		{
-			glm::mat4 model;
-		};
-
+		// -- Material indices come from the instance data, only the bound texture count is pushed --
 		struct PCMaterialDataFS
 		{
-			// -- Textures --
-			uint32_t diffuseIdx;
-			uint32_t opacityIdx;
-			uint32_t normalIdx;
-			uint32_t roughnessIdx;
-			uint32_t metallicIdx;
 			uint32_t textureCount;
 		};
 
 	private:
+		void RecordDraws(CommandBuffer& commandBuffer, const GPUCuller& gpuCuller, uint32_t imageIndex, uint32_t viewIdx) const;
+
 		// -- Pipeline --
 		PipelineLayout		m_PipelineLayout{ };
 		Pipeline			m_Pipeline{ };
 
+		// -- Secondary --
+		RenderingFormats	m_RenderingFormats{ };
+		uint32_t			m_DrawJob{ };
+		uint32_t			m_DrawCallCount{ };
+
 		// -- Descriptors --
 		DescriptorSetLayout			m_UniformDSL{ };
 		std::vector<DescriptorSet>	m_vUniformDS{ };
 
 		DescriptorSetLayout			m_TextureDSL{ };
-		DescriptorSet				m_TextureDS{ };
+		std::vector<DescriptorSet>	m_vTextureDS{ };
 
 		// -- Buffers --
 		std::vector<GBuffer>		m_vGBuffers;
@@ -109,6 +117,9 @@ namespace pompeii
 
 		Sampler						m_TextureSampler{ };
 		uint32_t					m_TextureCount{ };
+		TextureStreamer*			m_pTextureStreamer{ };
+
+		static constexpr uint32_t	MAX_TEXTURES{ 256 };
 		DeletionQueue				m_DeletionQueue{ };
 	};
 }
@@ -2,7 +2,7 @@
 #include "LightingPass.h"
 #include "EnvironmentMap.h"
 #include "Context.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "GBuffer.h"
 #include "GeometryPass.h"
 #include "Shader.h"
@@ -73,12 +73,17 @@ void pompeii::LightingPass::Initialize(const Context& context, const LightingPas
 			.NewLayoutBinding() // Diffuse Irradiance
 				.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
 				.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
+				.AddBindingFlags(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT)
 			.NewLayoutBinding() // Specular Irradiance
 				.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
 				.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
 			.NewLayoutBinding() // BRDF LUT
 				.SetType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
 				.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
+			.NewLayoutBinding() // Diffuse Irradiance SH
+				.SetType(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+				.SetShaderStages(VK_SHADER_STAGE_FRAGMENT_BIT)
+				.AddBindingFlags(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT)
 			.Build(context, m_GBufferTexturesDSL);
 		m_DeletionQueue.Push([&] { m_GBufferTexturesDSL.Destroy(context); });
 	}
@@ -114,6 +119,8 @@ void pompeii::LightingPass::Initialize(const Context& context, const LightingPas
 		renderingCreateInfo.pColorAttachmentFormats = &format;
 
 		// Create pipeline
+		// Only one of the diffuse irradiance bindings is read, picked at pipeline creation
+		const VkBool32 useDiffuseSH = createInfo.useDiffuseSH ? VK_TRUE : VK_FALSE;
 		GraphicsPipelineBuilder builder{};
 		builder
 			.SetDebugName("Graphics Pipeline (Lighting)")
@@ -123,6 +130,7 @@ void pompeii::LightingPass::Initialize(const Context& context, const LightingPas
 			.AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
 			.AddShader(vertShader, VK_SHADER_STAGE_VERTEX_BIT)
 			.AddShader(fragShader, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.SetShaderSpecialization(0, 0, sizeof(VkBool32), &useDiffuseSH)
 			.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
 			.SetCullMode(VK_CULL_MODE_BACK_BIT)
 			.SetFrontFace(VK_FRONT_FACE_CLOCKWISE)
@@ -249,11 +257,22 @@ void pompeii::LightingPass::UpdateEnvironmentMap(const Context& context, const E
 			.WriteImages(m_vGBufferTexturesDS[i], 5)
 			.Execute(context);
 
-		writer
-			.AddImageInfo(envMap.GetDiffuseIrradianceMap().GetView(),
-				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, envMap.GetSampler())
-			.WriteImages(m_vGBufferTexturesDS[i], 6)
-			.Execute(context);
+		// -- Either diffuse irradiance source may be left out, the pipeline only reads the one it was built for --
+		if (envMap.GetDiffuseIrradianceMap().GetHandle())
+		{
+			writer
+				.AddImageInfo(envMap.GetDiffuseIrradianceMap().GetView(),
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, envMap.GetSampler())
+				.WriteImages(m_vGBufferTexturesDS[i], 6)
+				.Execute(context);
+		}
+		if (envMap.GetDiffuseIrradianceSH().GetHandle())
+		{
+			writer
+				.AddBufferInfo(envMap.GetDiffuseIrradianceSH(), 0, static_cast<uint32_t>(envMap.GetDiffuseIrradianceSH().Size()))
+				.WriteBuffers(m_vGBufferTexturesDS[i], 9)
+				.Execute(context);
+		}
 
 		writer
 			.AddImageInfo(envMap.GetSpecularIrradianceMap().GetView(),
@@ -458,7 +477,7 @@ void pompeii::LightingPass::Record(const Context& context, CommandBuffer& comman
 
 	// -- Render --
 	const VkCommandBuffer& vCmdBuffer = commandBuffer.GetHandle();
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Lighting Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	POMPEII_GPU_BEGIN(commandBuffer, "Lighting Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
 	vkCmdBeginRendering(vCmdBuffer, &renderingInfo);
 	{
 		// -- Set Dynamic Viewport --
@@ -469,32 +488,32 @@ void pompeii::LightingPass::Record(const Context& context, CommandBuffer& comman
 		viewport.height = static_cast<float>(renderImage.GetExtent2D().height);
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Viewport", glm::vec4(0.2f, 1.f, 0.2f, 1.f));
 		vkCmdSetViewport(vCmdBuffer, 0, 1, &viewport);
 
 		// -- Set Dynamic Scissors --
 		VkRect2D scissor{};
 		scissor.offset = { .x = 0, .y = 0 };
 		scissor.extent = renderImage.GetExtent2D();
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Scissor", glm::vec4(1.f, 1.f, 0.2f, 1.f));
 		vkCmdSetScissor(vCmdBuffer, 0, 1, &scissor);
 
 		// -- Bind Descriptor Sets --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Cam Data", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Cam Data", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 0, 1, &m_vCameraMatricesDS[imageIndex].GetHandle(), 0, nullptr);
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Light Data", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Light Data", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 1, 1, &m_SSBOLightDS.GetHandle(), 0, nullptr);
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 2, 1, &m_vUBODirLightMapDS[imageIndex].GetHandle(), 0, nullptr);
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 3, 1, &m_vUBOPointLightMapDS[imageIndex].GetHandle(), 0, nullptr);
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind GBuffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind GBuffer", glm::vec4(0.f, 1.f, 1.f, 1.f));
 		vkCmdBindDescriptorSets(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout.GetHandle(), 4, 1, &m_vGBufferTexturesDS[imageIndex].GetHandle(), 0, nullptr);
 
 		// -- Draw Triangle --
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Bind Pipeline (Lighting)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Bind Pipeline (Lighting)", glm::vec4(0.2f, 0.4f, 1.f, 1.f));
 		vkCmdBindPipeline(vCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetHandle());
-		RenderDebugger::InsertDebugLabel(commandBuffer, "Draw Full Screen Triangle", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
+		POMPEII_GPU_LABEL(commandBuffer, "Draw Full Screen Triangle", glm::vec4(0.4f, 0.8f, 1.f, 1.f));
 		vkCmdDraw(commandBuffer.GetHandle(), 3, 1, 0, 0);
 	}
 	vkCmdEndRendering(vCmdBuffer);
-	RenderDebugger::EndDebugLabel(commandBuffer);
+	POMPEII_GPU_END(commandBuffer);
 }
@@ -30,6 +30,8 @@ namespace pompeii
 		VkFormat format{};
 		GeometryPass* pGeometryPass;
 		std::vector<Image>* pDepthImages;
+		// Diffuse ambient from the spherical harmonics, false samples the convolved cube map instead
+		bool useDiffuseSH{ true };
 	};
 
 	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
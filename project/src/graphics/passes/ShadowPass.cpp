@@ -1,12 +1,16 @@
+// -- Standard Library --
+#include <algorithm>
+
 // -- Pompeii Includes --
 #include "ShadowPass.h"
-#include "RenderDebugger.h"
+#include "Instrumentation.h"
 #include "Shader.h"
 #include "Context.h"
 #include "Light.h"
 #include "RenderingItems.h"
+#include "GPUCuller.h"
 
-void pompeii::ShadowPass::Initialize(const Context& context)
+void pompeii::ShadowPass::Initialize(const Context& context, const GPUCuller& gpuCuller)
 {
 	// -- Pipeline Layout --
 	{
@@ -15,6 +19,7 @@ void pompeii::ShadowPass::Initialize(const Context& context)
 			.NewPushConstantRange()
 			.SetPCSize(sizeof(PushConstants))
 			.SetPCStageFlags(VK_SHADER_STAGE_VERTEX_BIT)
+			.AddLayout(gpuCuller.GetInstanceDescriptorSetLayout())
 			.Build(context, m_ShadowPipelineLayout);
 		m_DeletionQueue.Push([&] {m_ShadowPipelineLayout.Destroy(context); });
 	}
@@ -31,6 +36,7 @@ void pompeii::ShadowPass::Initialize(const Context& context)
 		VkFormat format = VK_FORMAT_D32_SFLOAT;
 		renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
 		renderingCreateInfo.depthAttachmentFormat = format;
+		m_RenderingFormats.depthFormat = format;
 
 		GraphicsPipelineBuilder pipelineBuilder{};
 		pipelineBuilder
@@ -46,8 +52,6 @@ void pompeii::ShadowPass::Initialize(const Context& context)
 			.SetFrontFace(VK_FRONT_FACE_CLOCKWISE)
 			.SetPolygonMode(VK_POLYGON_MODE_FILL)
 			.EnableDepthBias(1.25f, 1.75f)
-			.SetVertexAttributeDesc(Vertex::GetAttributeDescriptions())
-			.SetVertexBindingDesc(Vertex::GetBindingDescription())
 			.SetDepthTest(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS_OR_EQUAL)
 			.Build(context, m_ShadowPipeline);
 		m_DeletionQueue.Push([&] { m_ShadowPipeline.Destroy(context); });
@@ -62,9 +66,58 @@ void pompeii::ShadowPass::Destroy()
 	m_DeletionQueue.Flush();
 }
 
-void pompeii::ShadowPass::Record(const Context& context, CommandBuffer& commandBuffer, const std::vector<RenderItem>& renderItems, const std::vector<LightItem>& lightItems) const
+uint32_t pompeii::ShadowPass::AddCullViews(const Context& context, const std::vector<LightItem>& lightItems, GPUCuller& gpuCuller) const
+{
+	uint32_t firstView{ 0xFFFFFFFF };
+	for (const LightItem& lightItem : lightItems)
+	{
+		const auto& map = lightItem.light->vShadowMaps[context.currentFrame];
+		const float height = static_cast<float>(map.GetExtent2D().height);
+		for (uint32_t layerIdx{ 1 }; layerIdx < map.GetViewCount(); ++layerIdx)
+		{
+			const glm::mat4& view = lightItem.light->viewMatrices[layerIdx - 1];
+			const uint32_t viewIdx = gpuCuller.AddView(lightItem.light->projMatrix * view,
+				LodSelector::FromCamera(view, lightItem.light->projMatrix, height, m_LodBias), DrawPass::Shadow);
+			firstView = std::min(firstView, viewIdx);
+		}
+	}
+	return firstView;
+}
+
+void pompeii::ShadowPass::AddDraws(const Context& context, SecondaryRecorder& recorder, const std::vector<LightItem>& lightItems, const GPUCuller& gpuCuller, uint32_t firstView)
+{
+	// -- One secondary per light face, faces are independent so they record in parallel --
+	m_vDrawJobs.clear();
+	m_DrawCallCount = 0;
+	const uint64_t drawStateHash = gpuCuller.GetDrawStateHash(context.currentFrame);
+	uint32_t viewIdx{ firstView };
+	for (const LightItem& lightItem : lightItems)
+	{
+		const auto& map = lightItem.light->vShadowMaps[context.currentFrame];
+		const VkExtent2D extent = map.GetExtent2D();
+		for (uint32_t layerIdx{ 1 }; layerIdx < map.GetViewCount(); ++layerIdx, ++viewIdx)
+		{
+			const glm::mat4 lightSpace = lightItem.light->projMatrix * lightItem.light->viewMatrices[layerIdx - 1];
+
+			// -- The light matrix is pushed, so a moving light records its faces again --
+			StateHash state{};
+			state.Add(drawStateHash).Add(extent).Add(lightSpace).Add(viewIdx);
+
+			const uint32_t faceIdx = static_cast<uint32_t>(m_vDrawJobs.size());
+			m_vDrawJobs.push_back(recorder.AddCached(m_RenderingFormats, this, faceIdx, state.Get(), [this, &gpuCuller, frameIndex = context.currentFrame, extent, lightSpace, viewIdx](CommandBuffer& commandBuffer)
+				{
+					RecordDraws(commandBuffer, gpuCuller, frameIndex, extent, lightSpace, viewIdx);
+				}));
+			// Counted on execution, a reused secondary still draws
+			m_DrawCallCount += gpuCuller.GetDrawCallCount(context.currentFrame, viewIdx);
+		}
+	}
+}
+void pompeii::ShadowPass::Record(const Context& context, CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, const std::vector<LightItem>& lightItems) const
 {
-	RenderDebugger::BeginDebugLabel(commandBuffer, "Shadow Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	POMPEII_GPU_BEGIN(commandBuffer, "Shadow Pass", glm::vec4(0.6f, 0.2f, 0.8f, 1));
+	POMPEII_COUNT(Counter::DrawCalls, m_DrawCallCount);
+	uint32_t faceIdx{};
 	for (const LightItem& lightItem : lightItems)
 	{
 		auto& map = lightItem.light->vShadowMaps[context.currentFrame];
@@ -79,7 +132,7 @@ void pompeii::ShadowPass::Record(const Context& context, CommandBuffer& commandB
 
 		// -- Render --
 		const VkCommandBuffer& vCmd = commandBuffer.GetHandle();
-		for (uint32_t layerIdx{1}; layerIdx < map.GetViewCount(); ++layerIdx)
+		for (uint32_t layerIdx{1}; layerIdx < map.GetViewCount(); ++layerIdx, ++faceIdx)
 		{
 			// -- Setup Attachment --
 			VkRenderingAttachmentInfo depthAttachment{};
@@ -90,60 +143,19 @@ void pompeii::ShadowPass::Record(const Context& context, CommandBuffer& commandB
 			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 			depthAttachment.clearValue.depthStencil = { 1.f, 0 };
 
-			// -- Rendering Info --
+			// -- Rendering Info, the draws were recorded into a secondary by AddDraws --
 			VkRenderingInfo renderingInfo{};
 			renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
 			renderingInfo.renderArea.offset = { .x = 0, .y = 0 };
 			renderingInfo.renderArea.extent = extent;
 			renderingInfo.layerCount = 1;
 			renderingInfo.pDepthAttachment = &depthAttachment;
 
-			// -- Begin Rendering --
+			// -- Render --
+			POMPEII_GPU_SCOPE(commandBuffer, InstrumentLabel("Shadow Face %u", faceIdx), glm::vec4(0.6f, 0.2f, 0.8f, 1));
 			vkCmdBeginRendering(vCmd, &renderingInfo);
-			{
-				// -- Set Dynamic Viewport --
-				VkViewport viewport{};
-				viewport.x = 0.0f;
-				viewport.y = 0.0f;
-				viewport.width = static_cast<float>(extent.width);
-				viewport.height = static_cast<float>(extent.height);
-				viewport.minDepth = 0.0f;
-				viewport.maxDepth = 1.0f;
-				vkCmdSetViewport(vCmd, 0, 1, &viewport);
-
-				// -- Set Dynamic Scissors --
-				VkRect2D scissor{};
-				scissor.offset = { .x = 0, .y = 0 };
-				scissor.extent = extent;
-				vkCmdSetScissor(vCmd, 0, 1, &scissor);
-
-				// -- Bind Pipeline --
-				vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_ShadowPipeline.GetHandle());
-
-				// -- Draw Models --
-				for (const RenderItem& renderItem : renderItems)
-				{
-					Mesh* pMesh = renderItem.mesh;
-
-					// -- Bind Model Data --
-					pMesh->Bind(commandBuffer);
-
-					// -- Draw Opaque --
-					for (const SubMesh& subMesh : pMesh->vSubMeshes)
-					{
-						// -- Bind Push Constants --
-						PushConstants pc
-						{
-							.lightSpace = lightItem.light->projMatrix * lightItem.light->viewMatrices[layerIdx-1],
-							.model = renderItem.transform * subMesh.matrix
-						};
-						vkCmdPushConstants(vCmd, m_ShadowPipelineLayout.GetHandle(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pc);
-
-						// -- Drawing Time! --
-						vkCmdDrawIndexed(vCmd, subMesh.indexCount, 1, subMesh.indexOffset, subMesh.vertexOffset, 0);
-					}
-				}
-			}
+			recorder.Execute(commandBuffer, m_vDrawJobs.at(faceIdx));
 			vkCmdEndRendering(vCmd);
 		}
 
@@ -155,5 +167,51 @@ void pompeii::ShadowPass::Record(const Context& context, CommandBuffer& commandB
 			VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
 			0, map.GetMipLevels(), 0, map.GetLayerCount());
 	}
-	RenderDebugger::EndDebugLabel(commandBuffer);
+	POMPEII_GPU_END(commandBuffer);
+}
+
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+void pompeii::ShadowPass::SetLodBias(float bias)	{ m_LodBias = bias; }
+float pompeii::ShadowPass::GetLodBias() const		{ return m_LodBias; }
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::ShadowPass::RecordDraws(CommandBuffer& commandBuffer, const GPUCuller& gpuCuller, uint32_t frameIndex, VkExtent2D extent, const glm::mat4& lightSpace, uint32_t viewIdx) const
+{
+	const VkCommandBuffer& vCmd = commandBuffer.GetHandle();
+
+	// -- Set Dynamic Viewport --
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(vCmd, 0, 1, &viewport);
+
+	// -- Set Dynamic Scissors --
+	VkRect2D scissor{};
+	scissor.offset = { .x = 0, .y = 0 };
+	scissor.extent = extent;
+	vkCmdSetScissor(vCmd, 0, 1, &scissor);
+
+	// -- Bind Pipeline --
+	vkCmdBindPipeline(vCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_ShadowPipeline.GetHandle());
+	vkCmdBindDescriptorSets(vCmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_ShadowPipelineLayout.GetHandle(), 0, 1, &gpuCuller.GetInstanceDescriptorSet(frameIndex).GetHandle(), 0, nullptr);
+
+	// -- Bind Push Constants --
+	PushConstants pc
+	{
+		.lightSpace = lightSpace,
+	};
+	vkCmdPushConstants(vCmd, m_ShadowPipelineLayout.GetHandle(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pc);
+
+	// -- Drawing Time! --
+	gpuCuller.Draw(commandBuffer, frameIndex, viewIdx);
 }
@@ -10,12 +10,13 @@
 // -- Pompeii Includes --
 #include "DeletionQueue.h"
 #include "Pipeline.h"
+#include "SecondaryRecorder.h"
 
 // -- Forward Declarations --
 namespace pompeii
 {
-	struct RenderItem;
 	struct LightItem;
+	class GPUCuller;
 	struct LightGPU;
 	class CommandBuffer;
 	struct RenderLightContext;
@@ -40,10 +41,21 @@ namespace pompeii
 		ShadowPass& operator=(const ShadowPass& other) = delete;
 		ShadowPass& operator=(ShadowPass&& other) noexcept = delete;
 
-		void Initialize(const Context& context);
+		void Initialize(const Context& context, const GPUCuller& gpuCuller);
 		void Destroy();
-		void Record(const Context& context, CommandBuffer& commandBuffer, const std::vector<RenderItem>& renderItems, const std::vector<LightItem>& lightItems) const;
+		// Adds one cull view per light face in light order, returns the first one
+		uint32_t AddCullViews(const Context& context, const std::vector<LightItem>& lightItems, GPUCuller& gpuCuller) const;
+		// Queues one secondary per light face, drawing what the GPUCuller kept for the views AddCullViews added
+		void AddDraws(const Context& context, SecondaryRecorder& recorder, const std::vector<LightItem>& lightItems, const GPUCuller& gpuCuller, uint32_t firstView);
+		// Renders every light face by executing the secondaries AddDraws queued
+		void Record(const Context& context, CommandBuffer& commandBuffer, const SecondaryRecorder& recorder, const std::vector<LightItem>& lightItems) const;
 
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		// Multiplies the pixel error a LOD may have, shadows tolerate coarser meshes than the camera
+		void SetLodBias(float bias);
+		float GetLodBias() const;
 
 		//--------------------------------------------------
 		//    Shader Infos
@@ -51,14 +63,23 @@ namespace pompeii
 		struct alignas(16) PushConstants
 		{
 			glm::mat4 lightSpace;
-			glm::mat4 model;
 		};
 
 	private:
+		void RecordDraws(CommandBuffer& commandBuffer, const GPUCuller& gpuCuller, uint32_t frameIndex, VkExtent2D extent, const glm::mat4& lightSpace, uint32_t viewIdx) const;
+
 		// -- Pipeline --
 		PipelineLayout	m_ShadowPipelineLayout	{ };
 		Pipeline		m_ShadowPipeline		{ };
 
+		// -- Secondaries --
+		RenderingFormats		m_RenderingFormats	{ };
+		std::vector<uint32_t>	m_vDrawJobs			{ };
+		uint32_t				m_DrawCallCount		{ };
+
+		// -- LOD --
+		float			m_LodBias				{ 4.f };
+
 		// -- DQ --
 		DeletionQueue	m_DeletionQueue			{ };
 	};
@@ -0,0 +1,131 @@
+// -- Standard Library --
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string_view>
+
+// -- Pompeii Includes --
+#include "CPUProfiler.h"
+
+
+namespace
+{
+	// -- JSON string contents, quotes, backslashes and control characters would end or break the string --
+	void WriteEscaped(std::ostream& stream, std::string_view text)
+	{
+		static constexpr char HEX[]{ "0123456789abcdef" };
+		for (const char character : text)
+		{
+			switch (character)
+			{
+			case '"':	stream << "\\\""; break;
+			case '\\':	stream << "\\\\"; break;
+			case '\n':	stream << "\\n"; break;
+			case '\r':	stream << "\\r"; break;
+			case '\t':	stream << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(character) < 0x20)
+					stream << "\\u00" << HEX[(character >> 4) & 0xF] << HEX[character & 0xF];
+				else
+					stream << character;
+			}
+		}
+	}
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  CPU Scope
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::CPUScope::CPUScope(const char* name)
+	: m_pName(name)
+	, m_StartNs(CPUProfiler::GetTimeNs())
+{}
+pompeii::CPUScope::~CPUScope()
+{
+	CPUProfiler::Record(m_pName, m_StartNs, CPUProfiler::GetTimeNs());
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  CPU Profiler
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void pompeii::CPUProfiler::Record(const char* name, uint64_t startNs, uint64_t endNs)
+{
+	// -- Only this thread writes its ring, publishing the count is enough for the exporter to see the event --
+	ThreadRing& ring = GetThreadRing();
+	const uint64_t writeIdx = ring.writeCount.load(std::memory_order_relaxed);
+	ring.vEvents[writeIdx % RING_SIZE] = { name, startNs, endNs };
+	ring.writeCount.store(writeIdx + 1, std::memory_order_release);
+}
+void pompeii::CPUProfiler::SetThreadName(const char* name)
+{
+	ThreadRing& ring = GetThreadRing();
+	std::scoped_lock lock{ m_RingsMutex };
+	ring.name = name;
+}
+uint64_t pompeii::CPUProfiler::GetTimeNs()
+{
+	// -- Relative to the first call, keeps the trace starting near zero --
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void pompeii::CPUProfiler::ExportChromeTrace(const std::filesystem::path& path)
+{
+	std::ofstream file{ path };
+	if (!file.is_open())
+		throw std::runtime_error("Failed to open Chrome Trace file: " + path.string());
+
+	std::scoped_lock lock{ m_RingsMutex };
+	// Long sessions reach millions of microseconds, fixed notation keeps nanosecond precision
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+	bool first{ true };
+	const auto separate = [&] { file << (first ? "" : ",\n"); first = false; };
+
+	for (const std::unique_ptr<ThreadRing>& pRing : m_vRings)
+	{
+		// -- Name the track --
+		separate();
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << pRing->threadId
+			 << ",\"args\":{\"name\":\"";
+		WriteEscaped(file, pRing->name);
+		file << "\"}}";
+
+		// -- Complete events, timestamps in microseconds --
+		const uint64_t writeCount = pRing->writeCount.load(std::memory_order_acquire);
+		const uint64_t firstIdx = writeCount > RING_SIZE ? writeCount - RING_SIZE : 0;
+		for (uint64_t eventIdx{ firstIdx }; eventIdx < writeCount; ++eventIdx)
+		{
+			const Event& event = pRing->vEvents[eventIdx % RING_SIZE];
+			separate();
+			file << "{\"name\":\"";
+			WriteEscaped(file, event.pName);
+			file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << pRing->threadId
+				 << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+				 << ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0 << '}';
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+pompeii::CPUProfiler::ThreadRing& pompeii::CPUProfiler::GetThreadRing()
+{
+	// -- Rings are never freed, a thread that exits leaves its zones behind for the export --
+	thread_local ThreadRing* t_pRing{ nullptr };
+	if (t_pRing)
+		return *t_pRing;
+
+	std::scoped_lock lock{ m_RingsMutex };
+	std::unique_ptr<ThreadRing>& pRing = m_vRings.emplace_back(std::make_unique<ThreadRing>());
+	pRing->threadId = static_cast<uint32_t>(m_vRings.size() - 1);
+	pRing->name = "Thread " + std::to_string(pRing->threadId);
+	t_pRing = pRing.get();
+	return *t_pRing;
+}
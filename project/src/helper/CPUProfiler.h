@@ -0,0 +1,86 @@
+#ifndef CPU_PROFILER_H
+#define CPU_PROFILER_H
+
+// -- Standard Library --
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// -- Pompeii Includes --
+#include "Instrumentation.h"
+
+// CPU zones are only recorded in builds compiled with POMPEII_INSTRUMENTATION, like the labels and counters
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  CPU Scope
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Times the scope it lives in on the calling thread, the name has to outlive the profiler (a string literal)
+	class CPUScope final
+	{
+	public:
+		explicit CPUScope(const char* name);
+		~CPUScope();
+		CPUScope(const CPUScope& other) = delete;
+		CPUScope(CPUScope&& other) noexcept = delete;
+		CPUScope& operator=(const CPUScope& other) = delete;
+		CPUScope& operator=(CPUScope&& other) noexcept = delete;
+
+	private:
+		const char* m_pName;
+		uint64_t m_StartNs;
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  CPU Profiler
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Every thread writes its zones into a ring of its own, recording never takes a lock.
+	// Only the first zone of a thread registers its ring, once the ring is full the oldest zones are overwritten
+	class CPUProfiler final
+	{
+	public:
+		static void Record(const char* name, uint64_t startNs, uint64_t endNs);
+		// Shows up as the thread's name in the trace, copied so it may be formatted on the spot
+		static void SetThreadName(const char* name);
+		static uint64_t GetTimeNs();
+
+		// Chrome trace event JSON, open in chrome://tracing or Perfetto.
+		// Call it while no thread is recording, like between frames, or the oldest zones may be torn
+		static void ExportChromeTrace(const std::filesystem::path& path);
+
+	private:
+		static constexpr uint32_t RING_SIZE{ 16384 };
+		struct Event
+		{
+			const char* pName;
+			uint64_t startNs;
+			uint64_t endNs;
+		};
+		struct ThreadRing
+		{
+			std::array<Event, RING_SIZE> vEvents{};
+			std::atomic<uint64_t> writeCount{};
+			uint32_t threadId{};
+			std::string name{};
+		};
+		static ThreadRing& GetThreadRing();
+
+		inline static std::vector<std::unique_ptr<ThreadRing>>	m_vRings		{ };
+		inline static std::mutex								m_RingsMutex	{ };
+	};
+}
+
+#ifdef POMPEII_INSTRUMENTATION
+	#define POMPEII_CPU_SCOPE(name)		const ::pompeii::CPUScope POMPEII_CONCAT(cpuScope, __LINE__){ name }
+	#define POMPEII_CPU_THREAD(name)	::pompeii::CPUProfiler::SetThreadName(name)
+#else
+	#define POMPEII_CPU_SCOPE(name)		static_cast<void>(0)
+	#define POMPEII_CPU_THREAD(name)	static_cast<void>(0)
+#endif
+
+#endif // CPU_PROFILER_H
@@ -0,0 +1,202 @@
+// -- Standard Library --
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+// -- Pompeii Includes --
+#include "GPUProfiler.h"
+#include "Context.h"
+#include "CommandBuffer.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  GPU Profiler
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+void pompeii::GPUProfiler::Initialize(const Context& context, uint32_t historySize)
+{
+	// -- Timestamps have to be supported on the graphics queue --
+	const uint32_t graphicsFamily = context.physicalDevice.GetQueueFamilies().graphicsFamily.value();
+	uint32_t familyCount{};
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice.GetHandle(), &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> vFamilies(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice.GetHandle(), &familyCount, vFamilies.data());
+
+	const uint32_t validBits = vFamilies[graphicsFamily].timestampValidBits;
+	m_IsSupported = validBits > 0;
+	if (!m_IsSupported)
+		return;
+	m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+	m_TimestampPeriod = context.physicalDevice.GetProperties().limits.timestampPeriod;
+
+	// -- Query Pools, a begin and end timestamp per zone --
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = ZONE_COUNT * 2;
+
+	m_vFrames.resize(context.maxFramesInFlight);
+	for (FrameQueries& frame : m_vFrames)
+	{
+		if (vkCreateQueryPool(context.device.GetHandle(), &poolInfo, nullptr, &frame.pool) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create Timestamp Query Pool!");
+	}
+
+	for (ZoneHistory& history : m_Histories)
+		history.vSamples.resize(std::max(historySize, 1u));
+	m_vSortScratch.reserve(historySize);
+}
+void pompeii::GPUProfiler::Destroy(const Context& context)
+{
+	for (FrameQueries& frame : m_vFrames)
+		vkDestroyQueryPool(context.device.GetHandle(), frame.pool, nullptr);
+	m_vFrames.clear();
+}
+
+
+//--------------------------------------------------
+//    Profiling
+//--------------------------------------------------
+void pompeii::GPUProfiler::BeginFrame(const Context& context, CommandBuffer& commandBuffer)
+{
+	if (!m_IsSupported)
+		return;
+
+	m_CurrentFrame = context.currentFrame;
+	FrameQueries& frame = m_vFrames[m_CurrentFrame];
+	CollectResults(context, frame);
+
+	vkCmdResetQueryPool(commandBuffer.GetHandle(), frame.pool, 0, ZONE_COUNT * 2);
+	frame.vWritten.fill(false);
+}
+void pompeii::GPUProfiler::BeginZone(CommandBuffer& commandBuffer, GPUZone zone)
+{
+	if (!m_IsSupported)
+		return;
+	const uint32_t zoneIdx = static_cast<uint32_t>(zone);
+	vkCmdWriteTimestamp2(commandBuffer.GetHandle(), VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, m_vFrames[m_CurrentFrame].pool, zoneIdx * 2);
+}
+void pompeii::GPUProfiler::EndZone(CommandBuffer& commandBuffer, GPUZone zone)
+{
+	if (!m_IsSupported)
+		return;
+	const uint32_t zoneIdx = static_cast<uint32_t>(zone);
+	vkCmdWriteTimestamp2(commandBuffer.GetHandle(), VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, m_vFrames[m_CurrentFrame].pool, zoneIdx * 2 + 1);
+	m_vFrames[m_CurrentFrame].vWritten[zoneIdx] = true;
+}
+
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+bool pompeii::GPUProfiler::IsSupported() const { return m_IsSupported; }
+pompeii::GPUZoneStats pompeii::GPUProfiler::GetStats(GPUZone zone) const
+{
+	const ZoneHistory& history = m_Histories[static_cast<uint32_t>(zone)];
+	if (history.count == 0)
+		return {};
+
+	// -- Percentiles only need a partial sort, of a copy so the ring keeps its order --
+	m_vSortScratch.assign(history.vSamples.begin(), history.vSamples.begin() + history.count);
+	const auto percentile = [this](float fraction)
+		{
+			const size_t rank = static_cast<size_t>(fraction * static_cast<float>(m_vSortScratch.size() - 1) + 0.5f);
+			std::nth_element(m_vSortScratch.begin(), m_vSortScratch.begin() + rank, m_vSortScratch.end());
+			return m_vSortScratch[rank];
+		};
+
+	GPUZoneStats stats{};
+	stats.sampleCount = history.count;
+	stats.minMs = *std::ranges::min_element(m_vSortScratch);
+	stats.avgMs = std::accumulate(m_vSortScratch.begin(), m_vSortScratch.end(), 0.f) / static_cast<float>(history.count);
+	stats.p95Ms = percentile(0.95f);
+	stats.p99Ms = percentile(0.99f);
+	return stats;
+}
+const char* pompeii::GPUProfiler::GetName(GPUZone zone)
+{
+	static constexpr std::array<const char*, ZONE_COUNT> names
+	{
+		"Culling",
+		"Shadow Pass",
+		"Depth Pre-Pass",
+		"Geometry Pass",
+		"Lighting Pass",
+		"Blit Compute",
+		"Blit Graphics"
+	};
+	return names[static_cast<uint32_t>(zone)];
+}
+
+void pompeii::GPUProfiler::DumpCSV(const std::filesystem::path& path) const
+{
+	std::ofstream file{ path };
+	if (!file.is_open())
+		throw std::runtime_error("Failed to open GPU Profile CSV file: " + path.string());
+
+	file << "zone,min_ms,avg_ms,p95_ms,p99_ms,samples\n";
+	for (uint32_t zoneIdx{}; zoneIdx < ZONE_COUNT; ++zoneIdx)
+	{
+		const GPUZone zone = static_cast<GPUZone>(zoneIdx);
+		const GPUZoneStats stats = GetStats(zone);
+		file << GetName(zone) << ',' << stats.minMs << ',' << stats.avgMs << ','
+			 << stats.p95Ms << ',' << stats.p99Ms << ',' << stats.sampleCount << '\n';
+	}
+}
+void pompeii::GPUProfiler::DumpJSON(const std::filesystem::path& path) const
+{
+	std::ofstream file{ path };
+	if (!file.is_open())
+		throw std::runtime_error("Failed to open GPU Profile JSON file: " + path.string());
+
+	file << "{\n\t\"zones\": [\n";
+	for (uint32_t zoneIdx{}; zoneIdx < ZONE_COUNT; ++zoneIdx)
+	{
+		const GPUZone zone = static_cast<GPUZone>(zoneIdx);
+		const GPUZoneStats stats = GetStats(zone);
+		file << "\t\t{ \"name\": \"" << GetName(zone)
+			 << "\", \"minMs\": " << stats.minMs
+			 << ", \"avgMs\": " << stats.avgMs
+			 << ", \"p95Ms\": " << stats.p95Ms
+			 << ", \"p99Ms\": " << stats.p99Ms
+			 << ", \"samples\": " << stats.sampleCount
+			 << (zoneIdx + 1 < ZONE_COUNT ? " },\n" : " }\n");
+	}
+	file << "\t]\n}\n";
+}
+
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::GPUProfiler::CollectResults(const Context& context, FrameQueries& frame)
+{
+	// -- This slot's fence was waited on, its queries are available and reading them never blocks --
+	bool anyWritten{};
+	for (bool written : frame.vWritten)
+		anyWritten |= written;
+	if (!anyWritten)
+		return;
+
+	const VkResult result = vkGetQueryPoolResults(context.device.GetHandle(), frame.pool, 0, ZONE_COUNT * 2,
+		sizeof(m_Timestamps), m_Timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS)
+		return;
+
+	const double msPerTick = static_cast<double>(m_TimestampPeriod) / 1'000'000.0;
+	for (uint32_t zoneIdx{}; zoneIdx < ZONE_COUNT; ++zoneIdx)
+	{
+		if (!frame.vWritten[zoneIdx])
+			continue;
+
+		const uint64_t ticks = (m_Timestamps[zoneIdx * 2 + 1] - m_Timestamps[zoneIdx * 2]) & m_TimestampMask;
+		ZoneHistory& history = m_Histories[zoneIdx];
+		history.vSamples[history.next] = static_cast<float>(static_cast<double>(ticks) * msPerTick);
+		history.next = (history.next + 1) % static_cast<uint32_t>(history.vSamples.size());
+		history.count = std::min(history.count + 1, static_cast<uint32_t>(history.vSamples.size()));
+	}
+}
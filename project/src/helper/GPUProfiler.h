@@ -0,0 +1,114 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+// -- Vulkan Includes --
+#include <vulkan/vulkan.h>
+
+// -- Standard Library --
+#include <array>
+#include <filesystem>
+#include <vector>
+
+// -- Forward Declarations --
+namespace pompeii
+{
+	struct Context;
+	class CommandBuffer;
+}
+
+namespace pompeii
+{
+	// -- Timed stretches of a frame, the names GPUProfiler::GetName returns follow the same order --
+	enum class GPUZone : uint8_t
+	{
+		Culling,
+		Shadow,
+		DepthPrePass,
+		Geometry,
+		Lighting,
+		BlitCompute,
+		BlitGraphics,
+		Count
+	};
+	struct GPUZoneStats
+	{
+		float minMs{};
+		float avgMs{};
+		float p95Ms{};
+		float p99Ms{};
+		uint32_t sampleCount{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  GPU Profiler
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Timestamps around every zone, one query pool per frame in flight.
+	// A slot is read back once its fence is signaled, so the GPU is never waited on and results trail maxFramesInFlight frames behind
+	class GPUProfiler final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit GPUProfiler() = default;
+		~GPUProfiler() = default;
+		GPUProfiler(const GPUProfiler& other) = delete;
+		GPUProfiler(GPUProfiler&& other) noexcept = delete;
+		GPUProfiler& operator=(const GPUProfiler& other) = delete;
+		GPUProfiler& operator=(GPUProfiler&& other) noexcept = delete;
+
+		// Statistics cover the last historySize frames every zone was recorded in
+		void Initialize(const Context& context, uint32_t historySize = 240);
+		void Destroy(const Context& context);
+
+		//--------------------------------------------------
+		//    Profiling
+		//--------------------------------------------------
+		// Collects what this frame slot measured last time and resets its queries, after its fence and before any zone
+		void BeginFrame(const Context& context, CommandBuffer& commandBuffer);
+		// Has to be recorded into the primary buffer, outside any rendering scope
+		void BeginZone(CommandBuffer& commandBuffer, GPUZone zone);
+		void EndZone(CommandBuffer& commandBuffer, GPUZone zone);
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		bool IsSupported() const;
+		GPUZoneStats GetStats(GPUZone zone) const;
+		static const char* GetName(GPUZone zone);
+
+		// One row per zone with its name, min, avg, p95, p99 in milliseconds and the sample count
+		void DumpCSV(const std::filesystem::path& path) const;
+		void DumpJSON(const std::filesystem::path& path) const;
+
+	private:
+		static constexpr uint32_t ZONE_COUNT{ static_cast<uint32_t>(GPUZone::Count) };
+		struct FrameQueries
+		{
+			VkQueryPool pool{ VK_NULL_HANDLE };
+			std::array<bool, ZONE_COUNT> vWritten{};
+		};
+		// Rolling window of one zone's durations
+		struct ZoneHistory
+		{
+			std::vector<float> vSamples{};
+			uint32_t next{};
+			uint32_t count{};
+		};
+		void CollectResults(const Context& context, FrameQueries& frame);
+
+		// -- Queries --
+		std::vector<FrameQueries>				m_vFrames				{ };
+		std::array<uint64_t, ZONE_COUNT * 2>	m_Timestamps			{ };
+		uint32_t								m_CurrentFrame			{ };
+		float									m_TimestampPeriod		{ };
+		uint64_t								m_TimestampMask			{ };
+		bool									m_IsSupported			{ };
+
+		// -- Statistics --
+		std::array<ZoneHistory, ZONE_COUNT>		m_Histories				{ };
+		mutable std::vector<float>				m_vSortScratch			{ };
+	};
+}
+
+#endif // GPU_PROFILER_H
@@ -0,0 +1,61 @@
+// -- Standard Library --
+#include <cstdarg>
+#include <cstdio>
+
+// -- Pompeii Includes --
+#include "Instrumentation.h"
+#include "RenderDebugger.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Instrument Label
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::InstrumentLabel::InstrumentLabel(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	std::vsnprintf(m_Text, MAX_LENGTH, format, args);
+	va_end(args);
+}
+pompeii::InstrumentLabel::operator const char*() const { return m_Text; }
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Scoped Marker
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+pompeii::ScopedMarker::ScopedMarker(CommandBuffer& commandBuffer, const char* name, const glm::vec4& color)
+	: m_CommandBuffer(commandBuffer)
+{
+	RenderDebugger::BeginDebugLabel(m_CommandBuffer, name, color);
+}
+pompeii::ScopedMarker::~ScopedMarker()
+{
+	RenderDebugger::EndDebugLabel(m_CommandBuffer);
+}
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  Instrumentation
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void pompeii::Instrumentation::Add(Counter counter, uint64_t value)
+{
+	m_Counters[static_cast<uint32_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+void pompeii::Instrumentation::EndFrame()
+{
+	for (uint32_t counterIdx{}; counterIdx < COUNTER_COUNT; ++counterIdx)
+		m_LastFrameCounters[counterIdx] = m_Counters[counterIdx].exchange(0, std::memory_order_relaxed);
+}
+
+uint64_t pompeii::Instrumentation::GetLastFrame(Counter counter) { return m_LastFrameCounters[static_cast<uint32_t>(counter)]; }
+const char* pompeii::Instrumentation::GetName(Counter counter)
+{
+	static constexpr std::array<const char*, COUNTER_COUNT> names
+	{
+		"Draw Calls",
+		"Dispatches",
+		"Secondaries Recorded",
+		"Secondaries Reused"
+	};
+	return names[static_cast<uint32_t>(counter)];
+}
@@ -0,0 +1,103 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// -- Standard Library --
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// -- Math Includes --
+#include "glm/vec4.hpp"
+
+// -- Pompeii Includes --
+#include "RenderDebugger.h"
+
+// Debug label scopes, labels and counters only exist in builds compiled with POMPEII_INSTRUMENTATION.
+// Without it every POMPEII_ macro below expands to nothing and its arguments are never evaluated
+namespace pompeii
+{
+	// -- Counted events, the names Instrumentation::GetName returns follow the same order --
+	enum class Counter : uint8_t
+	{
+		DrawCalls,
+		Dispatches,
+		SecondariesRecorded,
+		SecondariesReused,
+		Count
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Instrument Label
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// printf-style label formatted into a fixed buffer, names longer than it are cut off
+	class InstrumentLabel final
+	{
+	public:
+		explicit InstrumentLabel(const char* format, ...);
+		operator const char*() const;
+
+	private:
+		static constexpr uint32_t MAX_LENGTH{ 64 };
+		char m_Text[MAX_LENGTH]{};
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Scoped Marker
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Opens a debug label on construction and closes it when it leaves scope
+	class ScopedMarker final
+	{
+	public:
+		explicit ScopedMarker(CommandBuffer& commandBuffer, const char* name, const glm::vec4& color);
+		~ScopedMarker();
+		ScopedMarker(const ScopedMarker& other) = delete;
+		ScopedMarker(ScopedMarker&& other) noexcept = delete;
+		ScopedMarker& operator=(const ScopedMarker& other) = delete;
+		ScopedMarker& operator=(ScopedMarker&& other) noexcept = delete;
+
+	private:
+		CommandBuffer& m_CommandBuffer;
+	};
+
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  Instrumentation
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// Lock-free counters, safe to add to from any recording thread
+	class Instrumentation final
+	{
+	public:
+		static void Add(Counter counter, uint64_t value);
+		// Moves this frame's counts to the last frame ones and starts counting from zero
+		static void EndFrame();
+
+		static uint64_t GetLastFrame(Counter counter);
+		static const char* GetName(Counter counter);
+
+	private:
+		static constexpr uint32_t COUNTER_COUNT{ static_cast<uint32_t>(Counter::Count) };
+
+		inline static std::array<std::atomic<uint64_t>, COUNTER_COUNT>	m_Counters			{ };
+		inline static std::array<uint64_t, COUNTER_COUNT>				m_LastFrameCounters	{ };
+	};
+}
+
+#ifdef POMPEII_INSTRUMENTATION
+	#define POMPEII_CONCAT_IMPL(a, b) a##b
+	#define POMPEII_CONCAT(a, b) POMPEII_CONCAT_IMPL(a, b)
+
+	#define POMPEII_GPU_SCOPE(commandBuffer, name, color)	const ::pompeii::ScopedMarker POMPEII_CONCAT(scopedMarker, __LINE__){ commandBuffer, name, color }
+	#define POMPEII_GPU_BEGIN(commandBuffer, name, color)	::pompeii::RenderDebugger::BeginDebugLabel(commandBuffer, name, color)
+	#define POMPEII_GPU_LABEL(commandBuffer, name, color)	::pompeii::RenderDebugger::InsertDebugLabel(commandBuffer, name, color)
+	#define POMPEII_GPU_END(commandBuffer)					::pompeii::RenderDebugger::EndDebugLabel(commandBuffer)
+	#define POMPEII_COUNT(counter, value)					::pompeii::Instrumentation::Add(counter, value)
+	#define POMPEII_COUNTERS_END_FRAME()					::pompeii::Instrumentation::EndFrame()
+#else
+	#define POMPEII_GPU_SCOPE(commandBuffer, name, color)	static_cast<void>(0)
+	#define POMPEII_GPU_BEGIN(commandBuffer, name, color)	static_cast<void>(0)
+	#define POMPEII_GPU_LABEL(commandBuffer, name, color)	static_cast<void>(0)
+	#define POMPEII_GPU_END(commandBuffer)					static_cast<void>(0)
+	#define POMPEII_COUNT(counter, value)					static_cast<void>(0)
+	#define POMPEII_COUNTERS_END_FRAME()					static_cast<void>(0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -45,14 +45,14 @@ void pompeii::RenderDebugger::SetDebugObjectName(uint64_t objectHandle, VkObject
 
 	m_DeviceDebugUtils.setDebugUtilsObjectNameEXT(m_DeviceDebugUtils.device, &nameInfo);
 }
-void pompeii::RenderDebugger::BeginDebugLabel(CommandBuffer& cmdBuffer, const std::string& name, const glm::vec4& color)
+void pompeii::RenderDebugger::BeginDebugLabel(CommandBuffer& cmdBuffer, const char* name, const glm::vec4& color)
 {
 	if (!m_IsEnabled)
 		return;
 
 	VkDebugUtilsLabelEXT labelInfo{};
 	labelInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
-	labelInfo.pLabelName = name.c_str();
+	labelInfo.pLabelName = name;
 	labelInfo.color[0] = color.x;
 	labelInfo.color[1] = color.y;
 	labelInfo.color[2] = color.z;
@@ -60,14 +60,14 @@ void pompeii::RenderDebugger::BeginDebugLabel(CommandBuffer& cmdBuffer, const st
 
 	m_DeviceDebugUtils.cmdBeginDebugUtilsLabelEXT(cmdBuffer.GetHandle(), &labelInfo);
 }
-void pompeii::RenderDebugger::InsertDebugLabel(CommandBuffer& cmdBuffer, const std::string& name, const glm::vec4& color)
+void pompeii::RenderDebugger::InsertDebugLabel(CommandBuffer& cmdBuffer, const char* name, const glm::vec4& color)
 {
 	if (!m_IsEnabled)
 		return;
 
 	VkDebugUtilsLabelEXT labelInfo{};
 	labelInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
-	labelInfo.pLabelName = name.c_str();
+	labelInfo.pLabelName = name;
 	labelInfo.color[0] = color.x;
 	labelInfo.color[1] = color.y;
 	labelInfo.color[2] = color.z;
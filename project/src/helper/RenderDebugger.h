@@ -51,8 +51,8 @@ namespace pompeii
 		static void Destroy();
 
 		static void SetDebugObjectName(uint64_t objectHandle, VkObjectType objectType, const std::string& name);
-		static void BeginDebugLabel(CommandBuffer & cmdBuffer, const std::string& name, const glm::vec4& color);
-		static void InsertDebugLabel(CommandBuffer& cmdBuffer, const std::string& name, const glm::vec4& color);
+		static void BeginDebugLabel(CommandBuffer& cmdBuffer, const char* name, const glm::vec4& color);
+		static void InsertDebugLabel(CommandBuffer& cmdBuffer, const char* name, const glm::vec4& color);
 		static void EndDebugLabel(CommandBuffer& cmdBuffer);
 
 		//--------------------------------------------------
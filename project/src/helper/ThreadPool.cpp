@@ -0,0 +1,123 @@
+// -- Standard Library --
+#include <algorithm>
+#include <chrono>
+
+// -- Pompeii Includes --
+#include "ThreadPool.h"
+#include "CPUProfiler.h"
+
+
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//? ~~	  ThreadPool
+//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace
+{
+	// -- Set once by every worker, so tasks can tell which worker runs them --
+	thread_local const pompeii::ThreadPool* t_pOwnerPool{ nullptr };
+	thread_local uint32_t t_WorkerIdx{};
+}
+
+//--------------------------------------------------
+//    Constructor & Destructor
+//--------------------------------------------------
+pompeii::ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	// -- Default to one worker per hardware thread, leaving one for the caller --
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	m_vWorkers.reserve(threadCount);
+	for (uint32_t index{}; index < threadCount; ++index)
+		m_vWorkers.emplace_back([this, index]
+			{
+				t_pOwnerPool = this;
+				t_WorkerIdx = index;
+				POMPEII_CPU_THREAD(InstrumentLabel("Worker %u", index));
+				WorkerLoop();
+			});
+}
+pompeii::ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock{ m_Mutex };
+		m_Stop = true;
+	}
+	m_Condition.notify_all();
+
+	for (std::thread& worker : m_vWorkers)
+		worker.join();
+}
+
+//--------------------------------------------------
+//    Tasks
+//--------------------------------------------------
+std::future<void> pompeii::ThreadPool::Enqueue(std::function<void()> task)
+{
+	std::packaged_task<void()> packagedTask{ std::move(task) };
+	std::future<void> future = packagedTask.get_future();
+	{
+		std::scoped_lock lock{ m_Mutex };
+		m_Tasks.push(std::move(packagedTask));
+	}
+	m_Condition.notify_one();
+	return future;
+}
+void pompeii::ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func)
+{
+	std::vector<std::future<void>> vFutures{};
+	vFutures.reserve(count);
+	for (uint32_t index{}; index < count; ++index)
+		vFutures.push_back(Enqueue([&func, index] { func(index); }));
+
+	// -- Wait for all tasks before rethrowing, func must outlive every task --
+	// Helping with the queue keeps a worker that calls this from waiting on tasks queued behind itself
+	for (std::future<void>& future : vFutures)
+	{
+		while (future.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+		{
+			if (!RunPendingTask())
+				future.wait();
+		}
+	}
+	for (std::future<void>& future : vFutures)
+		future.get();
+}
+
+//--------------------------------------------------
+//    Accessors & Mutators
+//--------------------------------------------------
+uint32_t pompeii::ThreadPool::GetThreadCount() const { return static_cast<uint32_t>(m_vWorkers.size()); }
+uint32_t pompeii::ThreadPool::GetWorkerIndex() const { return t_pOwnerPool == this ? t_WorkerIdx : GetThreadCount(); }
+
+//--------------------------------------------------
+//    Helpers
+//--------------------------------------------------
+void pompeii::ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::packaged_task<void()> task{};
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_Condition.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+			if (m_Stop && m_Tasks.empty())
+				return;
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop();
+		}
+		task();
+	}
+}
+bool pompeii::ThreadPool::RunPendingTask()
+{
+	std::packaged_task<void()> task{};
+	{
+		std::scoped_lock lock{ m_Mutex };
+		if (m_Tasks.empty())
+			return false;
+		task = std::move(m_Tasks.front());
+		m_Tasks.pop();
+	}
+	task();
+	return true;
+}
@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// -- Standard Library --
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace pompeii
+{
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//? ~~	  ThreadPool
+	//? ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	class ThreadPool final
+	{
+	public:
+		//--------------------------------------------------
+		//    Constructor & Destructor
+		//--------------------------------------------------
+		explicit ThreadPool(uint32_t threadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool(ThreadPool&& other) noexcept = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+		ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+
+		//--------------------------------------------------
+		//    Tasks
+		//--------------------------------------------------
+		std::future<void> Enqueue(std::function<void()> task);
+		// Runs queued tasks while it waits, so it is safe to call from inside a task of this pool
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func);
+
+		//--------------------------------------------------
+		//    Accessors & Mutators
+		//--------------------------------------------------
+		uint32_t GetThreadCount() const;
+		// Index of the calling worker, GetThreadCount() for any thread outside this pool
+		uint32_t GetWorkerIndex() const;
+
+	private:
+		void WorkerLoop();
+		// Pops and runs one queued task, false when the queue was empty
+		bool RunPendingTask();
+
+		std::vector<std::thread> m_vWorkers{};
+		std::queue<std::packaged_task<void()>> m_Tasks{};
+		std::mutex m_Mutex{};
+		std::condition_variable m_Condition{};
+		bool m_Stop{ false };
+	};
+}
+
+#endif // THREAD_POOL_H